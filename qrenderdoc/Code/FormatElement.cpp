@@ -828,6 +828,223 @@ uint32_t FormatElement::byteSize() const
   return vecSize * matrixdim;
 }
 
+template <typename T>
+static void DecodeCast(const byte *data, int count, float *out)
+{
+  const T *src = (const T *)data;
+  for(int i = 0; i < count; i++)
+    out[i] = (float)src[i];
+}
+
+static void DecodeHalf(const byte *data, int count, float *out)
+{
+  const uint16_t *src = (const uint16_t *)data;
+  for(int i = 0; i < count; i++)
+    out[i] = Maths_HalfToFloat(src[i]);
+}
+
+template <typename T>
+static void DecodeUNorm(const byte *data, int count, float *out)
+{
+  const T *src = (const T *)data;
+  const float scale = 1.0f / (float)T(~T(0));
+  for(int i = 0; i < count; i++)
+    out[i] = (float)src[i] * scale;
+}
+
+template <typename T>
+static void DecodeSNorm(const byte *data, int count, float *out)
+{
+  // T is the signed type, the most negative value maps to -1 as well as the next one up
+  const T *src = (const T *)data;
+  const T maxVal = T((~0ULL) >> (65 - sizeof(T) * 8));
+  for(int i = 0; i < count; i++)
+    out[i] = src[i] < -maxVal ? -1.0f : (float)src[i] / (float)maxVal;
+}
+
+static void DecodeDepth24(const byte *data, int count, float *out)
+{
+  // 24-bit depth is read as 32-bits and masked against the stencil bits
+  const uint32_t *src = (const uint32_t *)data;
+  for(int i = 0; i < count; i++)
+    out[i] = (float)(src[i] & 0x00ffffff) / (float)0x00ffffff;
+}
+
+static void DecodeInvalid(const byte *data, int count, float *out)
+{
+  for(int i = 0; i < count; i++)
+    out[i] = qQNaN();
+}
+
+FormatElementDecoder::FormatElementDecoder(const FormatElement &el) : m_El(el)
+{
+  const ResourceFormat &f = el.format;
+
+  m_Func = NULL;
+  m_Swizzle = false;
+  m_ReadSize = el.byteSize();
+
+  // packed formats are rare enough that they go through GetVariants(), these are the ones it
+  // decodes specially
+  if(f.special)
+  {
+    if(f.specialFormat == SpecialFormat::R5G5B5A1 || f.specialFormat == SpecialFormat::R4G4B4A4)
+    {
+      m_CompCount = 4;
+      return;
+    }
+    else if(f.specialFormat == SpecialFormat::R5G6B5 ||
+            f.specialFormat == SpecialFormat::R11G11B10)
+    {
+      m_CompCount = 3;
+      return;
+    }
+    else if(f.specialFormat == SpecialFormat::R10G10B10A2)
+    {
+      m_CompCount = int(f.compCount / 4) * 4;
+      return;
+    }
+  }
+
+  m_CompCount = int(qMax(el.matrixdim, 1U) * f.compCount);
+  m_Swizzle = f.bgraOrder && m_CompCount >= 3;
+
+  // this matches the per-component decoding in GetVariants()
+  uint32_t readWidth = f.compByteWidth;
+
+  switch(f.compType)
+  {
+    case CompType::Float:
+      if(f.compByteWidth == 8)
+        m_Func = &DecodeCast<double>;
+      else if(f.compByteWidth == 4)
+        m_Func = &DecodeCast<float>;
+      else if(f.compByteWidth == 2)
+        m_Func = &DecodeHalf;
+      break;
+    case CompType::SInt:
+    case CompType::SScaled:
+      if(f.compByteWidth == 4)
+        m_Func = &DecodeCast<int32_t>;
+      else if(f.compByteWidth == 2)
+        m_Func = &DecodeCast<int16_t>;
+      else if(f.compByteWidth == 1)
+        m_Func = &DecodeCast<int8_t>;
+      break;
+    case CompType::UInt:
+    case CompType::UScaled:
+      if(f.compByteWidth == 4)
+        m_Func = &DecodeCast<uint32_t>;
+      else if(f.compByteWidth == 2)
+        m_Func = &DecodeCast<uint16_t>;
+      else if(f.compByteWidth == 1)
+        m_Func = &DecodeCast<uint8_t>;
+      break;
+    case CompType::Depth:
+      if(f.compByteWidth == 4)
+      {
+        m_Func = &DecodeCast<float>;
+      }
+      else if(f.compByteWidth == 3)
+      {
+        m_Func = &DecodeDepth24;
+        readWidth = 4;
+      }
+      else if(f.compByteWidth == 2)
+      {
+        m_Func = &DecodeUNorm<uint16_t>;
+      }
+      break;
+    case CompType::Double: m_Func = &DecodeCast<double>; break;
+    default:
+      if(f.compByteWidth == 4)
+        m_Func = &DecodeUNorm<uint32_t>;
+      else if(f.compType == CompType::UNorm && f.compByteWidth == 2)
+        m_Func = &DecodeUNorm<uint16_t>;
+      else if(f.compType == CompType::UNorm && f.compByteWidth == 1)
+        m_Func = &DecodeUNorm<uint8_t>;
+      else if(f.compType == CompType::SNorm && f.compByteWidth == 2)
+        m_Func = &DecodeSNorm<int16_t>;
+      else if(f.compType == CompType::SNorm && f.compByteWidth == 1)
+        m_Func = &DecodeSNorm<int8_t>;
+      break;
+  }
+
+  if(f.compType == CompType::Double)
+    readWidth = 8;
+
+  if(m_Func == NULL)
+  {
+    // no float representation, but still report the components so columns line up
+    m_Func = &DecodeInvalid;
+    readWidth = 0;
+  }
+
+  m_ReadSize = readWidth * m_CompCount;
+}
+
+bool FormatElementDecoder::decode(const byte *data, const byte *end, float *out) const
+{
+  if(data + m_ReadSize > end)
+    return false;
+
+  if(m_Func == NULL)
+  {
+    QVariantList list = m_El.GetVariants(data, end);
+
+    if(list.isEmpty())
+      return false;
+
+    for(int i = 0; i < m_CompCount; i++)
+    {
+      if(i >= list.count())
+      {
+        out[i] = qQNaN();
+        continue;
+      }
+
+      const QVariant &v = list[i];
+
+      QMetaType::Type vt = (QMetaType::Type)v.type();
+
+      if(vt == QMetaType::Double)
+        out[i] = (float)v.toDouble();
+      else if(vt == QMetaType::Float)
+        out[i] = v.toFloat();
+      else if(vt == QMetaType::UInt || vt == QMetaType::UShort || vt == QMetaType::UChar)
+        out[i] = (float)v.toUInt();
+      else if(vt == QMetaType::Int || vt == QMetaType::Short || vt == QMetaType::SChar)
+        out[i] = (float)v.toInt();
+      else
+        out[i] = qQNaN();
+    }
+
+    return true;
+  }
+
+  m_Func(data, m_CompCount, out);
+
+  if(m_Swizzle)
+    qSwap(out[0], out[2]);
+
+  return true;
+}
+
+uint32_t FormatElementDecoder::decodeRows(const byte *data, const byte *end, size_t stride,
+                                          uint32_t count, float *out) const
+{
+  for(uint32_t i = 0; i < count; i++)
+  {
+    if(!decode(data, end, out))
+      return i;
+
+    data += stride;
+    out += m_CompCount;
+  }
+
+  return count;
+}
+
 QString TypeString(const ShaderVariable &v)
 {
   if(v.members.count > 0 || v.isStruct)
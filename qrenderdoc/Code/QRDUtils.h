@@ -642,6 +642,34 @@ public:
   bool hex, rgb;
 };
 
+// Decodes a FormatElement straight to floats, for processing many rows at once. The format is
+// looked at once on construction to pick a typed decode function, instead of switching on the
+// format and going through a QVariant for every component like GetVariants() does.
+class FormatElementDecoder
+{
+public:
+  FormatElementDecoder(const FormatElement &el);
+
+  // the number of floats written per element. Components that can't be represented as a float
+  // are written as NaN
+  int componentCount() const { return m_CompCount; }
+  // decodes one element into out, returns false if it would read past end
+  bool decode(const byte *data, const byte *end, float *out) const;
+  // decodes count consecutive elements, stride bytes apart, into out with componentCount()
+  // floats per element. Returns how many were decoded before reaching end.
+  uint32_t decodeRows(const byte *data, const byte *end, size_t stride, uint32_t count,
+                      float *out) const;
+
+private:
+  typedef void (*DecodeFunc)(const byte *data, int count, float *out);
+
+  FormatElement m_El;
+  DecodeFunc m_Func;
+  int m_CompCount;
+  uint32_t m_ReadSize;
+  bool m_Swizzle;
+};
+
 QString TypeString(const ShaderVariable &v);
 QString RowString(const ShaderVariable &v, uint32_t row, VarType type = VarType::Unknown);
 QString VarString(const ShaderVariable &v);
@@ -305,6 +305,58 @@ struct TypeConversion<rdctype::pair<A, B>, false>
   }
 };
 
+// python object that takes ownership of a byte array allocated by the replay API and exposes it
+// through the buffer protocol. Large readbacks are handed to python as a memoryview over one of
+// these, instead of being copied into a bytes object.
+struct ByteArrayOwner
+{
+  PyObject_HEAD;
+  byte *data;
+  Py_ssize_t size;
+};
+
+inline void ByteArrayOwner_dealloc(PyObject *self)
+{
+  ByteArrayOwner *owner = (ByteArrayOwner *)self;
+
+  if(owner->data)
+    rdctype::array<byte>::deallocate(owner->data);
+
+  Py_TYPE(self)->tp_free(self);
+}
+
+inline int ByteArrayOwner_getbuffer(PyObject *self, Py_buffer *view, int flags)
+{
+  ByteArrayOwner *owner = (ByteArrayOwner *)self;
+
+  // the data is read-only, PyBuffer_FillInfo will fail if a writable buffer is requested
+  return PyBuffer_FillInfo(view, self, owner->data, owner->size, 1, flags);
+}
+
+inline PyTypeObject *GetByteArrayOwnerType()
+{
+  static PyBufferProcs buffer_procs = {&ByteArrayOwner_getbuffer, NULL};
+  static PyTypeObject type = {PyVarObject_HEAD_INIT(NULL, 0)};
+  static bool ready = false;
+
+  if(ready)
+    return &type;
+
+  type.tp_name = "renderdoc.ByteArrayOwner";
+  type.tp_basicsize = sizeof(ByteArrayOwner);
+  type.tp_flags = Py_TPFLAGS_DEFAULT;
+  type.tp_doc = "Owns the bytes returned from the replay API, accessed through a memoryview.";
+  type.tp_dealloc = &ByteArrayOwner_dealloc;
+  type.tp_as_buffer = &buffer_procs;
+
+  if(PyType_Ready(&type) < 0)
+    return NULL;
+
+  ready = true;
+
+  return &type;
+}
+
 // specialisation for array<byte>
 template <>
 struct TypeConversion<rdctype::array<byte>, false>
@@ -345,6 +397,32 @@ struct TypeConversion<rdctype::array<byte>, false>
   {
     return ConvertToPy(self, in, NULL);
   }
+
+  // used for arrays returned by value, where nothing else refers to the data. The allocation is
+  // moved into a ByteArrayOwner and returned as a read-only memoryview, leaving in empty.
+  static PyObject *ConvertToPyOwned(PyObject *self, rdctype::array<byte> &in)
+  {
+    PyTypeObject *type = GetByteArrayOwnerType();
+    if(!type)
+      return NULL;
+
+    ByteArrayOwner *owner = PyObject_New(ByteArrayOwner, type);
+    if(!owner)
+      return NULL;
+
+    owner->data = in.elems;
+    owner->size = (Py_ssize_t)in.count;
+
+    in.elems = NULL;
+    in.count = 0;
+
+    // the memoryview holds a reference to the owner for as long as it or any slice of it is alive
+    PyObject *ret = PyMemoryView_FromObject((PyObject *)owner);
+
+    Py_DECREF(owner);
+
+    return ret;
+  }
 };
 
 // specialisation for array
@@ -387,7 +465,9 @@ struct TypeConversion<rdctype::array<U>, false>
 
       if(elem)
       {
+        // the list takes its own reference
         PyList_Append(list, elem);
+        Py_DECREF(elem);
       }
       else
       {
@@ -403,17 +483,30 @@ struct TypeConversion<rdctype::array<U>, false>
 
   static PyObject *ConvertToPy(PyObject *self, const rdctype::array<U> &in, int *failIdx)
   {
-    PyObject *list = PyList_New(0);
+    // allocate the list at its final size up front and fill it directly, rather than growing it
+    PyObject *list = PyList_New(in.count);
     if(!list)
       return NULL;
 
-    PyObject *ret = ConvertToPyInPlace(self, list, in, failIdx);
+    for(int i = 0; i < in.count; i++)
+    {
+      PyObject *elem = TypeConversion<U>::ConvertToPy(self, in.elems[i]);
 
-    // if a failure happened, don't leak the list we created
-    if(!ret)
-      Py_XDECREF(list);
+      if(!elem)
+      {
+        if(failIdx)
+          *failIdx = i;
 
-    return ret;
+        // if a failure happened, don't leak the list we created
+        Py_DECREF(list);
+        return NULL;
+      }
+
+      // steals the reference to elem
+      PyList_SET_ITEM(list, i, elem);
+    }
+
+    return list;
   }
 
   static PyObject *ConvertToPy(PyObject *self, const rdctype::array<U> &in)
@@ -594,7 +687,9 @@ struct ContainerConversion
 
       if(elem)
       {
+        // the list takes its own reference
         PyList_Append(list, elem);
+        Py_DECREF(elem);
       }
       else
       {
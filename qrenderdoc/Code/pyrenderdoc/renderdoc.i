@@ -51,6 +51,14 @@ SIMPLE_TYPEMAPS(rdctype::str)
 
 CONTAINER_TYPEMAPS(rdctype::array)
 
+// byte arrays returned by value aren't referenced by anything else, so their memory is handed over
+// to python and exposed as a memoryview instead of being copied into a bytes object.
+%typemap(out, fragment="pyconvert") rdctype::array<byte> {
+  $result = TypeConversion<rdctype::array<byte>>::ConvertToPyOwned(self, $1);
+  if(!$result)
+    SWIG_fail;
+}
+
 %typemap(in, fragment="pyconvert") std::function {
   PyObject *func = $input;
   failed$argnum = false;
@@ -1750,25 +1750,89 @@ void BufferViewer::calcBoundingData(CalcBoundingBoxData &bbox)
 
     CacheDataForIteration(cache, s.elements, s.buffers, bbox.inst);
 
-    // possible optimisation here if this shows up as a hot spot - sort and unique the indices and
-    // iterate in ascending order, to be more cache friendly
+    // decode each element straight to floats, the format is only looked at once here
+    QList<FormatElementDecoder> decoders;
+    decoders.reserve(s.elements.count());
 
-    for(uint32_t row = 0; row < s.count; row++)
+    for(int col = 0; col < s.elements.count(); col++)
+      decoders.push_back(FormatElementDecoder(s.elements[col]));
+
+    // big enough for a 4x4 matrix element
+    float vals[16];
+
+    if(!s.indices || !s.indices->data)
     {
-      uint32_t idx = row;
+      // without indices the rows are contiguous, so decode each column in blocks of rows
+      const uint32_t blockRows = 4096;
+      QVector<float> block;
 
-      if(s.indices && s.indices->data)
+      for(int col = 0; col < s.elements.count(); col++)
       {
-        idx = CalcIndex(s.indices, row, bbox.baseVertex);
+        const CachedElData &d = cache[col];
+        const FormatElementDecoder &dec = decoders[col];
 
-        if(idx == ~0U)
+        if(!d.data)
           continue;
+
+        float *minOut = (float *)&minOutputList[col];
+        float *maxOut = (float *)&maxOutputList[col];
+
+        // only the first 4 components fit in the bounds
+        const int comps = qMin(dec.componentCount(), 4);
+        const int rowComps = dec.componentCount();
+
+        // per-instance data is the same for every row
+        const uint32_t count = d.el->perinstance ? qMin(s.count, 1U) : s.count;
+
+        block.resize(blockRows * rowComps);
+
+        for(uint32_t row = 0; row < count; row += blockRows)
+        {
+          const byte *bytes = d.data;
+
+          if(!d.el->perinstance)
+            bytes += d.stride * row;
+
+          uint32_t decoded = dec.decodeRows(bytes, d.end, d.stride, qMin(blockRows, count - row),
+                                            block.data());
+
+          const float *v = block.data();
+
+          for(uint32_t i = 0; i < decoded; i++, v += rowComps)
+          {
+            for(int comp = 0; comp < comps; comp++)
+            {
+              if(qIsFinite(v[comp]))
+              {
+                minOut[comp] = qMin(minOut[comp], v[comp]);
+                maxOut[comp] = qMax(maxOut[comp], v[comp]);
+              }
+            }
+          }
+
+          // ran off the end of the buffer
+          if(decoded < qMin(blockRows, count - row))
+            break;
+        }
       }
 
+      continue;
+    }
+
+    // possible optimisation here if this shows up as a hot spot - sort and unique the indices and
+    // iterate in ascending order, to be more cache friendly
+
+    for(uint32_t row = 0; row < s.count; row++)
+    {
+      uint32_t idx = CalcIndex(s.indices, row, bbox.baseVertex);
+
+      if(idx == ~0U)
+        continue;
+
       for(int col = 0; col < s.elements.count(); col++)
       {
         const CachedElData &d = cache[col];
-        const FormatElement *el = d.el;
+        const FormatElementDecoder &dec = decoders[col];
 
         float *minOut = (float *)&minOutputList[col];
         float *maxOut = (float *)&maxOutputList[col];
@@ -1777,34 +1841,20 @@ void BufferViewer::calcBoundingData(CalcBoundingBoxData &bbox)
         {
           const byte *bytes = d.data;
 
-          if(!el->perinstance)
+          if(!d.el->perinstance)
             bytes += d.stride * idx;
 
-          QVariantList list = el->GetVariants(bytes, d.end);
+          if(!dec.decode(bytes, d.end, vals))
+            continue;
 
-          for(int comp = 0; comp < list.count(); comp++)
-          {
-            const QVariant &v = list[comp];
+          const int comps = qMin(dec.componentCount(), 4);
 
-            QMetaType::Type vt = (QMetaType::Type)v.type();
-
-            float fval = 0.0f;
-
-            if(vt == QMetaType::Double)
-              fval = (float)v.toDouble();
-            else if(vt == QMetaType::Float)
-              fval = v.toFloat();
-            else if(vt == QMetaType::UInt || vt == QMetaType::UShort || vt == QMetaType::UChar)
-              fval = (float)v.toUInt();
-            else if(vt == QMetaType::Int || vt == QMetaType::Short || vt == QMetaType::SChar)
-              fval = (float)v.toInt();
-            else
-              continue;
-
-            if(qIsFinite(fval))
+          for(int comp = 0; comp < comps; comp++)
+          {
+            if(qIsFinite(vals[comp]))
             {
-              minOut[comp] = qMin(minOut[comp], fval);
-              maxOut[comp] = qMax(maxOut[comp], fval);
+              minOut[comp] = qMin(minOut[comp], vals[comp]);
+              maxOut[comp] = qMax(maxOut[comp], vals[comp]);
             }
           }
         }
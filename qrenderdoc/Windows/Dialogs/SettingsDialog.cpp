@@ -66,6 +66,8 @@ SettingsDialog::SettingsDialog(ICaptureContext &ctx, QWidget *parent)
 
   ui->TextureViewer_ResetRange->setChecked(m_Ctx.Config().TextureViewer_ResetRange);
   ui->TextureViewer_PerTexSettings->setChecked(m_Ctx.Config().TextureViewer_PerTexSettings);
+  ui->TextureViewer_ProxyCoarseMips->setChecked(
+      m_Ctx.Config().GetConfigSetting(lit("proxy.display.coarseMips")).toInt() != 0);
   ui->ShaderViewer_FriendlyNaming->setChecked(m_Ctx.Config().ShaderViewer_FriendlyNaming);
   ui->CheckUpdate_AllowChecks->setChecked(m_Ctx.Config().CheckUpdate_AllowChecks);
   ui->Font_PreferMonospaced->setChecked(m_Ctx.Config().Font_PreferMonospaced);
@@ -234,6 +236,15 @@ void SettingsDialog::on_TextureViewer_ResetRange_toggled(bool checked)
   m_Ctx.Config().Save();
 }
 
+void SettingsDialog::on_TextureViewer_ProxyCoarseMips_toggled(bool checked)
+{
+  // this is read by the core when picking which mip to fetch from a remote replay
+  QString value = ui->TextureViewer_ProxyCoarseMips->isChecked() ? lit("1") : lit("0");
+  m_Ctx.Config().SetConfigSetting(lit("proxy.display.coarseMips"), value);
+
+  m_Ctx.Config().Save();
+}
+
 // shader viewer
 void SettingsDialog::on_ShaderViewer_FriendlyNaming_toggled(bool checked)
 {
@@ -65,6 +65,7 @@ private slots:
   // texture viewer
   void on_TextureViewer_PerTexSettings_toggled(bool checked);
   void on_TextureViewer_ResetRange_toggled(bool checked);
+  void on_TextureViewer_ProxyCoarseMips_toggled(bool checked);
 
   // shader viewer
   void on_ShaderViewer_FriendlyNaming_toggled(bool checked);
@@ -177,6 +177,10 @@ void EventBrowser::OnLogfileLoaded()
 
   frame->addChild(framestart);
 
+  m_EventNodes[0] = framestart;
+  m_SearchIndex.push_back(EventSearchEntry(framestart->text(COL_NAME).toCaseFolded(), framestart));
+  m_SearchIndex.back().subtreeEnd = m_SearchIndex.count();
+
   QPair<uint32_t, uint32_t> lastEIDDraw = AddDrawcalls(frame, m_Ctx.CurDrawcalls());
   frame->setTag(QVariant::fromValue(EventItemTag(0, lastEIDDraw.first)));
 
@@ -199,6 +203,10 @@ void EventBrowser::OnLogfileClosed()
 {
   clearBookmarks();
 
+  m_FindResults.clear();
+  m_SearchIndex.clear();
+  m_EventNodes.clear();
+
   ui->events->clear();
 
   ui->find->setEnabled(false);
@@ -225,8 +233,15 @@ QPair<uint32_t, uint32_t> EventBrowser::AddDrawcalls(RDTreeWidgetItem *parent,
   {
     const DrawcallDescription &d = draws[i];
 
+    QString name = ToQStr(d.name);
+
     RDTreeWidgetItem *child = new RDTreeWidgetItem(
-        {ToQStr(d.name), QString::number(d.eventID), QString::number(d.drawcallID), lit("0.0")});
+        {name, QString::number(d.eventID), QString::number(d.drawcallID), lit("0.0")});
+
+    // add the entry before recursing so the index stays in tree order. The EID is filled in once
+    // we know the last EID of the children
+    int searchIdx = m_SearchIndex.count();
+    m_SearchIndex.push_back(EventSearchEntry(name.toCaseFolded(), child));
 
     QPair<uint32_t, uint32_t> last = AddDrawcalls(child, d.children);
     lastEID = last.first;
@@ -249,6 +264,14 @@ QPair<uint32_t, uint32_t> EventBrowser::AddDrawcalls(RDTreeWidgetItem *parent,
 
     child->setTag(QVariant::fromValue(EventItemTag(draws[i].eventID, lastEID)));
 
+    m_SearchIndex[searchIdx].EID = lastEID;
+    m_SearchIndex[searchIdx].subtreeEnd = m_SearchIndex.count();
+
+    // later nodes overwrite earlier ones, matching the reverse search in FindEventNode where a
+    // 'set' marker shares its EID with the following draw.
+    if(d.children.count == 0)
+      m_EventNodes[lastEID] = child;
+
     if(m_Ctx.Config().EventBrowser_ApplyColors)
     {
       // if alpha isn't 0, assume the colour is valid
@@ -873,8 +896,7 @@ void EventBrowser::toggleBookmark(uint32_t EID)
 {
   int index = m_Bookmarks.indexOf(EID);
 
-  RDTreeWidgetItem *found = NULL;
-  FindEventNode(found, ui->events->topLevelItem(0), EID);
+  RDTreeWidgetItem *found = FindEventNode(EID);
 
   if(index >= 0)
   {
@@ -997,6 +1019,17 @@ bool EventBrowser::FindEventNode(RDTreeWidgetItem *&found, RDTreeWidgetItem *par
   return false;
 }
 
+RDTreeWidgetItem *EventBrowser::FindEventNode(uint32_t eventID)
+{
+  RDTreeWidgetItem *found = m_EventNodes.value(eventID, NULL);
+
+  // events without a node of their own fall back to searching for the closest node after them
+  if(found == NULL && ui->events->topLevelItem(0))
+    FindEventNode(found, ui->events->topLevelItem(0), eventID);
+
+  return found;
+}
+
 void EventBrowser::ExpandNode(RDTreeWidgetItem *node)
 {
   RDTreeWidgetItem *n = node;
@@ -1015,8 +1048,7 @@ bool EventBrowser::SelectEvent(uint32_t eventID)
   if(!m_Ctx.LogLoaded())
     return false;
 
-  RDTreeWidgetItem *found = NULL;
-  FindEventNode(found, ui->events->topLevelItem(0), eventID);
+  RDTreeWidgetItem *found = FindEventNode(eventID);
   if(found != NULL)
   {
     ui->events->setCurrentItem(found);
@@ -1029,109 +1061,86 @@ bool EventBrowser::SelectEvent(uint32_t eventID)
   return false;
 }
 
-void EventBrowser::ClearFindIcons(RDTreeWidgetItem *parent)
+void EventBrowser::ClearFindIcons()
 {
-  for(int i = 0; i < parent->childCount(); i++)
+  for(RDTreeWidgetItem *n : m_FindResults)
   {
-    RDTreeWidgetItem *n = parent->child(i);
-
     EventItemTag tag = n->tag().value<EventItemTag>();
     tag.find = false;
     n->setTag(QVariant::fromValue(tag));
     RefreshIcon(n, tag);
-
-    if(n->childCount() > 0)
-      ClearFindIcons(n);
   }
-}
 
-void EventBrowser::ClearFindIcons()
-{
-  if(m_Ctx.LogLoaded())
-    ClearFindIcons(ui->events->topLevelItem(0));
+  m_FindResults.clear();
 }
 
-int EventBrowser::SetFindIcons(RDTreeWidgetItem *parent, QString filter)
+int EventBrowser::SetFindIcons(QString filter)
 {
+  if(filter.isEmpty())
+    return 0;
+
+  filter = filter.toCaseFolded();
+
   int results = 0;
 
-  for(int i = 0; i < parent->childCount(); i++)
+  for(const EventSearchEntry &e : m_SearchIndex)
   {
-    RDTreeWidgetItem *n = parent->child(i);
-
-    if(n->text(COL_NAME).contains(filter, Qt::CaseInsensitive))
+    if(e.name.contains(filter))
     {
-      EventItemTag tag = n->tag().value<EventItemTag>();
+      EventItemTag tag = e.item->tag().value<EventItemTag>();
       tag.find = true;
-      n->setTag(QVariant::fromValue(tag));
-      RefreshIcon(n, tag);
+      e.item->setTag(QVariant::fromValue(tag));
+      RefreshIcon(e.item, tag);
+      m_FindResults.push_back(e.item);
       results++;
     }
-
-    if(n->childCount() > 0)
-    {
-      results += SetFindIcons(n, filter);
-    }
   }
 
   return results;
 }
 
-int EventBrowser::SetFindIcons(QString filter)
+int EventBrowser::FindEvent(QString filter, uint32_t after, bool forward)
 {
-  if(filter.isEmpty())
+  if(!m_Ctx.LogLoaded())
     return 0;
 
-  return SetFindIcons(ui->events->topLevelItem(0), filter);
-}
+  filter = filter.toCaseFolded();
 
-RDTreeWidgetItem *EventBrowser::FindNode(RDTreeWidgetItem *parent, QString filter, uint32_t after)
-{
-  for(int i = 0; i < parent->childCount(); i++)
+  if(forward)
   {
-    RDTreeWidgetItem *n = parent->child(i);
-
-    uint eid = n->tag().value<EventItemTag>().lastEID;
-
-    if(eid > after && n->text(COL_NAME).contains(filter, Qt::CaseInsensitive))
-      return n;
-
-    if(n->childCount() > 0)
+    for(int i = 0; i < m_SearchIndex.count(); i++)
     {
-      RDTreeWidgetItem *found = FindNode(n, filter, after);
-
-      if(found != NULL)
-        return found;
+      const EventSearchEntry &e = m_SearchIndex[i];
+      if(e.EID > after && e.name.contains(filter))
+        return (int)e.EID;
     }
   }
+  else
+  {
+    return FindEventBackward(0, m_SearchIndex.count(), filter, after);
+  }
 
-  return NULL;
+  return -1;
 }
 
-int EventBrowser::FindEvent(RDTreeWidgetItem *parent, QString filter, uint32_t after, bool forward)
+int EventBrowser::FindEventBackward(int begin, int end, const QString &filter, uint32_t after)
 {
-  if(parent == NULL)
-    return -1;
+  // walk the siblings in [begin, end) last to first, checking each node before its children, the
+  // same order as a reverse walk over the tree
+  QVector<int> siblings;
+  for(int i = begin; i < end; i = m_SearchIndex[i].subtreeEnd)
+    siblings.push_back(i);
 
-  for(int i = forward ? 0 : parent->childCount() - 1; i >= 0 && i < parent->childCount();
-      i += forward ? 1 : -1)
+  for(int s = siblings.count() - 1; s >= 0; s--)
   {
-    auto n = parent->child(i);
+    const EventSearchEntry &e = m_SearchIndex[siblings[s]];
 
-    uint eid = n->tag().value<EventItemTag>().lastEID;
+    if(e.EID < after && e.name.contains(filter))
+      return (int)e.EID;
 
-    bool matchesAfter = (forward && eid > after) || (!forward && eid < after);
-
-    if(matchesAfter)
-    {
-      QString name = n->text(COL_NAME);
-      if(name.contains(filter, Qt::CaseInsensitive))
-        return (int)eid;
-    }
-
-    if(n->childCount() > 0)
+    if(e.subtreeEnd > siblings[s] + 1)
     {
-      int found = FindEvent(n, filter, after, forward);
+      int found = FindEventBackward(siblings[s] + 1, e.subtreeEnd, filter, after);
 
       if(found > 0)
         return found;
@@ -1141,14 +1150,6 @@ int EventBrowser::FindEvent(RDTreeWidgetItem *parent, QString filter, uint32_t a
   return -1;
 }
 
-int EventBrowser::FindEvent(QString filter, uint32_t after, bool forward)
-{
-  if(!m_Ctx.LogLoaded())
-    return 0;
-
-  return FindEvent(ui->events->topLevelItem(0), filter, after, forward);
-}
-
 void EventBrowser::Find(bool forward)
 {
   if(ui->findEvent->text().isEmpty())
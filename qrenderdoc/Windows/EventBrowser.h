@@ -25,7 +25,9 @@
 #pragma once
 
 #include <QFrame>
+#include <QHash>
 #include <QIcon>
+#include <QVector>
 #include "Code/CaptureContext.h"
 
 namespace Ui
@@ -102,20 +104,17 @@ private:
   void ExpandNode(RDTreeWidgetItem *node);
 
   bool FindEventNode(RDTreeWidgetItem *&found, RDTreeWidgetItem *parent, uint32_t eventID);
+  RDTreeWidgetItem *FindEventNode(uint32_t eventID);
   bool SelectEvent(uint32_t eventID);
 
-  void ClearFindIcons(RDTreeWidgetItem *parent);
   void ClearFindIcons();
-
-  int SetFindIcons(RDTreeWidgetItem *parent, QString filter);
   int SetFindIcons(QString filter);
 
   void highlightBookmarks();
   bool hasBookmark(RDTreeWidgetItem *node);
 
-  RDTreeWidgetItem *FindNode(RDTreeWidgetItem *parent, QString filter, uint32_t after);
-  int FindEvent(RDTreeWidgetItem *parent, QString filter, uint32_t after, bool forward);
   int FindEvent(QString filter, uint32_t after, bool forward);
+  int FindEventBackward(int begin, int end, const QString &filter, uint32_t after);
   void Find(bool forward);
 
   QString GetExportDrawcallString(int indent, bool firstchild, const DrawcallDescription &drawcall);
@@ -136,6 +135,28 @@ private:
   QList<int> m_Bookmarks;
   QList<QToolButton *> m_BookmarkButtons;
 
+  struct EventSearchEntry
+  {
+    EventSearchEntry() : EID(0), subtreeEnd(0), item(NULL) {}
+    EventSearchEntry(const QString &n, RDTreeWidgetItem *i)
+        : name(n), EID(0), subtreeEnd(0), item(i)
+    {
+    }
+    // case-folded so searches only need to fold the filter once
+    QString name;
+    uint32_t EID;
+    // index just past this node's descendants, which directly follow it
+    int subtreeEnd;
+    RDTreeWidgetItem *item;
+  };
+
+  // leaf nodes by their last EID, so jumping to an event doesn't need to walk the tree
+  QHash<uint32_t, RDTreeWidgetItem *> m_EventNodes;
+  // every node in tree order, built once when the log is loaded and searched linearly
+  QVector<EventSearchEntry> m_SearchIndex;
+  // nodes that currently have the find icon set
+  QVector<RDTreeWidgetItem *> m_FindResults;
+
   void RefreshIcon(RDTreeWidgetItem *item, EventItemTag tag);
 
   Ui::EventBrowser *ui;
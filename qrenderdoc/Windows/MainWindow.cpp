@@ -951,6 +951,12 @@ void MainWindow::messageCheck()
     m_Ctx.Replay().AsyncInvoke([this](IReplayController *r) {
       rdctype::array<DebugMessage> msgs = r->GetDebugMessages();
 
+      // image files are reloaded in the background when they change on disk, so pick up the new
+      // contents here and refresh the views below
+      bool fileChanged = r->HasFileChanged();
+      if(fileChanged)
+        r->FileChanged();
+
       bool disconnected = false;
 
       if(m_Ctx.Replay().CurrentRemote())
@@ -963,7 +969,7 @@ void MainWindow::messageCheck()
           disconnected = true;
       }
 
-      GUIInvoke::call([this, disconnected, msgs] {
+      GUIInvoke::call([this, disconnected, msgs, fileChanged] {
         // if we just got disconnected while replaying a log, alert the user.
         if(disconnected)
         {
@@ -982,6 +988,9 @@ void MainWindow::messageCheck()
           m_Ctx.AddMessages(msgs);
         }
 
+        if(fileChanged)
+          m_Ctx.RefreshStatus();
+
         if(m_Ctx.UnreadMessageCount() > 0)
           m_messageAlternate = !m_messageAlternate;
         else
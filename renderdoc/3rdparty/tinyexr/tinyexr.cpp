@@ -1,2 +1,47 @@
+#include <vector>
+#include "common/threading.h"
+
+// encode blocks of scanlines in parallel when saving
+#define TINYEXR_PARALLEL_FOR(count, func) Threading::ParallelFor(count, func)
+
 #define TINYEXR_IMPLEMENTATION
 #include "tinyexr.h"
+
+#include "tinyexr_miniz.h"
+
+static miniz::mz_bool AppendToByteVector(const void *buf, int len, void *user)
+{
+  std::vector<byte> *out = (std::vector<byte> *)user;
+  out->insert(out->end(), (const byte *)buf, (const byte *)buf + len);
+  return MZ_TRUE;
+}
+
+bool miniz_deflate_raw(std::vector<byte> &out, const byte *data, size_t len, bool finish)
+{
+  using namespace miniz;
+
+  tdefl_compressor *comp = (tdefl_compressor *)malloc(sizeof(tdefl_compressor));
+  if(!comp)
+    return false;
+
+  const int flags = (int)tdefl_create_comp_flags_from_zip_params(
+      MZ_DEFAULT_LEVEL, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY);
+
+  tdefl_status status = tdefl_init(comp, &AppendToByteVector, &out, flags);
+  if(status == TDEFL_STATUS_OKAY)
+    status = tdefl_compress_buffer(comp, data, len, finish ? TDEFL_FINISH : TDEFL_SYNC_FLUSH);
+
+  free(comp);
+
+  return status == (finish ? TDEFL_STATUS_DONE : TDEFL_STATUS_OKAY);
+}
+
+uint32_t miniz_crc32(uint32_t crc, const byte *data, size_t len)
+{
+  return (uint32_t)miniz::mz_crc32(crc, data, len);
+}
+
+uint32_t miniz_adler32(uint32_t adler, const byte *data, size_t len)
+{
+  return (uint32_t)miniz::mz_adler32(adler, data, len);
+}
@@ -9996,10 +9996,16 @@ size_t SaveMultiChannelEXRToMemory(const EXRImage *exrImage,
     }
   }
 
+  // RenderDoc: TINYEXR_PARALLEL_FOR(count, func) can be defined to run the
+  // per-block encode on several threads without OpenMP.
+#if defined(TINYEXR_PARALLEL_FOR)
+  auto encodeBlock = [&](int i) {
+#else
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
   for (int i = 0; i < numBlocks; i++) {
+#endif
     int startY = numScanlines * i;
     int endY = (std::min)(numScanlines * (i + 1), exrImage->height);
     int h = endY - startY;
@@ -10193,7 +10199,12 @@ size_t SaveMultiChannelEXRToMemory(const EXRImage *exrImage,
       assert(0);
     }
 
+#if defined(TINYEXR_PARALLEL_FOR)
+  };
+  TINYEXR_PARALLEL_FOR(numBlocks, encodeBlock);
+#else
   } // omp parallel
+#endif
 
   for (int i = 0; i < numBlocks; i++) {
 
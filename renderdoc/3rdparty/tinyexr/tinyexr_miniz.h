@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "common/common.h"
+
+// tinyexr embeds a private copy of miniz. These are implemented in tinyexr.cpp and expose the parts
+// the PNG writer needs, rather than compiling in a second copy.
+
+// appends raw deflate data to out, either ending with a final block or with a sync flush to a byte
+// boundary.
+bool miniz_deflate_raw(std::vector<byte> &out, const byte *data, size_t len, bool finish);
+uint32_t miniz_crc32(uint32_t crc, const byte *data, size_t len);
+uint32_t miniz_adler32(uint32_t adler, const byte *data, size_t len);
@@ -693,6 +693,106 @@ this counts the frame number when the capture was made.
 
 DECLARE_REFLECTION_STRUCT(FrameDescription);
 
+DOCUMENT("Totals for one type of chunk in a capture file.");
+struct ChunkStatistics
+{
+  ChunkStatistics() : chunkID(0), count(0), frameCount(0), totalBytes(0) {}
+  DOCUMENT("The API-specific ID of this chunk type.");
+  uint32_t chunkID;
+
+  DOCUMENT("The human-readable name of this chunk type.");
+  rdctype::str name;
+
+  DOCUMENT("The number of chunks of this type in the whole capture.");
+  uint32_t count;
+
+  DOCUMENT("The number of chunks of this type inside the captured frame.");
+  uint32_t frameCount;
+
+  DOCUMENT("The total number of bytes taken up by chunks of this type, after decompression.");
+  uint64_t totalBytes;
+};
+
+DECLARE_REFLECTION_STRUCT(ChunkStatistics);
+
+DOCUMENT(R"(Totals for the resources of one type that are created in a capture.
+
+This is measured from the capture file, so :data:`bytes` is the serialised size of the chunks that
+create and fill resources of this type, not the memory used by the replay.
+)");
+struct ResourceTypeStatistics
+{
+  ResourceTypeStatistics() : count(0), bytes(0) {}
+  DOCUMENT("The name of this type of resource.");
+  rdctype::str type;
+
+  DOCUMENT("The number of creation calls for resources of this type.");
+  uint32_t count;
+
+  DOCUMENT("The total number of bytes in the creation and data chunks for this type.");
+  uint64_t bytes;
+};
+
+DECLARE_REFLECTION_STRUCT(ResourceTypeStatistics);
+
+DOCUMENT(R"(Statistics about a capture that are computed directly from the capture file, without
+replaying it.
+)");
+struct CaptureStatistics
+{
+  CaptureStatistics()
+      : compressedFileSize(0),
+        uncompressedFileSize(0),
+        frameBytes(0),
+        initialContentsBytes(0),
+        drawcalls(0),
+        dispatches(0),
+        clears(0),
+        copies(0),
+        uploads(0),
+        uploadBytes(0)
+  {
+  }
+
+  DOCUMENT("The total file size of the whole capture in bytes, before decompression.");
+  uint64_t compressedFileSize;
+
+  DOCUMENT("The total file size of the whole capture in bytes, after decompression.");
+  uint64_t uncompressedFileSize;
+
+  DOCUMENT("The number of bytes of chunks inside the captured frame.");
+  uint64_t frameBytes;
+
+  DOCUMENT("The number of bytes of frame-initial resource contents.");
+  uint64_t initialContentsBytes;
+
+  DOCUMENT("The number of drawcalls recorded in the frame.");
+  uint32_t drawcalls;
+
+  DOCUMENT("The number of compute dispatches recorded in the frame.");
+  uint32_t dispatches;
+
+  DOCUMENT("The number of clears recorded in the frame.");
+  uint32_t clears;
+
+  DOCUMENT("The number of copies, resolves and blits recorded in the frame.");
+  uint32_t copies;
+
+  DOCUMENT("The number of maps and resource data updates recorded in the frame.");
+  uint32_t uploads;
+
+  DOCUMENT("The number of bytes of chunks for the maps and updates counted in :data:`uploads`.");
+  uint64_t uploadBytes;
+
+  DOCUMENT("A list of :class:`ChunkStatistics`, one for each type of chunk in the capture.");
+  rdctype::array<ChunkStatistics> chunks;
+
+  DOCUMENT("A list of :class:`ResourceTypeStatistics`, one for each type of resource created.");
+  rdctype::array<ResourceTypeStatistics> resources;
+};
+
+DECLARE_REFLECTION_STRUCT(CaptureStatistics);
+
 DOCUMENT("Describes a particular use of a resource at a specific :data:`EID <APIEvent.eventID>`.");
 struct EventUsage
 {
@@ -401,6 +401,41 @@ protected:
   ~IReplayOutput() = default;
 };
 
+DOCUMENT(R"(A handle to the contents of a buffer or texture being read back in bounded chunks, see
+:meth:`ReplayController.StreamBufferData` and :meth:`ReplayController.StreamTextureData`.
+
+This allows resources that are too large to return in one piece to be processed incrementally, for
+example when writing them to disk.
+)");
+struct IReadbackStream
+{
+  DOCUMENT(R"(Retrieve the total number of bytes that the stream will return.
+
+:return: The total size of the data in bytes.
+:rtype: ``int``
+)");
+  virtual uint64_t GetTotalSize() = 0;
+
+  DOCUMENT(R"(Retrieve the byte offset, relative to the start of the stream, of the next chunk.
+
+:return: The offset of the next chunk in bytes.
+:rtype: ``int``
+)");
+  virtual uint64_t GetOffset() = 0;
+
+  DOCUMENT(R"(Read the next chunk of data from the stream.
+
+:return: The next chunk of data, no larger than the chunk size the stream was created with. Once all
+  of the data has been read an empty chunk is returned.
+:rtype: ``memoryview``
+)");
+  virtual rdctype::array<byte> ReadChunk() = 0;
+
+protected:
+  IReadbackStream() = default;
+  ~IReadbackStream() = default;
+};
+
 DOCUMENT(R"(The primary interface to access the information in a capture and the current state, as
 well as control the replay and analysis functionality available.
 
@@ -447,6 +482,17 @@ struct IReplayController
   DOCUMENT("Notify the interface that the file it has open has been changed on disk.");
   virtual void FileChanged() = 0;
 
+  DOCUMENT(R"(Query if the file this interface has open has changed on disk and the changes are
+ready to be picked up. Currently only image files are watched for changes.
+
+When this returns ``True``, call :meth:`FileChanged` and then refresh anything displaying data from
+the file.
+
+:return: ``True`` if the file has changed, ``False`` otherwise.
+:rtype: ``bool``
+)");
+  virtual bool HasFileChanged() = 0;
+
   DOCUMENT(R"(Query if per-event or per-draw callstacks are available in this capture.
 
 :return: ``True`` if any callstacks are available, ``False`` otherwise.
@@ -594,6 +640,16 @@ See :meth:`BuildTargetShader`.
 )");
   virtual FrameDescription GetFrameInfo() = 0;
 
+  DOCUMENT(R"(Retrieve statistics about the capture file, such as chunk counts and sizes.
+
+These are computed by reading through the capture file rather than from the replay. When replaying
+remotely the capture isn't available locally, so the statistics will be empty.
+
+:return: The capture statistics.
+:rtype: CaptureStatistics
+)");
+  virtual CaptureStatistics GetCaptureStatistics() = 0;
+
   DOCUMENT(R"(Retrieve the list of root-level drawcalls in the capture.
 
 :return: The list of root-level drawcalls in the capture.
@@ -729,6 +785,24 @@ newly generated messages will be returned after that.
 )");
   virtual rdctype::array<EventUsage> GetUsage(ResourceId id) = 0;
 
+  DOCUMENT(R"(Retrieve the usages of a given resource within an inclusive range of events,
+optionally restricted to particular kinds of usage.
+
+This is equivalent to filtering the results of :meth:`GetUsage` but avoids returning the whole
+usage list for heavily used resources.
+
+:param ResourceId id: The id of the texture or buffer resource to be queried.
+:param int firstEventID: The first event ID to include.
+:param int lastEventID: The last event ID to include.
+:param list usages: A list of :class:`ResourceUsage` values to include. If empty, all usages
+  are included.
+:return: The list of matching usages of the resource.
+:rtype: ``list`` of :class:`EventUsage`
+)");
+  virtual rdctype::array<EventUsage> GetUsageInRange(ResourceId id, uint32_t firstEventID,
+                                                     uint32_t lastEventID,
+                                                     const rdctype::array<ResourceUsage> &usages) = 0;
+
   DOCUMENT(R"(Retrieve the contents of a constant block by reading from memory or their source
 otherwise.
 
@@ -766,17 +840,22 @@ texture to something compatible with the target file format.
 )");
   virtual MeshFormat GetPostVSData(uint32_t instID, MeshDataStage stage) = 0;
 
-  DOCUMENT(R"(Retrieve the contents of a range of a buffer as a ``bytes``.
+  DOCUMENT(R"(Retrieve the contents of a range of a buffer as a read-only ``memoryview``.
+
+The memoryview refers directly to the data read back, without any copy. It can be used anywhere a
+bytes-like object is accepted, such as ``struct.unpack_from`` or ``numpy.frombuffer``.
 
 :param ResourceId buff: The id of the buffer to retrieve data from.
 :param int offset: The byte offset to the start of the range.
 :param int len: The length of the range, or 0 to retrieve the rest of the bytes in the buffer.
 :return: The requested buffer contents.
-:rtype: ``bytes``
+:rtype: ``memoryview``
 )");
   virtual rdctype::array<byte> GetBufferData(ResourceId buff, uint64_t offset, uint64_t len) = 0;
 
-  DOCUMENT(R"(Retrieve the contents of one subresource of a texture as a ``bytes``.
+  DOCUMENT(R"(Retrieve the contents of one subresource of a texture as a read-only ``memoryview``.
+
+The memoryview refers directly to the data read back, without any copy.
 
 For multi-sampled images, they are treated as if they are an array that is Nx longer, with each
 array slice being expanded in-place so it would be slice 0: sample 0, slice 0: sample 1, slice 1:
@@ -786,10 +865,82 @@ sample 0, etc.
 :param int arrayIdx: The slice of an array or 3D texture, or face of a cubemap texture.
 :param int mip: The mip level to pick from.
 :return: The requested texture contents.
-:rtype: ``bytes``
+:rtype: ``memoryview``
 )");
   virtual rdctype::array<byte> GetTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t mip) = 0;
 
+  DOCUMENT(R"(Begin reading back a range of a buffer in bounded chunks.
+
+Unlike :meth:`GetBufferData` there is no limit on the size of the range, and each chunk is read back
+from the replay as it's requested so memory use only depends on the chunk size. Each chunk reflects
+the buffer contents at the current event when it's read.
+
+The stream must be shut down with :meth:`ShutdownReadbackStream` when it's no longer needed.
+
+:param ResourceId buff: The id of the buffer to retrieve data from.
+:param int offset: The byte offset to the start of the range.
+:param int len: The length of the range, or 0 to retrieve the rest of the bytes in the buffer.
+:param int chunkSize: The maximum size of each chunk in bytes, or 0 to use a default size.
+:return: A handle to the stream, or ``None`` if the buffer couldn't be found.
+:rtype: ReadbackStream
+)");
+  virtual IReadbackStream *StreamBufferData(ResourceId buff, uint64_t offset, uint64_t len,
+                                            uint32_t chunkSize) = 0;
+
+  DOCUMENT(R"(Begin reading back one subresource of a texture in bounded chunks.
+
+The data is laid out as in :meth:`GetTextureData`, but subresources of any size can be read without
+being returned as one array.
+
+The stream must be shut down with :meth:`ShutdownReadbackStream` when it's no longer needed.
+
+:param ResourceId tex: The id of the texture to retrieve data from.
+:param int arrayIdx: The slice of an array or 3D texture, or face of a cubemap texture.
+:param int mip: The mip level to pick from.
+:param int chunkSize: The maximum size of each chunk in bytes, or 0 to use a default size.
+:return: A handle to the stream, or ``None`` if the texture couldn't be found.
+:rtype: ReadbackStream
+)");
+  virtual IReadbackStream *StreamTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t mip,
+                                             uint32_t chunkSize) = 0;
+
+  DOCUMENT(R"(Shutdown a readback stream and release any data it holds.
+
+:param ReadbackStream stream: The stream to shut down.
+)");
+  virtual void ShutdownReadbackStream(IReadbackStream *stream) = 0;
+
+  DOCUMENT(R"(Enable or disable speculative readbacks for :meth:`ProcessPrefetch`.
+
+Prefetching is disabled by default, since it only helps callers that read back texture data with
+:meth:`GetTextureData` as they move between events. Disabling it discards anything already queued.
+
+:param bool enabled: ``True`` to queue speculative readbacks on each :meth:`SetFrameEvent`.
+)");
+  virtual void SetPrefetchEnabled(bool enabled) = 0;
+
+  DOCUMENT(R"(Perform a bounded amount of speculative readback work while the caller is idle.
+
+If enabled with :meth:`SetPrefetchEnabled`, after each :meth:`SetFrameEvent` the controller
+predicts which data is likely to be requested next - such as the outputs of the selected drawcall
+and its neighbours - and queues it to be read back into a bounded cache. Later calls to
+:meth:`GetTextureData` and :meth:`GetBufferData` are served from this cache when possible.
+
+Explicit requests are never delayed by prefetching, this function must be called by the user of the
+controller when it has nothing else to do, and it only processes a small amount of work each call.
+
+:return: ``True`` if there is more speculative work pending, ``False`` if the queue is empty.
+:rtype: ``bool``
+)");
+  virtual bool ProcessPrefetch() = 0;
+
+  DOCUMENT(R"(Discard any pending speculative readbacks queued for :meth:`ProcessPrefetch`.
+
+The queue is automatically reset whenever the current event changes, so this is only needed if the
+caller knows the predicted data won't be needed.
+)");
+  virtual void CancelPrefetch() = 0;
+
   static const uint32_t NoPreference = ~0U;
 
 protected:
@@ -1119,10 +1270,20 @@ by the :class:`ReplayController`.
 :param int maxsize: The largest width or height allowed. If the thumbnail is larger, it's resized.
 :return: The raw contents of the thumbnail, converted to the desired type at the desired max
   resolution.
-:rtype: ``bytes``.
+:rtype: ``memoryview``.
   )");
   virtual rdctype::array<byte> GetThumbnail(FileType type, uint32_t maxsize) = 0;
 
+  DOCUMENT(R"(Computes statistics about the capture, such as chunk counts and sizes and the number
+of drawcalls, from a single pass over the file.
+
+This doesn't replay the capture, so it works without a GPU or a local replay driver for the API.
+
+:return: The status of the operation, and the capture statistics.
+:rtype: ``tuple`` of :class:`ReplayStatus` and :class:`CaptureStatistics`
+)");
+  virtual rdctype::pair<ReplayStatus, CaptureStatistics> GetStatistics() = 0;
+
 protected:
   ICaptureFile() = default;
   ~ICaptureFile() = default;
@@ -1216,6 +1377,29 @@ If any errors happen this can be queried with :meth:`CaptureFile.Status`.
 )");
 extern "C" RENDERDOC_API ICaptureFile *RENDERDOC_CC RENDERDOC_OpenCaptureFile(const char *logfile);
 
+DOCUMENT(R"(Fetch the embedded thumbnails for a list of captures, using an on-disk cache.
+
+Each thumbnail is converted to the requested format and size the first time it's needed and stored
+in the cache, keyed by the capture's path, size and modification time. Later calls for an unchanged
+capture return the cached file without reading the capture at all. The cache is limited in size,
+and the least recently used thumbnails are removed when it grows too large, apart from those just
+returned.
+
+Captures are processed in parallel, and each is only read as far as the thumbnail so this is much
+cheaper than opening each with :func:`OpenCaptureFile`.
+
+:param list captures: The paths of the captures to fetch thumbnails for.
+:param FileType type: The file type to convert the thumbnails to.
+:param int maxsize: The largest width or height allowed. If 0, the thumbnails are not resized.
+:param int numThreads: How many captures to process at once. If 0, one per CPU core is used.
+:param list thumbnails: Filled out with the path to each capture's cached thumbnail, in the same
+  order as ``captures``. If a capture has no thumbnail or couldn't be read, its entry is empty.
+)");
+extern "C" RENDERDOC_API void RENDERDOC_CC
+RENDERDOC_GetCachedThumbnails(const rdctype::array<rdctype::str> &captures, FileType type,
+                              uint32_t maxsize, uint32_t numThreads,
+                              rdctype::array<rdctype::str> *thumbnails);
+
 //////////////////////////////////////////////////////////////////////////
 // Target Control
 //////////////////////////////////////////////////////////////////////////
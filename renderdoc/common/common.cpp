@@ -223,6 +223,45 @@ bool FindDiffRange(void *a, void *b, size_t bufSize, size_t &diffStart, size_t &
   return diffStart < bufSize;
 }
 
+uint64_t Hash64(const void *data, size_t len, uint64_t seed)
+{
+  const uint64_t m = 0xc6a4a7935bd1e995ULL;
+  const int r = 47;
+
+  uint64_t h = seed ^ (len * m);
+
+  const byte *bytes = (const byte *)data;
+  const byte *end = bytes + (len & ~size_t(7));
+
+  for(; bytes != end; bytes += sizeof(uint64_t))
+  {
+    uint64_t k;
+    memcpy(&k, bytes, sizeof(k));
+
+    k *= m;
+    k ^= k >> r;
+    k *= m;
+
+    h ^= k;
+    h *= m;
+  }
+
+  // mix in the trailing 0-7 bytes
+  if(len & 7)
+  {
+    for(size_t i = (len & 7); i > 0; i--)
+      h ^= uint64_t(bytes[i - 1]) << (8 * (i - 1));
+
+    h *= m;
+  }
+
+  h ^= h >> r;
+  h *= m;
+  h ^= h >> r;
+
+  return h;
+}
+
 uint32_t CalcNumMips(int w, int h, int d)
 {
   int mipLevels = 1;
@@ -156,6 +156,10 @@ inline T AlignUpPtr(T x, A a)
   (((uint32_t)(d) << 24) | ((uint32_t)(c) << 16) | ((uint32_t)(b) << 8) | (uint32_t)(a))
 
 bool FindDiffRange(void *a, void *b, size_t bufSize, size_t &diffStart, size_t &diffEnd);
+
+// fast non-cryptographic 64-bit hash of a block of memory (MurmurHash64A). The seed can be used to
+// chain hashes of several blocks together.
+uint64_t Hash64(const void *data, size_t len, uint64_t seed = 0);
 uint32_t CalcNumMips(int Width, int Height, int Depth);
 
 uint32_t Log2Floor(uint32_t value);
@@ -24,6 +24,7 @@
 
 #include "dds_readwrite.h"
 #include <stdint.h>
+#include <string.h>
 #include "common/common.h"
 
 static const uint32_t dds_fourcc = MAKE_FOURCC('D', 'D', 'S', ' ');
@@ -623,7 +624,87 @@ DXGI_FORMAT ResourceFormat2DXGIFormat(ResourceFormat format)
   return DXGI_FORMAT_UNKNOWN;
 }
 
-bool write_dds_to_file(FILE *f, const dds_data &data)
+// how a format is stored in a DDS file - either in 4x4 blocks, or as pixels of a fixed size.
+// Returns false if the format can't be stored in a DDS at all.
+static bool get_dds_layout(const ResourceFormat &format, uint32_t &bytesPerPixel, bool &blockFormat)
+{
+  bytesPerPixel = 1;
+  blockFormat = false;
+
+  if(format.special)
+  {
+    switch(format.specialFormat)
+    {
+      case SpecialFormat::BC1:
+      case SpecialFormat::BC2:
+      case SpecialFormat::BC3:
+      case SpecialFormat::BC4:
+      case SpecialFormat::BC5:
+      case SpecialFormat::BC6:
+      case SpecialFormat::BC7: blockFormat = true; return true;
+      case SpecialFormat::ETC2:
+      case SpecialFormat::EAC:
+      case SpecialFormat::ASTC:
+      case SpecialFormat::YUV:
+        RDCERR("Unsupported file format, %u", format.specialFormat);
+        return false;
+      default: break;
+    }
+  }
+
+  switch(format.specialFormat)
+  {
+    case SpecialFormat::S8: bytesPerPixel = 1; break;
+    case SpecialFormat::R10G10B10A2:
+    case SpecialFormat::R9G9B9E5:
+    case SpecialFormat::R11G11B10:
+    case SpecialFormat::D24S8: bytesPerPixel = 4; break;
+    case SpecialFormat::R5G6B5:
+    case SpecialFormat::R5G5B5A1:
+    case SpecialFormat::R4G4B4A4: bytesPerPixel = 2; break;
+    case SpecialFormat::D32S8: bytesPerPixel = 8; break;
+    case SpecialFormat::D16S8:
+    case SpecialFormat::YUV:
+    case SpecialFormat::R4G4:
+      RDCERR("Unsupported file format %u", format.specialFormat);
+      return false;
+    default: bytesPerPixel = format.compCount * format.compByteWidth;
+  }
+
+  return true;
+}
+
+uint64_t dds_subresource_size(const dds_data &data, int mip)
+{
+  uint32_t bytesPerPixel = 1;
+  bool blockFormat = false;
+
+  if(!get_dds_layout(data.format, bytesPerPixel, blockFormat))
+    return 0;
+
+  // a whole 3D mip can be larger than 4GB, so the size is calculated in 64-bit
+  uint64_t rowlen = (uint64_t)RDCMAX(1, data.width >> mip);
+  uint64_t numRows = (uint64_t)RDCMAX(1, data.height >> mip);
+  uint64_t numdepths = (uint64_t)RDCMAX(1, data.depth >> mip);
+  uint64_t pitch = RDCMAX((uint64_t)1, rowlen * bytesPerPixel);
+
+  // pitch/rows are in blocks, not pixels, for block formats.
+  if(blockFormat)
+  {
+    numRows = RDCMAX((uint64_t)1, numRows / 4);
+
+    uint64_t blockSize = (data.format.specialFormat == SpecialFormat::BC1 ||
+                          data.format.specialFormat == SpecialFormat::BC4)
+                             ? 8
+                             : 16;
+
+    pitch = RDCMAX(blockSize, ((rowlen + 3) / 4) * blockSize);
+  }
+
+  return numdepths * numRows * pitch;
+}
+
+bool write_dds_header(FILE *f, const dds_data &data)
 {
   if(!f)
     return false;
@@ -649,28 +730,11 @@ bool write_dds_to_file(FILE *f, const dds_data &data)
   if(data.depth > 1)
     header.dwFlags |= DDSD_DEPTH;
 
+  uint32_t bytesPerPixel = 1;
   bool blockFormat = false;
 
-  if(data.format.special)
-  {
-    switch(data.format.specialFormat)
-    {
-      case SpecialFormat::BC1:
-      case SpecialFormat::BC2:
-      case SpecialFormat::BC3:
-      case SpecialFormat::BC4:
-      case SpecialFormat::BC5:
-      case SpecialFormat::BC6:
-      case SpecialFormat::BC7: blockFormat = true; break;
-      case SpecialFormat::ETC2:
-      case SpecialFormat::EAC:
-      case SpecialFormat::ASTC:
-      case SpecialFormat::YUV:
-        RDCERR("Unsupported file format, %u", data.format.specialFormat);
-        return false;
-      default: break;
-    }
-  }
+  if(!get_dds_layout(data.format, bytesPerPixel, blockFormat))
+    return false;
 
   if(blockFormat)
     header.dwFlags |= DDSD_LINEARSIZE;
@@ -709,8 +773,6 @@ bool write_dds_to_file(FILE *f, const dds_data &data)
   if(headerDXT10.arraySize > 1)
     dx10Header = true;    // need to specify dx10 header to give array size
 
-  uint32_t bytesPerPixel = 1;
-
   if(blockFormat)
   {
     int blockSize = (data.format.specialFormat == SpecialFormat::BC1 ||
@@ -721,25 +783,6 @@ bool write_dds_to_file(FILE *f, const dds_data &data)
   }
   else
   {
-    switch(data.format.specialFormat)
-    {
-      case SpecialFormat::S8: bytesPerPixel = 1; break;
-      case SpecialFormat::R10G10B10A2:
-      case SpecialFormat::R9G9B9E5:
-      case SpecialFormat::R11G11B10:
-      case SpecialFormat::D24S8: bytesPerPixel = 4; break;
-      case SpecialFormat::R5G6B5:
-      case SpecialFormat::R5G5B5A1:
-      case SpecialFormat::R4G4B4A4: bytesPerPixel = 2; break;
-      case SpecialFormat::D32S8: bytesPerPixel = 8; break;
-      case SpecialFormat::D16S8:
-      case SpecialFormat::YUV:
-      case SpecialFormat::R4G4:
-        RDCERR("Unsupported file format %u", data.format.specialFormat);
-        return false;
-      default: bytesPerPixel = data.format.compCount * data.format.compByteWidth;
-    }
-
     header.dwPitchOrLinearSize = header.dwWidth * bytesPerPixel;
   }
 
@@ -805,48 +848,40 @@ bool write_dds_to_file(FILE *f, const dds_data &data)
     header.ddspf.dwFourCC = MAKE_FOURCC('D', 'X', '1', '0');
   }
 
-  {
-    FileIO::fwrite(&magic, sizeof(magic), 1, f);
-    FileIO::fwrite(&header, sizeof(header), 1, f);
-    if(dx10Header)
-      FileIO::fwrite(&headerDXT10, sizeof(headerDXT10), 1, f);
-
-    int i = 0;
-    for(int slice = 0; slice < RDCMAX(1, data.slices); slice++)
-    {
-      for(int mip = 0; mip < RDCMAX(1, data.mips); mip++)
-      {
-        int numdepths = RDCMAX(1, data.depth >> mip);
-        for(int d = 0; d < numdepths; d++)
-        {
-          byte *bytedata = data.subdata[i];
-
-          int rowlen = RDCMAX(1, data.width >> mip);
-          int numRows = RDCMAX(1, data.height >> mip);
-          int pitch = RDCMAX(1U, rowlen * bytesPerPixel);
+  if(FileIO::fwrite(&magic, sizeof(magic), 1, f) != 1 ||
+     FileIO::fwrite(&header, sizeof(header), 1, f) != 1)
+    return false;
 
-          // pitch/rows are in blocks, not pixels, for block formats.
-          if(blockFormat)
-          {
-            numRows = RDCMAX(1, numRows / 4);
+  if(dx10Header && FileIO::fwrite(&headerDXT10, sizeof(headerDXT10), 1, f) != 1)
+    return false;
 
-            int blockSize = (data.format.specialFormat == SpecialFormat::BC1 ||
-                             data.format.specialFormat == SpecialFormat::BC4)
-                                ? 8
-                                : 16;
+  return true;
+}
 
-            pitch = RDCMAX(blockSize, (((rowlen + 3) / 4)) * blockSize);
-          }
+bool write_dds_to_file(FILE *f, const dds_data &data)
+{
+  if(!write_dds_header(f, data))
+    return false;
 
-          for(int row = 0; row < numRows; row++)
-          {
-            FileIO::fwrite(bytedata, 1, pitch, f);
+  int i = 0;
+  for(int slice = 0; slice < RDCMAX(1, data.slices); slice++)
+  {
+    for(int mip = 0; mip < RDCMAX(1, data.mips); mip++)
+    {
+      int numdepths = RDCMAX(1, data.depth >> mip);
 
-            bytedata += pitch;
-          }
+      // each depth slice is a separate tightly packed subdata, so write it in one go
+      size_t size = size_t(dds_subresource_size(data, mip) / numdepths);
 
-          i++;
+      for(int d = 0; d < numdepths; d++)
+      {
+        if(FileIO::fwrite(data.subdata[i], 1, size, f) != size)
+        {
+          RDCERR("Failed to write DDS data: %s", FileIO::ErrorString().c_str());
+          return false;
         }
+
+        i++;
       }
     }
   }
@@ -866,32 +901,15 @@ bool is_dds_file(FILE *f)
   return magic == dds_fourcc;
 }
 
-dds_data load_dds_from_file(FILE *f)
+// fills out everything but the subresource data from the headers. headerDXT10 is NULL if the file
+// has no DX10 header.
+static bool parse_dds_header(const DDS_HEADER &header, const DDS_HEADER_DXT10 *headerDXT10,
+                             dds_data &ret)
 {
-  dds_data ret = {};
-  dds_data error = {};
-
-  FileIO::fseek64(f, 0, SEEK_SET);
-
-  uint32_t magic = 0;
-  FileIO::fread(&magic, sizeof(magic), 1, f);
-
-  DDS_HEADER header = {};
-  FileIO::fread(&header, sizeof(header), 1, f);
-
-  bool dx10Header = false;
-  DDS_HEADER_DXT10 headerDXT10 = {};
-
-  if(header.ddspf.dwFlags == DDPF_FOURCC && header.ddspf.dwFourCC == MAKE_FOURCC('D', 'X', '1', '0'))
-  {
-    FileIO::fread(&headerDXT10, sizeof(headerDXT10), 1, f);
-    dx10Header = true;
-  }
-
   ret.width = RDCMAX(1U, header.dwWidth);
   ret.height = RDCMAX(1U, header.dwHeight);
   ret.depth = RDCMAX(1U, header.dwDepth);
-  ret.slices = dx10Header ? RDCMAX(1U, headerDXT10.arraySize) : 1;
+  ret.slices = headerDXT10 ? RDCMAX(1U, headerDXT10->arraySize) : 1;
   ret.mips = RDCMAX(1U, header.dwMipMapCount);
 
   uint32_t cubeFlags = DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_ALLFACES;
@@ -899,19 +917,19 @@ dds_data load_dds_from_file(FILE *f)
   if((header.dwCaps2 & cubeFlags) == cubeFlags && header.dwCaps & DDSCAPS_COMPLEX)
     ret.cubemap = true;
 
-  if(dx10Header && headerDXT10.miscFlag & DDS_RESOURCE_MISC_TEXTURECUBE)
+  if(headerDXT10 && headerDXT10->miscFlag & DDS_RESOURCE_MISC_TEXTURECUBE)
     ret.cubemap = true;
 
   if(ret.cubemap)
     ret.slices *= 6;
 
-  if(dx10Header)
+  if(headerDXT10)
   {
-    ret.format = DXGIFormat2ResourceFormat(headerDXT10.dxgiFormat);
+    ret.format = DXGIFormat2ResourceFormat(headerDXT10->dxgiFormat);
     if(ret.format.special && ret.format.specialFormat == SpecialFormat::Unknown)
     {
-      RDCWARN("Unsupported DXGI_FORMAT: %u", (uint32_t)headerDXT10.dxgiFormat);
-      return error;
+      RDCWARN("Unsupported DXGI_FORMAT: %u", (uint32_t)headerDXT10->dxgiFormat);
+      return false;
     }
   }
   else if(header.ddspf.dwFlags & DDPF_FOURCC)
@@ -955,7 +973,7 @@ dds_data load_dds_from_file(FILE *f)
       case 114: ret.format = DXGIFormat2ResourceFormat(DXGI_FORMAT_R32_FLOAT); break;
       case 115: ret.format = DXGIFormat2ResourceFormat(DXGI_FORMAT_R32G32_FLOAT); break;
       case 116: ret.format = DXGIFormat2ResourceFormat(DXGI_FORMAT_R32G32B32A32_FLOAT); break;
-      default: RDCWARN("Unsupported FourCC: %08x", header.ddspf.dwFourCC); return error;
+      default: RDCWARN("Unsupported FourCC: %08x", header.ddspf.dwFourCC); return false;
     }
   }
   else
@@ -964,7 +982,7 @@ dds_data load_dds_from_file(FILE *f)
        header.ddspf.dwRGBBitCount != 16 && header.ddspf.dwRGBBitCount != 8)
     {
       RDCWARN("Unsupported RGB bit count: %u", header.ddspf.dwRGBBitCount);
-      return error;
+      return false;
     }
 
     ret.format.compByteWidth = 1;
@@ -977,49 +995,47 @@ dds_data load_dds_from_file(FILE *f)
   }
 
   uint32_t bytesPerPixel = 1;
-  switch(ret.format.specialFormat)
-  {
-    case SpecialFormat::S8: bytesPerPixel = 1; break;
-    case SpecialFormat::R10G10B10A2:
-    case SpecialFormat::R9G9B9E5:
-    case SpecialFormat::R11G11B10:
-    case SpecialFormat::D24S8: bytesPerPixel = 4; break;
-    case SpecialFormat::R5G6B5:
-    case SpecialFormat::R5G5B5A1:
-    case SpecialFormat::R4G4B4A4: bytesPerPixel = 2; break;
-    case SpecialFormat::D32S8: bytesPerPixel = 8; break;
-    case SpecialFormat::D16S8:
-    case SpecialFormat::YUV:
-    case SpecialFormat::R4G4:
-      RDCERR("Unsupported file format %u", ret.format.specialFormat);
-      return error;
-    default: bytesPerPixel = ret.format.compCount * ret.format.compByteWidth;
-  }
-
   bool blockFormat = false;
 
-  if(ret.format.special)
+  return get_dds_layout(ret.format, bytesPerPixel, blockFormat);
+}
+
+bool read_dds_header(FILE *f, dds_data &data)
+{
+  dds_data empty = {};
+  data = empty;
+
+  FileIO::fseek64(f, 0, SEEK_SET);
+
+  uint32_t magic = 0;
+  DDS_HEADER header = {};
+
+  if(FileIO::fread(&magic, sizeof(magic), 1, f) != 1 || magic != dds_fourcc ||
+     FileIO::fread(&header, sizeof(header), 1, f) != 1)
+    return false;
+
+  bool dx10Header = false;
+  DDS_HEADER_DXT10 headerDXT10 = {};
+
+  if(header.ddspf.dwFlags == DDPF_FOURCC && header.ddspf.dwFourCC == MAKE_FOURCC('D', 'X', '1', '0'))
   {
-    switch(ret.format.specialFormat)
-    {
-      case SpecialFormat::BC1:
-      case SpecialFormat::BC2:
-      case SpecialFormat::BC3:
-      case SpecialFormat::BC4:
-      case SpecialFormat::BC5:
-      case SpecialFormat::BC6:
-      case SpecialFormat::BC7: blockFormat = true; break;
-      case SpecialFormat::ETC2:
-      case SpecialFormat::EAC:
-      case SpecialFormat::ASTC:
-      case SpecialFormat::YUV:
-        RDCERR("Unsupported file format, %u", ret.format.specialFormat);
-        return error;
-      default: break;
-    }
+    if(FileIO::fread(&headerDXT10, sizeof(headerDXT10), 1, f) != 1)
+      return false;
+    dx10Header = true;
   }
 
-  ret.subsizes = new uint32_t[ret.slices * ret.mips];
+  return parse_dds_header(header, dx10Header ? &headerDXT10 : NULL, data);
+}
+
+dds_data load_dds_from_file(FILE *f)
+{
+  dds_data ret = {};
+  dds_data error = {};
+
+  if(!read_dds_header(f, ret))
+    return error;
+
+  ret.subsizes = new uint64_t[ret.slices * ret.mips];
   ret.subdata = new byte *[ret.slices * ret.mips];
 
   int i = 0;
@@ -1027,38 +1043,79 @@ dds_data load_dds_from_file(FILE *f)
   {
     for(int mip = 0; mip < ret.mips; mip++)
     {
-      int rowlen = RDCMAX(1, ret.width >> mip);
-      int numRows = RDCMAX(1, ret.height >> mip);
-      int numdepths = RDCMAX(1, ret.depth >> mip);
-      int pitch = RDCMAX(1U, rowlen * bytesPerPixel);
+      ret.subsizes[i] = dds_subresource_size(ret, mip);
+      ret.subdata[i] = new byte[(size_t)ret.subsizes[i]];
 
-      // pitch/rows are in blocks, not pixels, for block formats.
-      if(blockFormat)
+      // subresources are contiguous in the file, so each one is a single read
+      if(FileIO::fread(ret.subdata[i], 1, (size_t)ret.subsizes[i], f) != ret.subsizes[i])
       {
-        numRows = RDCMAX(1, numRows / 4);
-
-        int blockSize = (ret.format.specialFormat == SpecialFormat::BC1 ||
-                         ret.format.specialFormat == SpecialFormat::BC4)
-                            ? 8
-                            : 16;
+        RDCWARN("DDS file is truncated");
 
-        pitch = RDCMAX(blockSize, (((rowlen + 3) / 4)) * blockSize);
+        for(int j = 0; j <= i; j++)
+          delete[] ret.subdata[j];
+        delete[] ret.subdata;
+        delete[] ret.subsizes;
+        return error;
       }
 
-      ret.subsizes[i] = numdepths * numRows * pitch;
+      i++;
+    }
+  }
 
-      byte *bytedata = ret.subdata[i] = new byte[ret.subsizes[i]];
+  return ret;
+}
 
-      for(int d = 0; d < numdepths; d++)
-      {
-        for(int row = 0; row < numRows; row++)
-        {
-          FileIO::fread(bytedata, 1, pitch, f);
+dds_data load_dds_from_memory(const byte *buffer, uint64_t size)
+{
+  dds_data ret = {};
+  dds_data error = {};
 
-          bytedata += pitch;
-        }
+  uint64_t offset = sizeof(uint32_t) + sizeof(DDS_HEADER);
+
+  if(buffer == NULL || size < offset || memcmp(buffer, &dds_fourcc, sizeof(uint32_t)) != 0)
+    return error;
+
+  DDS_HEADER header;
+  memcpy(&header, buffer + sizeof(uint32_t), sizeof(header));
+
+  bool dx10Header = false;
+  DDS_HEADER_DXT10 headerDXT10 = {};
+
+  if(header.ddspf.dwFlags == DDPF_FOURCC && header.ddspf.dwFourCC == MAKE_FOURCC('D', 'X', '1', '0'))
+  {
+    if(size < offset + sizeof(headerDXT10))
+      return error;
+
+    memcpy(&headerDXT10, buffer + offset, sizeof(headerDXT10));
+    offset += sizeof(headerDXT10);
+    dx10Header = true;
+  }
+
+  if(!parse_dds_header(header, dx10Header ? &headerDXT10 : NULL, ret))
+    return error;
+
+  ret.subsizes = new uint64_t[ret.slices * ret.mips];
+  ret.subdata = new byte *[ret.slices * ret.mips];
+
+  int i = 0;
+  for(int slice = 0; slice < ret.slices; slice++)
+  {
+    for(int mip = 0; mip < ret.mips; mip++)
+    {
+      ret.subsizes[i] = dds_subresource_size(ret, mip);
+
+      if(offset + ret.subsizes[i] > size)
+      {
+        RDCWARN("DDS file is truncated, expected at least %llu bytes but only have %llu",
+                offset + ret.subsizes[i], size);
+        delete[] ret.subdata;
+        delete[] ret.subsizes;
+        return error;
       }
 
+      ret.subdata[i] = (byte *)buffer + offset;
+      offset += ret.subsizes[i];
+
       i++;
     }
   }
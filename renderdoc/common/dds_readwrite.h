@@ -40,9 +40,25 @@ struct dds_data
   ResourceFormat format;
 
   byte **subdata;
-  uint32_t *subsizes;
+  uint64_t *subsizes;
 };
 
 extern bool is_dds_file(FILE *f);
 extern dds_data load_dds_from_file(FILE *f);
+// parses a DDS file that's already in memory, such as a mapped file. subdata points directly into
+// the buffer instead of being copied, so only the subdata and subsizes arrays should be freed.
+extern dds_data load_dds_from_memory(const byte *buffer, uint64_t size);
 extern bool write_dds_to_file(FILE *f, const dds_data &data);
+
+// streaming interface for textures too large to hold in memory at once. After the header, the
+// subresources follow contiguously - array slices in order, each with its mips in order, and all
+// depth slices of a mip tightly packed together. The caller reads or writes them with
+// FileIO::fread/fwrite in whatever size chunks it likes.
+
+// the size in bytes of one subresource, for all depth slices
+extern uint64_t dds_subresource_size(const dds_data &data, int mip);
+// reads the header into data, leaving subdata and subsizes NULL, and positions f at the first
+// subresource. Returns false if this isn't a supported DDS file.
+extern bool read_dds_header(FILE *f, dds_data &data);
+// writes the header for data, ignoring subdata and subsizes. The subresources must follow.
+extern bool write_dds_header(FILE *f, const dds_data &data);
@@ -0,0 +1,385 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "image_encode.h"
+#include <stdlib.h>
+#include <string.h>
+#include "common/threading.h"
+#include "jpeg-compressor/jpge.h"
+#include "os/os_specific.h"
+#include "tinyexr/tinyexr_miniz.h"
+
+// roughly how much filtered PNG data to deflate in each strip. Each strip starts with an empty
+// dictionary, so this is large enough that the lost matches at strip boundaries are negligible.
+static const uint32_t PNGStripBytes = 1024 * 1024;
+
+// roughly how many pixels to encode in each JPG strip.
+static const uint32_t JPGStripPixels = 256 * 1024;
+
+static void WriteBE32(std::vector<byte> &out, uint32_t val)
+{
+  byte bytes[4] = {byte(val >> 24), byte(val >> 16), byte(val >> 8), byte(val)};
+  out.insert(out.end(), bytes, bytes + 4);
+}
+
+static void WritePNGChunk(std::vector<byte> &out, const char *type, const byte *data, size_t len)
+{
+  size_t start = out.size();
+
+  WriteBE32(out, (uint32_t)len);
+  out.insert(out.end(), (const byte *)type, (const byte *)type + 4);
+  if(len > 0)
+    out.insert(out.end(), data, data + len);
+
+  // the CRC covers the type and data but not the length
+  WriteBE32(out, miniz_crc32(0, &out[start + 4], len + 4));
+}
+
+static int Paeth(int a, int b, int c)
+{
+  int p = a + b - c;
+  int pa = abs(p - a);
+  int pb = abs(p - b);
+  int pc = abs(p - c);
+
+  if(pa <= pb && pa <= pc)
+    return a;
+  if(pb <= pc)
+    return b;
+  return c;
+}
+
+// apply the given PNG filter type to a row. prev is NULL for the first row, which the spec
+// defines as filtering against a row of zeroes.
+static void FilterPNGRow(byte *out, const byte *row, const byte *prev, uint32_t rowBytes,
+                         uint32_t bpp, int filter)
+{
+  for(uint32_t i = 0; i < rowBytes; i++)
+  {
+    int a = i >= bpp ? row[i - bpp] : 0;
+    int b = prev ? prev[i] : 0;
+    int c = (prev && i >= bpp) ? prev[i - bpp] : 0;
+
+    switch(filter)
+    {
+      case 0: out[i] = row[i]; break;
+      case 1: out[i] = byte(row[i] - a); break;
+      case 2: out[i] = byte(row[i] - b); break;
+      case 3: out[i] = byte(row[i] - ((a + b) >> 1)); break;
+      case 4: out[i] = byte(row[i] - Paeth(a, b, c)); break;
+    }
+  }
+}
+
+// zlib's adler32_combine - the checksum of A followed by B from the checksums of each
+static uint32_t Adler32Combine(uint32_t adler1, uint32_t adler2, uint64_t len2)
+{
+  const uint32_t base = 65521;
+
+  uint32_t rem = uint32_t(len2 % base);
+  uint32_t sum1 = adler1 & 0xffff;
+  uint32_t sum2 = uint32_t((uint64_t(rem) * sum1) % base);
+  sum1 += (adler2 & 0xffff) + base - 1;
+  sum2 += ((adler1 >> 16) & 0xffff) + ((adler2 >> 16) & 0xffff) + base - rem;
+
+  if(sum1 >= base)
+    sum1 -= base;
+  if(sum1 >= base)
+    sum1 -= base;
+  if(sum2 >= (base << 1))
+    sum2 -= (base << 1);
+  if(sum2 >= base)
+    sum2 -= base;
+
+  return sum1 | (sum2 << 16);
+}
+
+bool write_png_to_file(FILE *f, uint32_t width, uint32_t height, uint32_t numComps,
+                       const byte *data, uint32_t rowPitch)
+{
+  if(width == 0 || height == 0 || numComps == 0 || numComps > 4)
+    return false;
+
+  const uint32_t rowBytes = width * numComps;
+  const uint32_t stripRows = RDCMAX(1U, PNGStripBytes / (rowBytes + 1));
+  const uint32_t numStrips = (height + stripRows - 1) / stripRows;
+
+  struct Strip
+  {
+    std::vector<byte> idat;
+    uint32_t adler;
+    uint64_t length;
+    bool success;
+  };
+
+  std::vector<Strip> strips(numStrips);
+
+  Threading::ParallelFor((int32_t)numStrips, [&](int32_t s) {
+    Strip &strip = strips[s];
+    strip.success = false;
+
+    uint32_t firstRow = s * stripRows;
+    uint32_t numRows = RDCMIN(stripRows, height - firstRow);
+
+    // filter each row with whichever filter gives the smallest sum of absolute signed values,
+    // the usual heuristic for picking filters that compress well.
+    std::vector<byte> filtered(size_t(rowBytes + 1) * numRows);
+    std::vector<byte> candidate(rowBytes);
+
+    for(uint32_t r = 0; r < numRows; r++)
+    {
+      uint32_t y = firstRow + r;
+      const byte *row = data + size_t(y) * rowPitch;
+      const byte *prev = y > 0 ? row - rowPitch : NULL;
+      byte *out = &filtered[size_t(rowBytes + 1) * r];
+
+      uint64_t bestScore = ~0ULL;
+      for(int filter = 0; filter < 5; filter++)
+      {
+        FilterPNGRow(&candidate[0], row, prev, rowBytes, numComps, filter);
+
+        uint64_t score = 0;
+        for(uint32_t i = 0; i < rowBytes; i++)
+          score += abs((int)(signed char)candidate[i]);
+
+        if(score < bestScore)
+        {
+          bestScore = score;
+          out[0] = byte(filter);
+          memcpy(out + 1, &candidate[0], rowBytes);
+        }
+      }
+    }
+
+    strip.length = filtered.size();
+    strip.adler = miniz_adler32(1, &filtered[0], filtered.size());
+
+    // every strip but the last ends with a sync flush rather than a final block, so the strips can
+    // be concatenated into one deflate stream. The first strip carries the zlib header.
+    std::vector<byte> compressed;
+    if(s == 0)
+    {
+      compressed.push_back(0x78);
+      compressed.push_back(0x9C);
+    }
+
+    bool last = (s + 1 == (int32_t)numStrips);
+
+    if(!miniz_deflate_raw(compressed, &filtered[0], filtered.size(), last))
+      return;
+
+    WritePNGChunk(strip.idat, "IDAT", &compressed[0], compressed.size());
+    strip.success = true;
+  });
+
+  std::vector<byte> header;
+
+  static const byte signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  header.insert(header.end(), signature, signature + sizeof(signature));
+
+  {
+    // greyscale, greyscale+alpha, RGB, RGBA
+    static const byte colourTypes[] = {0, 4, 2, 6};
+
+    std::vector<byte> ihdr;
+    WriteBE32(ihdr, width);
+    WriteBE32(ihdr, height);
+    ihdr.push_back(8);                         // bit depth
+    ihdr.push_back(colourTypes[numComps - 1]);
+    ihdr.push_back(0);                         // deflate compression
+    ihdr.push_back(0);                         // adaptive filtering
+    ihdr.push_back(0);                         // no interlace
+
+    WritePNGChunk(header, "IHDR", &ihdr[0], ihdr.size());
+  }
+
+  bool success = FileIO::fwrite(&header[0], 1, header.size(), f) == header.size();
+
+  uint32_t adler = strips[0].adler;
+
+  for(uint32_t s = 0; success && s < numStrips; s++)
+  {
+    if(!strips[s].success)
+    {
+      RDCERR("Failed to compress PNG strip %u of %u", s, numStrips);
+      return false;
+    }
+
+    if(s > 0)
+      adler = Adler32Combine(adler, strips[s].adler, strips[s].length);
+
+    success &= FileIO::fwrite(&strips[s].idat[0], 1, strips[s].idat.size(), f) ==
+               strips[s].idat.size();
+  }
+
+  // the zlib trailer goes in its own small IDAT so that every strip's chunk could be finished on
+  // its worker thread.
+  std::vector<byte> footer;
+  std::vector<byte> adlerBytes;
+  WriteBE32(adlerBytes, adler);
+  WritePNGChunk(footer, "IDAT", &adlerBytes[0], adlerBytes.size());
+  WritePNGChunk(footer, "IEND", NULL, 0);
+
+  success &= FileIO::fwrite(&footer[0], 1, footer.size(), f) == footer.size();
+
+  return success;
+}
+
+// locates the SOF0 and SOS markers in a JPG produced by jpge, and the start of the entropy-coded
+// data that follows the SOS header.
+static bool ParseJPGHeader(const std::vector<byte> &jpg, size_t &sofOffset, size_t &sosOffset,
+                           size_t &scanOffset)
+{
+  sofOffset = 0;
+
+  // skip SOI
+  size_t offs = 2;
+
+  while(offs + 4 <= jpg.size())
+  {
+    if(jpg[offs] != 0xFF)
+      return false;
+
+    byte marker = jpg[offs + 1];
+    size_t len = (size_t(jpg[offs + 2]) << 8) | size_t(jpg[offs + 3]);
+
+    if(marker == 0xC0)
+      sofOffset = offs;
+
+    if(marker == 0xDA)
+    {
+      sosOffset = offs;
+      scanOffset = offs + 2 + len;
+
+      // the scan data must be followed by EOI
+      return sofOffset != 0 && scanOffset + 2 <= jpg.size() && jpg[jpg.size() - 2] == 0xFF &&
+             jpg[jpg.size() - 1] == 0xD9;
+    }
+
+    offs += 2 + len;
+  }
+
+  return false;
+}
+
+bool write_jpg_to_file(FILE *f, uint32_t width, uint32_t height, uint32_t numComps,
+                       const byte *data, int quality)
+{
+  if(width == 0 || height == 0 || width > 0xffff || height > 0xffff)
+    return false;
+
+  jpge::params p;
+  p.m_quality = quality;
+
+  // jpge's default H2V2 chroma subsampling uses 16x16 MCUs. Huffman tables must be the same in
+  // every strip, so the optimised two-pass mode can't be used.
+  RDCASSERT(p.m_subsampling == jpge::H2V2 && !p.m_two_pass_flag);
+  const uint32_t mcuSize = 16;
+
+  uint32_t mcusPerRow = (width + mcuSize - 1) / mcuSize;
+  uint32_t mcuRows = (height + mcuSize - 1) / mcuSize;
+
+  // the restart interval is a 16-bit count of MCUs
+  uint32_t stripMcuRows = RDCMAX(1U, JPGStripPixels / (width * mcuSize));
+  stripMcuRows = RDCMIN(stripMcuRows, 0xffff / mcusPerRow);
+
+  uint32_t numStrips = (mcuRows + stripMcuRows - 1) / stripMcuRows;
+
+  std::vector<std::vector<byte> > strips(numStrips);
+
+  Threading::ParallelFor((int32_t)numStrips, [&](int32_t s) {
+    uint32_t y = s * stripMcuRows * mcuSize;
+    uint32_t h = RDCMIN(stripMcuRows * mcuSize, height - y);
+
+    // the whole raw strip plus room for the headers is always enough
+    int len = int(width * h * numComps) + 4096;
+
+    strips[s].resize(len);
+
+    const byte *src = data + size_t(y) * width * numComps;
+
+    if(!jpge::compress_image_to_jpeg_file_in_memory(&strips[s][0], len, (int)width, (int)h,
+                                                    (int)numComps, src, p))
+      len = 0;
+
+    strips[s].resize(len);
+  });
+
+  for(uint32_t s = 0; s < numStrips; s++)
+  {
+    if(strips[s].empty())
+    {
+      RDCERR("jpge::compress_image_to_jpeg_file_in_memory failed on strip %u of %u", s, numStrips);
+      return false;
+    }
+  }
+
+  // a single strip is already a complete file
+  if(numStrips == 1)
+    return FileIO::fwrite(&strips[0][0], 1, strips[0].size(), f) == strips[0].size();
+
+  size_t sofOffset = 0, sosOffset = 0, scanOffset = 0;
+  if(!ParseJPGHeader(strips[0], sofOffset, sosOffset, scanOffset))
+  {
+    RDCERR("Unexpected JPG structure from jpge");
+    return false;
+  }
+
+  // headers up to the SOS marker come from the first strip, with the height fixed up to the full
+  // image, then a DRI marker giving the restart interval.
+  std::vector<byte> out(strips[0].begin(), strips[0].begin() + sosOffset);
+
+  out[sofOffset + 5] = byte(height >> 8);
+  out[sofOffset + 6] = byte(height & 0xff);
+
+  uint32_t interval = mcusPerRow * stripMcuRows;
+  const byte dri[] = {0xFF, 0xDD, 0x00, 0x04, byte(interval >> 8), byte(interval & 0xff)};
+  out.insert(out.end(), dri, dri + sizeof(dri));
+
+  out.insert(out.end(), strips[0].begin() + sosOffset, strips[0].begin() + scanOffset);
+
+  for(uint32_t s = 0; s < numStrips; s++)
+  {
+    size_t stripSof = 0, stripSos = 0, stripScan = 0;
+    if(!ParseJPGHeader(strips[s], stripSof, stripSos, stripScan))
+    {
+      RDCERR("Unexpected JPG structure from jpge");
+      return false;
+    }
+
+    // RST0 to RST7 in sequence between each interval
+    if(s > 0)
+    {
+      out.push_back(0xFF);
+      out.push_back(byte(0xD0 + ((s - 1) & 0x7)));
+    }
+
+    out.insert(out.end(), strips[s].begin() + stripScan, strips[s].end() - 2);
+  }
+
+  out.push_back(0xFF);
+  out.push_back(0xD9);
+
+  return FileIO::fwrite(&out[0], 1, out.size(), f) == out.size();
+}
@@ -0,0 +1,42 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#pragma once
+
+#include <stdio.h>
+#include "common/common.h"
+
+// these encode large 8-bit images by splitting them into horizontal strips that are compressed on
+// separate threads, then stitching the results into one standard file. The output only depends on
+// the image and parameters, not on how many threads were used.
+
+// PNG: each strip of filtered rows is deflated independently and ended with a sync flush, so the
+// strips concatenate into a single zlib stream.
+extern bool write_png_to_file(FILE *f, uint32_t width, uint32_t height, uint32_t numComps,
+                              const byte *data, uint32_t rowPitch);
+
+// JPG: each strip of MCU rows is encoded independently, and the strips are joined with restart
+// markers so a decoder resets its DC prediction exactly where each strip's encoder started.
+extern bool write_jpg_to_file(FILE *f, uint32_t width, uint32_t height, uint32_t numComps,
+                              const byte *data, int quality);
@@ -0,0 +1,218 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "shader_cache.h"
+#include <algorithm>
+#include "api/replay/version.h"
+#include "common/common.h"
+#include "common/threading.h"
+
+namespace ShaderAnalysisCache
+{
+// bump this if the on-disk entry format changes
+static const uint32_t CacheMagic = MAKE_FOURCC('R', 'D', 'S', 'A');
+static const uint32_t CacheVersion = 1;
+
+// total size we allow the cache folder to grow to. When we go over, we evict down to the low
+// watermark so that we don't rescan the folder on every store.
+static const uint64_t CacheMaxSize = 256ULL * 1024 * 1024;
+static const uint64_t CacheLowWatermark = CacheMaxSize - CacheMaxSize / 4;
+
+// temporary files older than this are assumed to be left over from a process that crashed part way
+// through a store. Younger ones may still be being written, so they're left alone.
+static const uint64_t StaleTempAge = 60 * 60;
+
+struct EntryHeader
+{
+  uint32_t magic;
+  uint32_t version;
+  uint64_t key;
+  uint64_t length;
+  uint64_t payloadHash;
+};
+
+static Threading::CriticalSection cacheLock;
+
+// running estimate of the folder size - initialised from a scan on first store, then updated
+// with our own writes. Other processes writing concurrently will be picked up on the next scan.
+static uint64_t cacheSizeEstimate = ~0ULL;
+
+static string GetCacheFolder()
+{
+  return FileIO::GetAppFolderFilename("shaderanalysis");
+}
+
+static string GetEntryFilename(uint64_t key)
+{
+  return GetCacheFolder() + StringFormat::Fmt("/%016llx.bin", key);
+}
+
+uint64_t MakeKey(const void *data, size_t len, uint64_t seed)
+{
+  // mix in the version and commit so that any build change invalidates all results
+  static const char buildVersion[] = FULL_VERSION_STRING "-" GIT_COMMIT_HASH;
+  seed = Hash64(buildVersion, sizeof(buildVersion), seed ^ CacheVersion);
+
+  return Hash64(data, len, seed);
+}
+
+bool Fetch(uint64_t key, std::vector<byte> &blob)
+{
+  string filename = GetEntryFilename(key);
+
+  std::vector<byte> contents;
+  if(!FileIO::slurp(filename.c_str(), contents))
+    return false;
+
+  EntryHeader header;
+
+  if(contents.size() < sizeof(header))
+  {
+    RDCWARN("Truncated shader analysis cache entry %016llx", key);
+    FileIO::Delete(filename.c_str());
+    return false;
+  }
+
+  memcpy(&header, &contents[0], sizeof(header));
+
+  const byte *payload = &contents[0] + sizeof(header);
+
+  if(header.magic != CacheMagic || header.version != CacheVersion || header.key != key ||
+     header.length != contents.size() - sizeof(header) ||
+     header.payloadHash != Hash64(payload, (size_t)header.length))
+  {
+    RDCWARN("Invalid shader analysis cache entry %016llx", key);
+    FileIO::Delete(filename.c_str());
+    return false;
+  }
+
+  blob.assign(payload, payload + (size_t)header.length);
+
+  // bump the timestamp so this entry is considered most recently used
+  FileIO::Touch(filename.c_str());
+
+  return true;
+}
+
+static void EvictEntries()
+{
+  string folder = GetCacheFolder();
+
+  std::vector<PathEntry> entries = FileIO::GetFilesInDirectory(folder.c_str());
+
+  uint64_t totalSize = 0;
+  uint64_t now = Timing::GetUnixTimestamp();
+
+  for(auto it = entries.begin(); it != entries.end();)
+  {
+    if(it->flags & (PathProperty::Directory | PathProperty::ErrorUnknown |
+                    PathProperty::ErrorAccessDenied | PathProperty::ErrorInvalidPath))
+    {
+      it = entries.erase(it);
+      continue;
+    }
+
+    string filename = it->filename.c_str();
+
+    // only completed entries are counted and evicted. Another process could be about to rename
+    // its temporary file into place, so those are only removed once they're clearly abandoned.
+    if(filename.size() < 4 || filename.compare(filename.size() - 4, 4, ".bin") != 0)
+    {
+      if(filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".tmp") == 0 &&
+         now > it->lastmod + StaleTempAge)
+        FileIO::Delete((folder + "/" + filename).c_str());
+
+      it = entries.erase(it);
+      continue;
+    }
+
+    totalSize += it->size;
+    ++it;
+  }
+
+  if(totalSize > CacheMaxSize)
+  {
+    std::sort(entries.begin(), entries.end(),
+              [](const PathEntry &a, const PathEntry &b) { return a.lastmod < b.lastmod; });
+
+    for(size_t i = 0; i < entries.size() && totalSize > CacheLowWatermark; i++)
+    {
+      string path = folder + "/" + entries[i].filename.c_str();
+      FileIO::Delete(path.c_str());
+      totalSize -= entries[i].size;
+    }
+
+    RDCDEBUG("Evicted shader analysis cache down to %llu bytes", totalSize);
+  }
+
+  cacheSizeEstimate = totalSize;
+}
+
+void Store(uint64_t key, const byte *data, size_t len)
+{
+  string filename = GetEntryFilename(key);
+
+  FileIO::CreateParentDirectory(filename);
+
+  EntryHeader header;
+  header.magic = CacheMagic;
+  header.version = CacheVersion;
+  header.key = key;
+  header.length = len;
+  header.payloadHash = Hash64(data, len);
+
+  // write to a file unique to this process and thread and then move it into place, so that
+  // concurrent readers never see a partially written entry.
+  string tempname = filename + StringFormat::Fmt(".%u.%llu.tmp", Process::GetCurrentPID(),
+                                                 Threading::GetCurrentID());
+
+  FILE *f = FileIO::fopen(tempname.c_str(), "wb");
+
+  if(!f)
+  {
+    RDCWARN("Couldn't open shader analysis cache entry for write: %s", tempname.c_str());
+    return;
+  }
+
+  bool success = FileIO::fwrite(&header, 1, sizeof(header), f) == sizeof(header);
+  success &= FileIO::fwrite(data, 1, len, f) == len;
+
+  FileIO::fclose(f);
+
+  if(!success || !FileIO::Move(tempname.c_str(), filename.c_str()))
+  {
+    RDCWARN("Couldn't write shader analysis cache entry %016llx", key);
+    FileIO::Delete(tempname.c_str());
+    return;
+  }
+
+  SCOPED_LOCK(cacheLock);
+
+  if(cacheSizeEstimate != ~0ULL)
+    cacheSizeEstimate += sizeof(header) + len;
+
+  if(cacheSizeEstimate == ~0ULL || cacheSizeEstimate > CacheMaxSize)
+    EvictEntries();
+}
+};
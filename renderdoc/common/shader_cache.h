@@ -172,3 +172,17 @@ void SaveShaderCache(const char *filename, uint32_t magicNumber, uint32_t versio
 
   RDCDEBUG("Successfully wrote %u shaders to shader cache", numentries);
 }
+
+// Persistent cache of shader analysis results (reflection, disassembly) shared between captures
+// and between concurrently running replay processes. Each entry is a separate file in the
+// application folder named by a 64-bit key, which callers derive from the shader contents with
+// ShaderAnalysisCache::MakeKey - this mixes in the build version so that results computed by a
+// different build are never returned. Total disk usage is bounded and the least recently used
+// entries are evicted first.
+namespace ShaderAnalysisCache
+{
+uint64_t MakeKey(const void *data, size_t len, uint64_t seed);
+
+bool Fetch(uint64_t key, std::vector<byte> &blob);
+void Store(uint64_t key, const byte *data, size_t len);
+};
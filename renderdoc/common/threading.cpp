@@ -0,0 +1,68 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "threading.h"
+#include <thread>
+#include <vector>
+#include "common/common.h"
+
+struct ParallelForData
+{
+  const std::function<void(int32_t)> *func;
+  int32_t count;
+  volatile int32_t next;
+};
+
+static void ParallelForWorker(void *param)
+{
+  ParallelForData *data = (ParallelForData *)param;
+
+  for(int32_t i = Atomic::Inc32(&data->next) - 1; i < data->count;
+      i = Atomic::Inc32(&data->next) - 1)
+    (*data->func)(i);
+}
+
+void Threading::ParallelFor(int32_t count, const std::function<void(int32_t)> &func,
+                            uint32_t maxThreads)
+{
+  if(count <= 0)
+    return;
+
+  if(maxThreads == 0)
+    maxThreads = RDCMAX(1U, std::thread::hardware_concurrency());
+
+  ParallelForData data = {&func, count, 0};
+
+  std::vector<ThreadHandle> threads;
+  for(uint32_t i = 1; i < maxThreads && i < (uint32_t)count; i++)
+    threads.push_back(CreateThread(&ParallelForWorker, &data));
+
+  ParallelForWorker(&data);
+
+  for(ThreadHandle t : threads)
+  {
+    JoinThread(t);
+    CloseThread(t);
+  }
+}
@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include <functional>
 #include "os/os_specific.h"
 
 namespace Threading
@@ -53,6 +54,31 @@ private:
   CriticalSection *m_CS;
   bool m_Owned;
 };
+
+class ScopedReadLock
+{
+public:
+  ScopedReadLock(RWLock &rw) : m_RW(&rw) { m_RW->ReadLock(); }
+  ~ScopedReadLock() { m_RW->ReadUnlock(); }
+private:
+  RWLock *m_RW;
+};
+
+class ScopedWriteLock
+{
+public:
+  ScopedWriteLock(RWLock &rw) : m_RW(&rw) { m_RW->WriteLock(); }
+  ~ScopedWriteLock() { m_RW->WriteUnlock(); }
+private:
+  RWLock *m_RW;
+};
+
+// calls func(i) for every i in [0, count), spread across up to maxThreads threads - or one per
+// CPU core if maxThreads is 0. The calling thread takes indices too, and this only returns once
+// all of them have been processed. func must be safe to call concurrently for different indices.
+void ParallelFor(int32_t count, const std::function<void(int32_t)> &func, uint32_t maxThreads = 0);
 };
 
 #define SCOPED_LOCK(cs) Threading::ScopedLock CONCAT(scopedlock, __LINE__)(cs);
+#define SCOPED_READLOCK(rw) Threading::ScopedReadLock CONCAT(scopedreadlock, __LINE__)(rw);
+#define SCOPED_WRITELOCK(rw) Threading::ScopedWriteLock CONCAT(scopedwritelock, __LINE__)(rw);
@@ -908,6 +908,124 @@ void RenderDoc::RegisterRemoteProvider(RDCDriver driver, const char *name,
   m_RemoteDriverProviders[driver] = provider;
 }
 
+void RenderDoc::RegisterChunkCategoriser(RDCDriver driver, ChunkNameLookup names,
+                                         ChunkCategoriser categoriser)
+{
+  m_ChunkCategorisers[driver] = std::make_pair(names, categoriser);
+}
+
+ReplayStatus RenderDoc::GetCaptureStatistics(const char *logfile, CaptureStatistics &stats)
+{
+  RDCDriver driverType = RDC_Unknown;
+  string driverName;
+  uint64_t fileMachineIdent = 0;
+  ReplayStatus status = FillInitParams(logfile, driverType, driverName, fileMachineIdent, NULL);
+
+  if(status != ReplayStatus::Succeeded)
+    return status;
+
+  auto it = m_ChunkCategorisers.find(driverType);
+
+  if(it == m_ChunkCategorisers.end())
+  {
+    RDCERR("No chunk categoriser registered for %s", driverName.c_str());
+    return ReplayStatus::APIUnsupported;
+  }
+
+  ChunkNameLookup names = it->second.first;
+  ChunkCategoriser categorise = it->second.second;
+
+  Serialiser ser(logfile, Serialiser::READING, false);
+
+  if(ser.HasError())
+    return ReplayStatus::FileIOFailed;
+
+  stats = CaptureStatistics();
+  stats.compressedFileSize = ser.GetFileSize();
+  stats.uncompressedFileSize = ser.GetSize();
+
+  map<uint32_t, ChunkStatistics> chunks;
+  map<string, ResourceTypeStatistics> resources;
+  bool inFrame = false;
+
+  // a single pass over the top-level chunks, skipping their contents. Nothing is replayed so this
+  // doesn't need a GPU or even a local replay driver for the API.
+  ser.Rewind();
+
+  while(!ser.AtEnd() && !ser.HasError())
+  {
+    uint64_t offset = ser.GetOffset();
+
+    uint32_t chunkType = ser.PushContext(NULL, NULL, 1, false);
+    ser.SkipCurrentChunk();
+    ser.PopContext(1);
+
+    uint64_t size = ser.GetOffset() - offset;
+
+    const char *resourceType = NULL;
+    ChunkCategory category = categorise(chunkType, resourceType);
+
+    if(category == ChunkCategory::CaptureScope)
+      inFrame = true;
+
+    ChunkStatistics &chunk = chunks[chunkType];
+    chunk.count++;
+    chunk.totalBytes += size;
+
+    if(chunkType == INITIAL_CONTENTS)
+      stats.initialContentsBytes += size;
+
+    if(resourceType)
+    {
+      ResourceTypeStatistics &res = resources[resourceType];
+      if(category == ChunkCategory::Resource)
+        res.count++;
+      res.bytes += size;
+    }
+
+    if(!inFrame)
+      continue;
+
+    chunk.frameCount++;
+    stats.frameBytes += size;
+
+    switch(category)
+    {
+      case ChunkCategory::Drawcall: stats.drawcalls++; break;
+      case ChunkCategory::Dispatch: stats.dispatches++; break;
+      case ChunkCategory::Clear: stats.clears++; break;
+      case ChunkCategory::Copy: stats.copies++; break;
+      case ChunkCategory::Upload:
+        stats.uploads++;
+        stats.uploadBytes += size;
+        break;
+      default: break;
+    }
+  }
+
+  if(ser.HasError())
+    return ReplayStatus::FileCorrupted;
+
+  stats.chunks.create((int)chunks.size());
+  int i = 0;
+  for(auto c = chunks.begin(); c != chunks.end(); ++c, ++i)
+  {
+    stats.chunks[i] = c->second;
+    stats.chunks[i].chunkID = c->first;
+    stats.chunks[i].name = names(c->first);
+  }
+
+  stats.resources.create((int)resources.size());
+  i = 0;
+  for(auto r = resources.begin(); r != resources.end(); ++r, ++i)
+  {
+    stats.resources[i] = r->second;
+    stats.resources[i].type = r->first;
+  }
+
+  return ReplayStatus::Succeeded;
+}
+
 ReplayStatus RenderDoc::CreateReplayDriver(RDCDriver driverType, const char *logfile,
                                            IReplayDriver **driver)
 {
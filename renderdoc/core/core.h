@@ -186,6 +186,25 @@ typedef void (*VulkanLayerInstall)(bool systemLevel);
 
 typedef void (*ShutdownFunction)();
 
+// coarse categories for a driver's chunk types, used to compute capture statistics without
+// needing to replay.
+enum class ChunkCategory
+{
+  Other,
+  CaptureScope,
+  Drawcall,
+  Dispatch,
+  Clear,
+  Copy,
+  Upload,
+  Resource,
+};
+
+// resourceType must be set to a string literal for ChunkCategory::Resource chunks, and may be set
+// for any other chunk to attribute its bytes to that type of resource.
+typedef ChunkCategory (*ChunkCategoriser)(uint32_t chunkType, const char *&resourceType);
+typedef const char *(*ChunkNameLookup)(uint32_t chunkType);
+
 // this class mediates everything and owns any 'global' resources such as the crash handler.
 //
 // It acts as a central hub that registers any driver providers and can be asked to create one
@@ -255,6 +274,10 @@ public:
 
   void RegisterReplayProvider(RDCDriver driver, const char *name, ReplayDriverProvider provider);
   void RegisterRemoteProvider(RDCDriver driver, const char *name, RemoteDriverProvider provider);
+  void RegisterChunkCategoriser(RDCDriver driver, ChunkNameLookup names,
+                                ChunkCategoriser categoriser);
+
+  ReplayStatus GetCaptureStatistics(const char *logfile, CaptureStatistics &stats);
 
   void SetVulkanLayerCheck(VulkanLayerCheck callback) { m_VulkanCheck = callback; }
   void SetVulkanLayerInstall(VulkanLayerInstall callback) { m_VulkanInstall = callback; }
@@ -387,6 +410,7 @@ private:
   map<RDCDriver, string> m_DriverNames;
   map<RDCDriver, ReplayDriverProvider> m_ReplayDriverProviders;
   map<RDCDriver, RemoteDriverProvider> m_RemoteDriverProviders;
+  map<RDCDriver, pair<ChunkNameLookup, ChunkCategoriser> > m_ChunkCategorisers;
 
   VulkanLayerCheck m_VulkanCheck;
   VulkanLayerInstall m_VulkanInstall;
@@ -456,4 +480,8 @@ struct DriverRegistration
   {
     RenderDoc::Inst().RegisterRemoteProvider(driver, name, provider);
   }
+  DriverRegistration(RDCDriver driver, ChunkNameLookup names, ChunkCategoriser categoriser)
+  {
+    RenderDoc::Inst().RegisterChunkCategoriser(driver, names, categoriser);
+  }
 };
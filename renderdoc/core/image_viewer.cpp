@@ -22,7 +22,10 @@
  * THE SOFTWARE.
  ******************************************************************************/
 
+#include <limits.h>
+#include <string.h>
 #include "common/dds_readwrite.h"
+#include "common/threading.h"
 #include "core/core.h"
 #include "replay/replay_driver.h"
 #include "replay/type_helpers.h"
@@ -33,7 +36,7 @@ class ImageViewer : public IReplayDriver
 {
 public:
   ImageViewer(IReplayDriver *proxy, const char *filename)
-      : m_Proxy(proxy), m_Filename(filename), m_TextureID()
+      : m_Proxy(proxy), m_Filename(filename), m_TextureID(), m_FileHash(0)
   {
     if(m_Proxy == NULL)
       RDCERR("Unexpectedly NULL proxy at creation of ImageViewer");
@@ -53,14 +56,29 @@ public:
     d.eventID = 1;
     d.name = filename;
 
-    RefreshFile();
+    // the first load is synchronous so that the texture exists as soon as we're created
+    LoadedImage img;
+    if(LoadFile(img, true))
+      UploadImage(img);
 
     create_array_uninit(m_PipelineState.m_OM.RenderTargets, 1);
     m_PipelineState.m_OM.RenderTargets[0].Resource = m_TextureID;
+
+    m_Pending = NULL;
+    m_WatcherShutdown = 0;
+    m_WatcherThread = Threading::CreateThread(WatcherThreadEntry, this);
   }
 
   virtual ~ImageViewer()
   {
+    Atomic::Inc32(&m_WatcherShutdown);
+    Threading::JoinThread(m_WatcherThread);
+    Threading::CloseThread(m_WatcherThread);
+
+    if(m_Pending)
+      ReleaseImage(*m_Pending);
+    delete m_Pending;
+
     m_Proxy->Shutdown();
     m_Proxy = NULL;
   }
@@ -112,6 +130,8 @@ public:
   }
   bool RenderTexture(TextureDisplay cfg)
   {
+    ApplyPendingImage();
+
     cfg.texid = m_TextureID;
     return m_Proxy->RenderTexture(cfg);
   }
@@ -166,7 +186,11 @@ public:
   VKPipe::State GetVulkanPipelineState() { return VKPipe::State(); }
   void ReplayLog(uint32_t endEventID, ReplayLogType replayType) {}
   vector<uint32_t> GetPassEvents(uint32_t eventID) { return vector<uint32_t>(); }
-  vector<EventUsage> GetUsage(ResourceId id) { return vector<EventUsage>(); }
+  vector<EventUsage> GetUsage(ResourceId id, uint32_t minEventID, uint32_t maxEventID,
+                              uint64_t usageMask)
+  {
+    return vector<EventUsage>();
+  }
   bool IsRenderOutput(ResourceId id) { return false; }
   ResourceId GetLiveID(ResourceId id) { return id; }
   vector<GPUCounter> EnumerateCounters() { return vector<GPUCounter>(); }
@@ -259,9 +283,40 @@ public:
     RDCERR("Calling proxy-render functions on an image viewer");
   }
 
-  void FileChanged() { RefreshFile(); }
+  void FileChanged();
+  bool HasFileChanged()
+  {
+    SCOPED_LOCK(m_PendingLock);
+    return m_Pending != NULL;
+  }
+
 private:
-  void RefreshFile();
+  // a decoded image, ready to be uploaded to the proxy texture
+  struct LoadedImage
+  {
+    LoadedImage() : decoded(NULL), mapped(NULL), mappedSize(0) {}
+    TextureDescription texDetails;
+    // one entry per subresource, array slice major
+    std::vector<byte *> subdata;
+    std::vector<size_t> subsizes;
+    // pixel data we decoded ourselves, freed once uploaded
+    byte *decoded;
+    // DDS subresources aren't decoded, and point straight into the file data until uploaded. That
+    // is a mapping of the file for synchronous loads, which upload immediately. The watcher thread
+    // reads the file into contents instead, since it could be truncated before the upload.
+    std::vector<byte> contents;
+    const byte *mapped;
+    uint64_t mappedSize;
+  };
+
+  bool LoadFile(LoadedImage &img, bool mapFile);
+  bool DecodeImage(const byte *buf, uint64_t size, LoadedImage &img);
+  void UploadImage(LoadedImage &img);
+  static void ReleaseImage(LoadedImage &img);
+  void ApplyPendingImage();
+
+  static void WatcherThreadEntry(void *param) { ((ImageViewer *)param)->WatcherThread(); }
+  void WatcherThread();
 
   APIProperties m_Props;
   FrameRecord m_FrameRecord;
@@ -270,6 +325,20 @@ private:
   string m_Filename;
   ResourceId m_TextureID;
   TextureDescription m_TexDetails;
+
+  // hash of the file contents that were last decoded, to skip reloads when nothing changed
+  uint64_t m_FileHash;
+  // held while loading so the watcher thread and FileChanged() don't decode at the same time
+  Threading::CriticalSection m_LoadLock;
+
+  // the newest image decoded on the watcher thread that hasn't been uploaded yet. Uploads must
+  // happen on the replay thread, so this is picked up by FileChanged() or the next render. The UI
+  // polls HasFileChanged() to know when to call FileChanged() and refresh.
+  Threading::CriticalSection m_PendingLock;
+  LoadedImage *m_Pending;
+
+  Threading::ThreadHandle m_WatcherThread;
+  volatile int32_t m_WatcherShutdown;
 };
 
 ReplayStatus IMG_CreateReplayDevice(const char *logfile, IReplayDriver **driver)
@@ -329,21 +398,28 @@ ReplayStatus IMG_CreateReplayDevice(const char *logfile, IReplayDriver **driver)
   }
   else if(is_dds_file(f))
   {
-    FileIO::fseek64(f, 0, SEEK_SET);
-    dds_data read_data = load_dds_from_file(f);
+    // only the header and file size need to be checked, rather than reading what could be a very
+    // large texture.
+    dds_data header;
+    bool valid = read_dds_header(f, header);
 
-    if(read_data.subdata == NULL)
+    if(valid)
+    {
+      uint64_t expectedSize = FileIO::ftell64(f);
+      for(int slice = 0; slice < header.slices; slice++)
+        for(int mip = 0; mip < header.mips; mip++)
+          expectedSize += dds_subresource_size(header, mip);
+
+      FileIO::fseek64(f, 0, SEEK_END);
+      valid = FileIO::ftell64(f) >= expectedSize;
+    }
+
+    if(!valid)
     {
       FileIO::fclose(f);
       RDCERR("DDS file recognised, but couldn't load");
       return ReplayStatus::ImageUnsupported;
     }
-
-    for(int i = 0; i < read_data.slices * read_data.mips; i++)
-      delete[] read_data.subdata[i];
-
-    delete[] read_data.subdata;
-    delete[] read_data.subsizes;
   }
   else
   {
@@ -388,25 +464,188 @@ ReplayStatus IMG_CreateReplayDevice(const char *logfile, IReplayDriver **driver)
   return ReplayStatus::Succeeded;
 }
 
-void ImageViewer::RefreshFile()
+void ImageViewer::FileChanged()
+{
+  LoadedImage img;
+  bool loaded = false;
+
+  {
+    SCOPED_LOCK(m_LoadLock);
+    loaded = LoadFile(img, true);
+
+    // anything the watcher decoded earlier is now out of date
+    if(loaded)
+    {
+      SCOPED_LOCK(m_PendingLock);
+      if(m_Pending)
+        ReleaseImage(*m_Pending);
+      SAFE_DELETE(m_Pending);
+    }
+  }
+
+  if(loaded)
+    UploadImage(img);
+  else
+    ApplyPendingImage();
+}
+
+void ImageViewer::ApplyPendingImage()
 {
-  FILE *f = NULL;
+  LoadedImage *img = NULL;
+
+  {
+    SCOPED_LOCK(m_PendingLock);
+    img = m_Pending;
+    m_Pending = NULL;
+  }
 
-  for(int attempt = 0; attempt < 10 && f == NULL; attempt++)
+  if(img)
   {
-    f = FileIO::fopen(m_Filename.c_str(), "rb");
-    if(f)
+    UploadImage(*img);
+    delete img;
+  }
+}
+
+void ImageViewer::WatcherThread()
+{
+  FileIO::FileWatch *watch = FileIO::WatchFile(m_Filename.c_str());
+  uint64_t timestamp = FileIO::GetModifiedTimestamp(m_Filename);
+
+  while(Atomic::CmpExch32(&m_WatcherShutdown, 0, 0) == 0)
+  {
+    bool changed = false;
+
+    if(watch)
+    {
+      changed = FileIO::WaitForFileChange(watch, 100);
+
+      // wait for a burst of writes to settle down before reading the file
+      while(changed && FileIO::WaitForFileChange(watch, 100) &&
+            Atomic::CmpExch32(&m_WatcherShutdown, 0, 0) == 0)
+      {
+      }
+    }
+    else
+    {
+      Threading::Sleep(250);
+
+      uint64_t newTimestamp = FileIO::GetModifiedTimestamp(m_Filename);
+      changed = (newTimestamp != timestamp);
+      timestamp = newTimestamp;
+    }
+
+    if(!changed)
+      continue;
+
+    LoadedImage *img = new LoadedImage;
+
+    SCOPED_LOCK(m_LoadLock);
+
+    // the image is uploaded later on the replay thread, and the file can be truncated or rewritten
+    // in the meantime, so it's read into memory rather than mapped
+    if(!LoadFile(*img, false))
+    {
+      delete img;
+      continue;
+    }
+
+    SCOPED_LOCK(m_PendingLock);
+    if(m_Pending)
+    {
+      ReleaseImage(*m_Pending);
+      delete m_Pending;
+    }
+    m_Pending = img;
+  }
+
+  FileIO::UnwatchFile(watch);
+}
+
+static bool ReadFileContents(const string &filename, std::vector<byte> &contents)
+{
+  FILE *f = FileIO::fopen(filename.c_str(), "rb");
+
+  if(!f)
+    return false;
+
+  FileIO::fseek64(f, 0, SEEK_END);
+  uint64_t size = FileIO::ftell64(f);
+  FileIO::fseek64(f, 0, SEEK_SET);
+
+  // if the file is truncated while we read it we only get part of it. That fails to decode, and
+  // we'll be notified again once the write has finished.
+  contents.resize((size_t)size);
+  if(!contents.empty())
+    contents.resize(FileIO::fread(&contents[0], 1, contents.size(), f));
+
+  FileIO::fclose(f);
+
+  return !contents.empty();
+}
+
+bool ImageViewer::LoadFile(LoadedImage &img, bool mapFile)
+{
+  const byte *buf = NULL;
+  uint64_t size = 0;
+
+  for(int attempt = 0; attempt < 10 && buf == NULL; attempt++)
+  {
+    if(mapFile)
+    {
+      buf = FileIO::MapFile(m_Filename.c_str(), size);
+    }
+    else if(ReadFileContents(m_Filename, img.contents))
+    {
+      buf = &img.contents[0];
+      size = img.contents.size();
+    }
+
+    if(buf)
       break;
     Threading::Sleep(40);
   }
 
-  if(!f)
+  if(!buf)
   {
     RDCERR("Couldn't open %s! Exclusive lock elsewhere?", m_Filename.c_str());
-    return;
+    return false;
+  }
+
+  // saving without changes, or a change notification for a different file, doesn't need a reload
+  uint64_t hash = Hash64(buf, (size_t)size);
+
+  bool success = (hash != m_FileHash) && DecodeImage(buf, size, img);
+
+  // if decoding failed, e.g. the file is still being written, leave the hash so we try again
+  if(success)
+    m_FileHash = hash;
+  else
+    ReleaseImage(img);
+
+  // anything we decoded ourselves has its own copy, but DDS subresources point into the file data
+  // so it must be kept until they're uploaded
+  bool keepData = success && img.decoded == NULL;
+
+  if(mapFile && keepData)
+  {
+    img.mapped = buf;
+    img.mappedSize = size;
+  }
+  else if(mapFile)
+  {
+    FileIO::UnmapFile(buf, size);
+  }
+  else if(!keepData)
+  {
+    std::vector<byte>().swap(img.contents);
   }
 
-  TextureDescription texDetails;
+  return success;
+}
+
+bool ImageViewer::DecodeImage(const byte *buf, uint64_t size, LoadedImage &img)
+{
+  TextureDescription &texDetails = img.texDetails;
 
   ResourceFormat rgba8_unorm;
   rgba8_unorm.compByteWidth = 1;
@@ -422,7 +661,6 @@ void ImageViewer::RefreshFile()
   texDetails.cubemap = false;
   texDetails.customName = true;
   texDetails.name = m_Filename;
-  texDetails.ID = m_TextureID;
   texDetails.byteSize = 0;
   texDetails.msQual = 0;
   texDetails.msSamp = 1;
@@ -436,50 +674,85 @@ void ImageViewer::RefreshFile()
   texDetails.depth = 1;
   texDetails.mips = 1;
 
-  byte *data = NULL;
-  size_t datasize = 0;
+  const uint32_t openexr_magic = MAKE_FOURCC(0x76, 0x2f, 0x31, 0x01);
+  const uint32_t dds_magic = MAKE_FOURCC('D', 'D', 'S', ' ');
 
-  bool dds = false;
+  uint32_t magic = 0;
+  if(size >= sizeof(magic))
+    memcpy(&magic, buf, sizeof(magic));
 
-  if(is_exr_file(f))
+  if(magic == dds_magic)
   {
-    texDetails.format = rgba32_float;
+    dds_data read_data = load_dds_from_memory(buf, size);
 
-    FileIO::fseek64(f, 0, SEEK_END);
-    uint64_t size = FileIO::ftell64(f);
-    FileIO::fseek64(f, 0, SEEK_SET);
+    if(read_data.subdata == NULL)
+      return false;
 
-    std::vector<byte> buffer;
-    buffer.resize((size_t)size);
+    texDetails.cubemap = read_data.cubemap;
+    texDetails.arraysize = read_data.slices;
+    texDetails.width = read_data.width;
+    texDetails.height = read_data.height;
+    texDetails.depth = read_data.depth;
+    texDetails.mips = read_data.mips;
+    texDetails.format = read_data.format;
+    texDetails.dimension = 1;
+    if(texDetails.width > 1)
+      texDetails.dimension = 2;
+    if(texDetails.depth > 1)
+      texDetails.dimension = 3;
 
-    FileIO::fread(&buffer[0], 1, buffer.size(), f);
+    for(uint32_t i = 0; i < texDetails.arraysize * texDetails.mips; i++)
+    {
+      img.subdata.push_back(read_data.subdata[i]);
+      img.subsizes.push_back((size_t)read_data.subsizes[i]);
+    }
+
+    delete[] read_data.subdata;
+    delete[] read_data.subsizes;
+
+    // the subresources are uploaded straight out of buf, which the caller keeps until then
+    return true;
+  }
+
+  size_t datasize = 0;
+
+  if(magic == openexr_magic)
+  {
+    texDetails.format = rgba32_float;
 
     EXRImage exrImage;
     InitEXRImage(&exrImage);
 
     const char *err = NULL;
 
-    int ret = ParseMultiChannelEXRHeaderFromMemory(&exrImage, &buffer[0], &err);
+    int ret = ParseMultiChannelEXRHeaderFromMemory(&exrImage, buf, &err);
 
     if(ret != 0)
     {
       RDCERR(
           "EXR file detected, but couldn't load with ParseMultiChannelEXRHeaderFromMemory %d: '%s'",
           ret, err);
-      FileIO::fclose(f);
-      return;
+      return false;
     }
 
     texDetails.width = exrImage.width;
     texDetails.height = exrImage.height;
 
     datasize = texDetails.width * texDetails.height * 4 * sizeof(float);
-    data = (byte *)malloc(datasize);
+    img.decoded = (byte *)malloc(datasize);
 
     for(int i = 0; i < exrImage.num_channels; i++)
       exrImage.requested_pixel_types[i] = TINYEXR_PIXELTYPE_FLOAT;
 
-    ret = LoadMultiChannelEXRFromMemory(&exrImage, &buffer[0], &err);
+    ret = LoadMultiChannelEXRFromMemory(&exrImage, buf, &err);
+
+    // shouldn't get here but let's be safe
+    if(ret != 0)
+    {
+      FreeEXRImage(&exrImage);
+      RDCERR("EXR file detected, but couldn't load with LoadEXRFromMemory %d: '%s'", ret, err);
+      return false;
+    }
 
     int channels[4] = {-1, -1, -1, -1};
     for(int i = 0; i < exrImage.num_channels; i++)
@@ -493,7 +766,7 @@ void ImageViewer::RefreshFile()
       }
     }
 
-    float *rgba = (float *)data;
+    float *rgba = (float *)img.decoded;
     float **src = (float **)exrImage.images;
 
     for(uint32_t i = 0; i < texDetails.width * texDetails.height; i++)
@@ -510,93 +783,65 @@ void ImageViewer::RefreshFile()
     }
 
     FreeEXRImage(&exrImage);
-
-    // shouldn't get here but let's be safe
-    if(ret != 0)
-    {
-      free(data);
-      RDCERR("EXR file detected, but couldn't load with LoadEXRFromMemory %d: '%s'", ret, err);
-      FileIO::fclose(f);
-      return;
-    }
-  }
-  else if(stbi_is_hdr_from_file(f))
-  {
-    texDetails.format = rgba32_float;
-
-    FileIO::fseek64(f, 0, SEEK_SET);
-
-    int ignore = 0;
-    data = (byte *)stbi_loadf_from_file(f, (int *)&texDetails.width, (int *)&texDetails.height,
-                                        &ignore, 4);
-    datasize = texDetails.width * texDetails.height * 4 * sizeof(float);
-  }
-  else if(is_dds_file(f))
-  {
-    dds = true;
   }
   else
   {
+    // stb_image takes the length as an int
+    if(size > INT_MAX)
+    {
+      RDCERR("Image file is too large to load: %llu bytes", size);
+      return false;
+    }
+
+    int len = (int)size;
     int ignore = 0;
-    int ret = stbi_info_from_file(f, (int *)&texDetails.width, (int *)&texDetails.height, &ignore);
 
-    // just in case (we shouldn't have come in here if this weren't true), make sure
-    // the format is supported
-    if(ret == 0 || texDetails.width == 0 || texDetails.width == ~0U || texDetails.height == 0 ||
-       texDetails.height == ~0U)
+    if(stbi_is_hdr_from_memory(buf, len))
     {
-      FileIO::fclose(f);
-      return;
+      texDetails.format = rgba32_float;
+
+      img.decoded = (byte *)stbi_loadf_from_memory(buf, len, (int *)&texDetails.width,
+                                                   (int *)&texDetails.height, &ignore, 4);
+      datasize = texDetails.width * texDetails.height * 4 * sizeof(float);
     }
+    else
+    {
+      int ret = stbi_info_from_memory(buf, len, (int *)&texDetails.width,
+                                      (int *)&texDetails.height, &ignore);
 
-    texDetails.format = rgba8_unorm;
+      // just in case (we shouldn't have come in here if this weren't true), make sure
+      // the format is supported
+      if(ret == 0 || texDetails.width == 0 || texDetails.width == ~0U ||
+         texDetails.height == 0 || texDetails.height == ~0U)
+        return false;
 
-    data = stbi_load_from_file(f, (int *)&texDetails.width, (int *)&texDetails.height, &ignore, 4);
-    datasize = texDetails.width * texDetails.height * 4 * sizeof(byte);
-  }
+      texDetails.format = rgba8_unorm;
 
-  // if we don't have data at this point (and we're not a dds file) then the
-  // file was corrupted and we failed to load it
-  if(!dds && data == NULL)
-  {
-    FileIO::fclose(f);
-    return;
+      img.decoded = stbi_load_from_memory(buf, len, (int *)&texDetails.width,
+                                          (int *)&texDetails.height, &ignore, 4);
+      datasize = texDetails.width * texDetails.height * 4 * sizeof(byte);
+    }
   }
 
-  m_FrameRecord.frameInfo.initDataSize = 0;
-  m_FrameRecord.frameInfo.persistentSize = 0;
-  m_FrameRecord.frameInfo.uncompressedFileSize = datasize;
+  // if we don't have data at this point then the file was corrupted and we failed to load it
+  if(img.decoded == NULL)
+    return false;
 
-  dds_data read_data = {0};
+  img.subdata.push_back(img.decoded);
+  img.subsizes.push_back(datasize);
 
-  if(dds)
-  {
-    FileIO::fseek64(f, 0, SEEK_SET);
-    read_data = load_dds_from_file(f);
-
-    if(read_data.subdata == NULL)
-    {
-      FileIO::fclose(f);
-      return;
-    }
+  return true;
+}
 
-    texDetails.cubemap = read_data.cubemap;
-    texDetails.arraysize = read_data.slices;
-    texDetails.width = read_data.width;
-    texDetails.height = read_data.height;
-    texDetails.depth = read_data.depth;
-    texDetails.mips = read_data.mips;
-    texDetails.format = read_data.format;
-    texDetails.dimension = 1;
-    if(texDetails.width > 1)
-      texDetails.dimension = 2;
-    if(texDetails.depth > 1)
-      texDetails.dimension = 3;
+void ImageViewer::UploadImage(LoadedImage &img)
+{
+  TextureDescription &texDetails = img.texDetails;
 
-    m_FrameRecord.frameInfo.uncompressedFileSize = 0;
-    for(uint32_t i = 0; i < texDetails.arraysize * texDetails.mips; i++)
-      m_FrameRecord.frameInfo.uncompressedFileSize += read_data.subsizes[i];
-  }
+  m_FrameRecord.frameInfo.initDataSize = 0;
+  m_FrameRecord.frameInfo.persistentSize = 0;
+  m_FrameRecord.frameInfo.uncompressedFileSize = 0;
+  for(size_t i = 0; i < img.subsizes.size(); i++)
+    m_FrameRecord.frameInfo.uncompressedFileSize += img.subsizes[i];
 
   m_FrameRecord.frameInfo.compressedFileSize = m_FrameRecord.frameInfo.uncompressedFileSize;
 
@@ -618,26 +863,28 @@ void ImageViewer::RefreshFile()
   }
 
   if(m_TextureID == ResourceId())
-    m_TextureID = m_Proxy->CreateProxyTexture(texDetails);
-
-  if(!dds)
   {
-    m_Proxy->SetProxyTextureData(m_TextureID, 0, 0, data, datasize);
-    free(data);
+    m_TextureID = m_Proxy->CreateProxyTexture(texDetails);
+    texDetails.ID = m_TextureID;
+    m_TexDetails = texDetails;
   }
-  else
-  {
-    for(uint32_t i = 0; i < texDetails.arraysize * texDetails.mips; i++)
-    {
-      m_Proxy->SetProxyTextureData(m_TextureID, i / texDetails.mips, i % texDetails.mips,
-                                   read_data.subdata[i], (size_t)read_data.subsizes[i]);
 
-      delete[] read_data.subdata[i];
-    }
+  for(size_t i = 0; i < img.subdata.size(); i++)
+    m_Proxy->SetProxyTextureData(m_TextureID, uint32_t(i) / texDetails.mips,
+                                 uint32_t(i) % texDetails.mips, img.subdata[i], img.subsizes[i]);
 
-    delete[] read_data.subdata;
-    delete[] read_data.subsizes;
-  }
+  ReleaseImage(img);
+}
 
-  FileIO::fclose(f);
+void ImageViewer::ReleaseImage(LoadedImage &img)
+{
+  free(img.decoded);
+  FileIO::UnmapFile(img.mapped, img.mappedSize);
+
+  img.decoded = NULL;
+  img.mapped = NULL;
+  img.mappedSize = 0;
+  img.subdata.clear();
+  img.subsizes.clear();
+  std::vector<byte>().swap(img.contents);
 }
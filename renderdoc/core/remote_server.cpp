@@ -82,7 +82,10 @@ void Serialiser::Serialise(const char *name, EnvironmentModification &el)
   Serialise("value", el.value);
 }
 
-static const uint32_t RemoteServerProtocolVersion = 1;
+// bump this whenever the remote server or replay proxy packets change, so that mismatched builds
+// refuse to connect instead of misinterpreting each other.
+//  2 - GetUsage takes an event range and usage mask, readback streams
+static const uint32_t RemoteServerProtocolVersion = 2;
 
 enum RemoteServerPacket
 {
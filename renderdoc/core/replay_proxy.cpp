@@ -2065,6 +2065,78 @@ void ReplayProxy::RemapProxyTextureIfNeeded(ResourceFormat &format, GetTextureDa
   }
 }
 
+void ReplayProxy::EnsureProxyTexture(ResourceId texid)
+{
+  if(m_ProxyTextures.find(texid) == m_ProxyTextures.end())
+  {
+    TextureDescription tex = GetTexture(texid);
+
+    ProxyTextureProperties proxy;
+    proxy.desc = tex;
+    RemapProxyTextureIfNeeded(tex.format, proxy.params);
+
+    proxy.id = m_Proxy->CreateProxyTexture(tex);
+    m_ProxyTextures[texid] = proxy;
+  }
+}
+
+// Pick which mip to fetch and display for a texture render. Textures are drawn at the same size
+// whichever mip is selected, so when zoomed out a coarser mip where each texel still covers at
+// least one output pixel looks much the same as the requested mip, for a fraction of the data
+// to pull across from the remote replay. Finer mips are only fetched once the view zooms in.
+//
+// This displays a mip other than the one selected, so it's only done if the user opts in with the
+// "proxy.display.coarseMips" config setting, which is off by default and set from the texture
+// viewer options in the UI. Custom shaders and overlays depend on the selected mip, so they always
+// get the one they asked for.
+uint32_t ReplayProxy::GetProxyDisplayMip(const TextureDisplay &cfg)
+{
+  if(atoi(RenderDoc::Inst().GetConfigSetting("proxy.display.coarseMips").c_str()) == 0)
+    return cfg.mip;
+
+  if(!m_Socket->Connected() || cfg.rawoutput || cfg.texid == ResourceId() ||
+     cfg.CustomShader != ResourceId() || cfg.overlay != DebugOverlay::NoOverlay ||
+     m_LocalTextures.find(cfg.texid) != m_LocalTextures.end())
+    return cfg.mip;
+
+  EnsureProxyTexture(cfg.texid);
+
+  const TextureDescription &tex = m_ProxyTextures[cfg.texid].desc;
+
+  // 3D textures select their slice per-mip, and multisampled textures have no mips
+  if(tex.depth > 1 || tex.msSamp > 1 || cfg.mip + 1 >= tex.mips || tex.width == 0 ||
+     tex.height == 0)
+    return cfg.mip;
+
+  float scale = cfg.scale;
+
+  // match the fit-to-window scale that the driver will calculate
+  if(scale <= 0.0f)
+  {
+    int32_t w = 0, h = 0;
+    m_Proxy->GetOutputWindowDimensions(m_CurrentOutputWindow, w, h);
+
+    if(w <= 0 || h <= 0)
+      return cfg.mip;
+
+    scale = RDCMIN(float(w) / float(tex.width), float(h) / float(tex.height));
+  }
+
+  uint32_t mip = cfg.mip;
+  while(mip + 1 < tex.mips && scale * float(1U << (mip + 1)) <= 1.0f)
+    mip++;
+
+  // if a finer mip has already been fetched, display it rather than fetching another
+  for(uint32_t m = cfg.mip; m < mip; m++)
+  {
+    TextureCacheEntry entry = {cfg.texid, cfg.sliceFace, m};
+    if(m_TextureProxyCache.find(entry) != m_TextureProxyCache.end())
+      return m;
+  }
+
+  return mip;
+}
+
 void ReplayProxy::EnsureTexCached(ResourceId texid, uint32_t arrayIdx, uint32_t mip)
 {
   if(!m_Socket->Connected())
@@ -2077,16 +2149,7 @@ void ReplayProxy::EnsureTexCached(ResourceId texid, uint32_t arrayIdx, uint32_t
 
   if(m_TextureProxyCache.find(entry) == m_TextureProxyCache.end())
   {
-    if(m_ProxyTextures.find(texid) == m_ProxyTextures.end())
-    {
-      TextureDescription tex = GetTexture(texid);
-
-      ProxyTextureProperties proxy;
-      RemapProxyTextureIfNeeded(tex.format, proxy.params);
-
-      proxy.id = m_Proxy->CreateProxyTexture(tex);
-      m_ProxyTextures[texid] = proxy;
-    }
+    EnsureProxyTexture(texid);
 
     const ProxyTextureProperties &proxy = m_ProxyTextures[texid];
 
@@ -2151,7 +2214,7 @@ bool ReplayProxy::Tick(int type, Serialiser *incomingPacket)
     case eReplayProxy_GetShader: GetShader(ResourceId(), ""); break;
     case eReplayProxy_GetDebugMessages: GetDebugMessages(); break;
     case eReplayProxy_SavePipelineState: SavePipelineState(); break;
-    case eReplayProxy_GetUsage: GetUsage(ResourceId()); break;
+    case eReplayProxy_GetUsage: GetUsage(ResourceId(), 0, 0, 0); break;
     case eReplayProxy_GetLiveID: GetLiveID(ResourceId()); break;
     case eReplayProxy_GetFrameRecord: GetFrameRecord(); break;
     case eReplayProxy_IsRenderOutput: IsRenderOutput(ResourceId()); break;
@@ -2441,15 +2504,19 @@ vector<uint32_t> ReplayProxy::GetPassEvents(uint32_t eventID)
   return ret;
 }
 
-vector<EventUsage> ReplayProxy::GetUsage(ResourceId id)
+vector<EventUsage> ReplayProxy::GetUsage(ResourceId id, uint32_t minEventID, uint32_t maxEventID,
+                                         uint64_t usageMask)
 {
   vector<EventUsage> ret;
 
   m_ToReplaySerialiser->Serialise("", id);
+  m_ToReplaySerialiser->Serialise("", minEventID);
+  m_ToReplaySerialiser->Serialise("", maxEventID);
+  m_ToReplaySerialiser->Serialise("", usageMask);
 
   if(m_RemoteServer)
   {
-    ret = m_Remote->GetUsage(id);
+    ret = m_Remote->GetUsage(id, minEventID, maxEventID, usageMask);
   }
   else
   {
@@ -2650,6 +2717,9 @@ void ReplayProxy::GetBufferData(ResourceId buff, uint64_t offset, uint64_t len,
   }
 }
 
+// the size of each LZ4 block that texture data is compressed in when sent to the proxy
+static const uint32_t TextureDataBlockSize = 16 * 1024 * 1024;
+
 byte *ReplayProxy::GetTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t mip,
                                   const GetTextureDataParams &_params, size_t &dataSize)
 {
@@ -2669,15 +2739,24 @@ byte *ReplayProxy::GetTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t mi
   {
     byte *data = m_Remote->GetTextureData(tex, arrayIdx, mip, params, dataSize);
 
-    byte *compressed = new byte[LZ4_COMPRESSBOUND(dataSize)];
-
-    uint32_t uncompressedSize = (uint32_t)dataSize;
-    uint32_t compressedSize =
-        (uint32_t)LZ4_compress((const char *)data, (char *)compressed, (int)uncompressedSize);
+    uint64_t uncompressedSize = data ? (uint64_t)dataSize : 0;
 
     m_FromReplaySerialiser->Serialise("", uncompressedSize);
-    m_FromReplaySerialiser->Serialise("", compressedSize);
-    m_FromReplaySerialiser->RawWriteBytes(compressed, (size_t)compressedSize);
+
+    // compress in fixed size blocks, so that the size of the subresource isn't limited by LZ4's
+    // 32-bit sizes and the temporary compression memory stays bounded
+    byte *compressed = new byte[LZ4_COMPRESSBOUND(TextureDataBlockSize)];
+
+    for(uint64_t offs = 0; offs < uncompressedSize; offs += TextureDataBlockSize)
+    {
+      int blockSize = (int)RDCMIN((uint64_t)TextureDataBlockSize, uncompressedSize - offs);
+
+      uint32_t compressedSize =
+          (uint32_t)LZ4_compress((const char *)data + offs, (char *)compressed, blockSize);
+
+      m_FromReplaySerialiser->Serialise("", compressedSize);
+      m_FromReplaySerialiser->RawWriteBytes(compressed, (size_t)compressedSize);
+    }
 
     delete[] data;
     delete[] compressed;
@@ -2690,13 +2769,11 @@ byte *ReplayProxy::GetTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t mi
       return NULL;
     }
 
-    uint32_t uncompressedSize = 0;
-    uint32_t compressedSize = 0;
+    uint64_t uncompressedSize = 0;
 
     m_FromReplaySerialiser->Serialise("", uncompressedSize);
-    m_FromReplaySerialiser->Serialise("", compressedSize);
 
-    if(uncompressedSize == 0 || compressedSize == 0)
+    if(uncompressedSize == 0)
     {
       dataSize = 0;
       return NULL;
@@ -2706,9 +2783,17 @@ byte *ReplayProxy::GetTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t mi
 
     byte *ret = new byte[dataSize + 512];
 
-    byte *compressed = (byte *)m_FromReplaySerialiser->RawReadBytes((size_t)compressedSize);
+    for(uint64_t offs = 0; offs < uncompressedSize; offs += TextureDataBlockSize)
+    {
+      int blockSize = (int)RDCMIN((uint64_t)TextureDataBlockSize, uncompressedSize - offs);
+
+      uint32_t compressedSize = 0;
+      m_FromReplaySerialiser->Serialise("", compressedSize);
 
-    LZ4_decompress_fast((const char *)compressed, (char *)ret, (int)dataSize);
+      byte *compressed = (byte *)m_FromReplaySerialiser->RawReadBytes((size_t)compressedSize);
+
+      LZ4_decompress_fast((const char *)compressed, (char *)ret + offs, blockSize);
+    }
 
     return ret;
   }
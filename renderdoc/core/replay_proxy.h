@@ -102,6 +102,7 @@ public:
     m_FromReplaySerialiser = NULL;
     m_ToReplaySerialiser = new Serialiser(NULL, Serialiser::WRITING, false);
     m_RemoteHasResolver = false;
+    m_CurrentOutputWindow = 0;
 
     GetAPIProperties();
   }
@@ -112,6 +113,7 @@ public:
     m_ToReplaySerialiser = NULL;
     m_FromReplaySerialiser = new Serialiser(NULL, Serialiser::WRITING, false);
     m_RemoteHasResolver = false;
+    m_CurrentOutputWindow = 0;
 
     RDCEraseEl(m_APIProps);
   }
@@ -161,6 +163,8 @@ public:
   }
   void BindOutputWindow(uint64_t id, bool depth)
   {
+    m_CurrentOutputWindow = id;
+
     if(m_Proxy)
       return m_Proxy->BindOutputWindow(id, depth);
   }
@@ -223,6 +227,8 @@ public:
   {
     if(m_Proxy)
     {
+      cfg.mip = GetProxyDisplayMip(cfg);
+
       EnsureTexCached(cfg.texid, cfg.sliceFace, cfg.mip);
       if(cfg.texid == ResourceId() || m_ProxyTextures[cfg.texid] == ResourceId())
         return false;
@@ -405,7 +411,8 @@ public:
 
   vector<uint32_t> GetPassEvents(uint32_t eventID);
 
-  vector<EventUsage> GetUsage(ResourceId id);
+  vector<EventUsage> GetUsage(ResourceId id, uint32_t minEventID, uint32_t maxEventID,
+                              uint64_t usageMask);
   FrameRecord GetFrameRecord();
 
   bool IsRenderOutput(ResourceId id);
@@ -456,6 +463,7 @@ public:
   void RemoveReplacement(ResourceId id);
 
   void FileChanged() {}
+  bool HasFileChanged() { return false; }
   // will never be used
   ResourceId CreateProxyTexture(const TextureDescription &templateTex)
   {
@@ -484,7 +492,9 @@ public:
 private:
   bool SendReplayCommand(ReplayProxyPacket type);
 
+  void EnsureProxyTexture(ResourceId texid);
   void EnsureTexCached(ResourceId texid, uint32_t arrayIdx, uint32_t mip);
+  uint32_t GetProxyDisplayMip(const TextureDisplay &cfg);
   void RemapProxyTextureIfNeeded(ResourceFormat &format, GetTextureDataParams &params);
   void EnsureBufCached(ResourceId bufid);
 
@@ -510,6 +520,8 @@ private:
   {
     ResourceId id;
     GetTextureDataParams params;
+    // the description of the remote texture, not set for local textures
+    TextureDescription desc;
 
     ProxyTextureProperties() {}
     // Create a proxy Id with the default get-data parameters.
@@ -519,6 +531,9 @@ private:
   };
   map<ResourceId, ProxyTextureProperties> m_ProxyTextures;
 
+  // the output window last bound, used to calculate the scale when textures are fit to the window
+  uint64_t m_CurrentOutputWindow;
+
   set<ResourceId> m_BufferProxyCache;
   map<ResourceId, ResourceId> m_ProxyBufferIds;
 
@@ -250,6 +250,11 @@ struct ResourceRecord
     for(auto it = m_FrameRefs.begin(); it != m_FrameRefs.end(); ++it)
       ids.insert(it->first);
   }
+  void AddReferencedIDs(std::vector<ResourceId> &ids)
+  {
+    for(auto it = m_FrameRefs.begin(); it != m_FrameRefs.end(); ++it)
+      ids.push_back(it->first);
+  }
 
   uint64_t Length;
 
@@ -884,6 +884,75 @@ const char *WrappedID3D11Device::GetChunkName(uint32_t idx)
   return D3D11ChunkNames[idx - FIRST_CHUNK_ID];
 }
 
+ChunkCategory WrappedID3D11Device::GetChunkCategory(uint32_t idx, const char *&resourceType)
+{
+  switch((D3D11ChunkType)idx)
+  {
+    case CAPTURE_SCOPE: return ChunkCategory::CaptureScope;
+
+    case DRAW_INDEXED_INST:
+    case DRAW_INST:
+    case DRAW_INDEXED:
+    case DRAW:
+    case DRAW_AUTO:
+    case DRAW_INDEXED_INST_INDIRECT:
+    case DRAW_INST_INDIRECT: return ChunkCategory::Drawcall;
+
+    case DISPATCH:
+    case DISPATCH_INDIRECT: return ChunkCategory::Dispatch;
+
+    case CLEAR_DSV:
+    case CLEAR_RTV:
+    case CLEAR_UAV_INT:
+    case CLEAR_UAV_FLOAT:
+    case CLEAR_VIEW: return ChunkCategory::Clear;
+
+    case COPY_SUBRESOURCE_REGION:
+    case COPY_SUBRESOURCE_REGION1:
+    case COPY_RESOURCE:
+    case COPY_STRUCTURE_COUNT:
+    case RESOLVE_SUBRESOURCE: return ChunkCategory::Copy;
+
+    // these can target buffers or textures, which we can't tell without reading the chunk
+    case UNMAP:
+    case UPDATE_SUBRESOURCE:
+    case UPDATE_SUBRESOURCE1: return ChunkCategory::Upload;
+
+    case CREATE_SWAP_BUFFER: resourceType = "Swapchain Buffer"; return ChunkCategory::Resource;
+    case CREATE_TEXTURE_1D:
+    case CREATE_TEXTURE_2D:
+    case CREATE_TEXTURE_3D: resourceType = "Texture"; return ChunkCategory::Resource;
+    case CREATE_BUFFER: resourceType = "Buffer"; return ChunkCategory::Resource;
+    case CREATE_VERTEX_SHADER:
+    case CREATE_HULL_SHADER:
+    case CREATE_DOMAIN_SHADER:
+    case CREATE_GEOMETRY_SHADER:
+    case CREATE_GEOMETRY_SHADER_WITH_SO:
+    case CREATE_PIXEL_SHADER:
+    case CREATE_COMPUTE_SHADER: resourceType = "Shader"; return ChunkCategory::Resource;
+    case CREATE_SRV:
+    case CREATE_RTV:
+    case CREATE_DSV:
+    case CREATE_UAV: resourceType = "View"; return ChunkCategory::Resource;
+    case CREATE_INPUT_LAYOUT: resourceType = "Input Layout"; return ChunkCategory::Resource;
+    case CREATE_BLEND_STATE:
+    case CREATE_BLEND_STATE1:
+    case CREATE_DEPTHSTENCIL_STATE:
+    case CREATE_RASTER_STATE:
+    case CREATE_RASTER_STATE1:
+    case CREATE_RASTER_STATE2:
+    case CREATE_SAMPLER_STATE: resourceType = "State Object"; return ChunkCategory::Resource;
+    case CREATE_QUERY:
+    case CREATE_QUERY1:
+    case CREATE_PREDICATE:
+    case CREATE_COUNTER: resourceType = "Query"; return ChunkCategory::Resource;
+
+    default: break;
+  }
+
+  return ChunkCategory::Other;
+}
+
 template <>
 string ToStrHelper<false, D3D11ChunkType>::Get(const D3D11ChunkType &el)
 {
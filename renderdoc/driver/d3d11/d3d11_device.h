@@ -418,6 +418,7 @@ public:
 
   ID3D11Device *GetReal() { return m_pDevice; }
   static const char *GetChunkName(uint32_t idx);
+  static ChunkCategory GetChunkCategory(uint32_t idx, const char *&resourceType);
   D3D11DebugManager *GetDebugManager() { return m_DebugManager; }
   D3D11ResourceManager *GetResourceManager() { return m_ResourceManager; }
   D3D11Replay *GetReplay() { return &m_Replay; }
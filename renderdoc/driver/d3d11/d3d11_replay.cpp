@@ -340,9 +340,11 @@ FrameRecord D3D11Replay::GetFrameRecord()
   return m_pDevice->GetFrameRecord();
 }
 
-vector<EventUsage> D3D11Replay::GetUsage(ResourceId id)
+vector<EventUsage> D3D11Replay::GetUsage(ResourceId id, uint32_t minEventID, uint32_t maxEventID,
+                                         uint64_t usageMask)
 {
-  return m_pDevice->GetImmediateContext()->GetUsage(id);
+  return FilterUsage(m_pDevice->GetImmediateContext()->GetUsage(id), minEventID, maxEventID,
+                     usageMask);
 }
 
 vector<DebugMessage> D3D11Replay::GetDebugMessages()
@@ -2135,3 +2137,5 @@ ReplayStatus D3D11_CreateReplayDevice(const char *logfile, IReplayDriver **drive
 }
 
 static DriverRegistration D3D11DriverRegistration(RDC_D3D11, "D3D11", &D3D11_CreateReplayDevice);
+static DriverRegistration D3D11ChunkRegistration(RDC_D3D11, &WrappedID3D11Device::GetChunkName,
+                                                 &WrappedID3D11Device::GetChunkCategory);
@@ -58,7 +58,8 @@ public:
 
   ShaderReflection *GetShader(ResourceId shader, string entryPoint);
 
-  vector<EventUsage> GetUsage(ResourceId id);
+  vector<EventUsage> GetUsage(ResourceId id, uint32_t minEventID, uint32_t maxEventID,
+                              uint64_t usageMask);
 
   FrameRecord GetFrameRecord();
 
@@ -161,6 +162,7 @@ public:
   bool IsRenderOutput(ResourceId id);
 
   void FileChanged() {}
+  bool HasFileChanged() { return false; }
   void InitCallstackResolver();
   bool HasCallstacks();
   Callstack::StackResolver *GetCallstackResolver();
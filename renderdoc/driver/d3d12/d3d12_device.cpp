@@ -87,6 +87,56 @@ const char *WrappedID3D12Device::GetChunkName(uint32_t idx)
   return D3D12ChunkNames[idx - FIRST_CHUNK_ID];
 }
 
+ChunkCategory WrappedID3D12Device::GetChunkCategory(uint32_t idx, const char *&resourceType)
+{
+  switch((D3D12ChunkType)idx)
+  {
+    case CAPTURE_SCOPE: return ChunkCategory::CaptureScope;
+
+    // ExecuteIndirect could be either, but is more often used for draws
+    case DRAW_INDEXED_INST:
+    case DRAW_INST:
+    case EXEC_INDIRECT: return ChunkCategory::Drawcall;
+
+    case DISPATCH: return ChunkCategory::Dispatch;
+
+    case CLEAR_RTV:
+    case CLEAR_DSV:
+    case CLEAR_UAV_INT:
+    case CLEAR_UAV_FLOAT: return ChunkCategory::Clear;
+
+    case COPY_BUFFER:
+    case COPY_TEXTURE:
+    case COPY_RESOURCE:
+    case COPY_TILES:
+    case RESOLVE_SUBRESOURCE: return ChunkCategory::Copy;
+
+    case MAP_DATA_WRITE:
+    case WRITE_TO_SUB: resourceType = "Resource"; return ChunkCategory::Upload;
+
+    case CREATE_SWAP_BUFFER: resourceType = "Swapchain Buffer"; return ChunkCategory::Resource;
+    case CREATE_COMMITTED_RESOURCE:
+    case CREATE_PLACED_RESOURCE:
+    case CREATE_RESERVED_RESOURCE: resourceType = "Resource"; return ChunkCategory::Resource;
+    case CREATE_HEAP: resourceType = "Heap"; return ChunkCategory::Resource;
+    case CREATE_GRAPHICS_PIPE:
+    case CREATE_COMPUTE_PIPE: resourceType = "Pipeline State"; return ChunkCategory::Resource;
+    case CREATE_ROOT_SIG: resourceType = "Root Signature"; return ChunkCategory::Resource;
+    case CREATE_COMMAND_SIG: resourceType = "Command Signature"; return ChunkCategory::Resource;
+    case CREATE_DESCRIPTOR_HEAP: resourceType = "Descriptor Heap"; return ChunkCategory::Resource;
+    case CREATE_QUERY_HEAP: resourceType = "Query Heap"; return ChunkCategory::Resource;
+    case CREATE_FENCE: resourceType = "Fence"; return ChunkCategory::Resource;
+    case CREATE_COMMAND_QUEUE: resourceType = "Command Queue"; return ChunkCategory::Resource;
+    case CREATE_COMMAND_ALLOCATOR:
+      resourceType = "Command Allocator";
+      return ChunkCategory::Resource;
+
+    default: break;
+  }
+
+  return ChunkCategory::Other;
+}
+
 template <>
 string ToStrHelper<false, D3D12ChunkType>::Get(const D3D12ChunkType &el)
 {
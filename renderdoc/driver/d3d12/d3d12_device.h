@@ -356,6 +356,7 @@ public:
 
   ID3D12Device *GetReal() { return m_pDevice; }
   static const char *GetChunkName(uint32_t idx);
+  static ChunkCategory GetChunkCategory(uint32_t idx, const char *&resourceType);
   D3D12ResourceManager *GetResourceManager() { return m_ResourceManager; }
   D3D12DebugManager *GetDebugManager() { return m_DebugManager; }
   Serialiser *GetMainSerialiser() { return m_pSerialiser; }
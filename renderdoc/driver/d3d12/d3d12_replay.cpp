@@ -285,9 +285,10 @@ ResourceId D3D12Replay::GetLiveID(ResourceId id)
   return m_pDevice->GetResourceManager()->GetLiveID(id);
 }
 
-vector<EventUsage> D3D12Replay::GetUsage(ResourceId id)
+vector<EventUsage> D3D12Replay::GetUsage(ResourceId id, uint32_t minEventID, uint32_t maxEventID,
+                                         uint64_t usageMask)
 {
-  return m_pDevice->GetQueue()->GetUsage(id);
+  return FilterUsage(m_pDevice->GetQueue()->GetUsage(id), minEventID, maxEventID, usageMask);
 }
 
 void D3D12Replay::FillResourceView(D3D12Pipe::View &view, D3D12Descriptor *desc)
@@ -1794,3 +1795,5 @@ ReplayStatus D3D12_CreateReplayDevice(const char *logfile, IReplayDriver **drive
 }
 
 static DriverRegistration D3D12DriverRegistration(RDC_D3D12, "D3D12", &D3D12_CreateReplayDevice);
+static DriverRegistration D3D12ChunkRegistration(RDC_D3D12, &WrappedID3D12Device::GetChunkName,
+                                                 &WrappedID3D12Device::GetChunkCategory);
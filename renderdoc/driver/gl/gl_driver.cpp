@@ -811,6 +811,9 @@ WrappedOpenGL::WrappedOpenGL(const char *logfile, const GLHookSet &funcs, GLPlat
 
   m_Replay.SetDriver(this);
 
+  m_CurrentContextTLSSlot = Threading::AllocateTLSSlot();
+  m_ContextDataGeneration = 0;
+
   m_FrameCounter = 0;
   m_NoCtxFrames = 0;
   m_FailedFrame = 0;
@@ -1079,6 +1082,117 @@ const char *WrappedOpenGL::GetChunkName(uint32_t idx)
   return GLChunkNames[idx - FIRST_CHUNK_ID];
 }
 
+ChunkCategory WrappedOpenGL::GetChunkCategory(uint32_t idx, const char *&resourceType)
+{
+  switch((GLChunkType)idx)
+  {
+    case CAPTURE_SCOPE: return ChunkCategory::CaptureScope;
+
+    case DRAWARRAYS:
+    case DRAWARRAYS_INDIRECT:
+    case DRAWARRAYS_INSTANCED:
+    case DRAWARRAYS_INSTANCEDBASEINSTANCE:
+    case DRAWELEMENTS:
+    case DRAWELEMENTS_INDIRECT:
+    case DRAWRANGEELEMENTS:
+    case DRAWRANGEELEMENTSBASEVERTEX:
+    case DRAWELEMENTS_INSTANCED:
+    case DRAWELEMENTS_INSTANCEDBASEINSTANCE:
+    case DRAWELEMENTS_BASEVERTEX:
+    case DRAWELEMENTS_INSTANCEDBASEVERTEX:
+    case DRAWELEMENTS_INSTANCEDBASEVERTEXBASEINSTANCE:
+    case DRAW_FEEDBACK:
+    case DRAW_FEEDBACK_INSTANCED:
+    case DRAW_FEEDBACK_STREAM:
+    case DRAW_FEEDBACK_STREAM_INSTANCED:
+    case MULTI_DRAWARRAYS:
+    case MULTI_DRAWELEMENTS:
+    case MULTI_DRAWELEMENTSBASEVERTEX:
+    case MULTI_DRAWARRAYS_INDIRECT:
+    case MULTI_DRAWELEMENTS_INDIRECT:
+    case MULTI_DRAWARRAYS_INDIRECT_COUNT:
+    case MULTI_DRAWELEMENTS_INDIRECT_COUNT: return ChunkCategory::Drawcall;
+
+    case DISPATCH_COMPUTE:
+    case DISPATCH_COMPUTE_GROUP_SIZE:
+    case DISPATCH_COMPUTE_INDIRECT: return ChunkCategory::Dispatch;
+
+    case CLEAR:
+    case CLEARBUFFERF:
+    case CLEARBUFFERI:
+    case CLEARBUFFERUI:
+    case CLEARBUFFERFI:
+    case CLEARBUFFERDATA:
+    case CLEARBUFFERSUBDATA:
+    case CLEARTEXIMAGE:
+    case CLEARTEXSUBIMAGE: return ChunkCategory::Clear;
+
+    case COPY_SUBIMAGE:
+    case COPY_IMAGE1D:
+    case COPY_IMAGE2D:
+    case COPY_SUBIMAGE1D:
+    case COPY_SUBIMAGE2D:
+    case COPY_SUBIMAGE3D:
+    case COPYBUFFERSUBDATA:
+    case BLIT_FRAMEBUFFER: return ChunkCategory::Copy;
+
+    case TEXIMAGE1D:
+    case TEXIMAGE2D:
+    case TEXIMAGE3D:
+    case TEXSUBIMAGE1D:
+    case TEXSUBIMAGE2D:
+    case TEXSUBIMAGE3D:
+    case TEXIMAGE1D_COMPRESSED:
+    case TEXIMAGE2D_COMPRESSED:
+    case TEXIMAGE3D_COMPRESSED:
+    case TEXSUBIMAGE1D_COMPRESSED:
+    case TEXSUBIMAGE2D_COMPRESSED:
+    case TEXSUBIMAGE3D_COMPRESSED: resourceType = "Texture"; return ChunkCategory::Upload;
+
+    case BUFFERDATA:
+    case BUFFERSUBDATA:
+    case UNMAP:
+    case FLUSHMAP: resourceType = "Buffer"; return ChunkCategory::Upload;
+
+    case GEN_TEXTURE:
+    case CREATE_TEXTURE: resourceType = "Texture"; return ChunkCategory::Resource;
+    case GEN_BUFFER:
+    case CREATE_BUFFER: resourceType = "Buffer"; return ChunkCategory::Resource;
+    case CREATE_SHADER: resourceType = "Shader"; return ChunkCategory::Resource;
+    case CREATE_PROGRAM:
+    case CREATE_SHADERPROGRAM: resourceType = "Program"; return ChunkCategory::Resource;
+    case GEN_PROGRAMPIPE:
+    case CREATE_PROGRAMPIPE: resourceType = "Program Pipeline"; return ChunkCategory::Resource;
+    case GEN_FRAMEBUFFERS:
+    case CREATE_FRAMEBUFFERS: resourceType = "Framebuffer"; return ChunkCategory::Resource;
+    case GEN_RENDERBUFFERS:
+    case CREATE_RENDERBUFFERS: resourceType = "Renderbuffer"; return ChunkCategory::Resource;
+    case GEN_SAMPLERS:
+    case CREATE_SAMPLERS: resourceType = "Sampler"; return ChunkCategory::Resource;
+    case GEN_VERTEXARRAY:
+    case CREATE_VERTEXARRAY: resourceType = "Vertex Array"; return ChunkCategory::Resource;
+    case GEN_QUERIES:
+    case CREATE_QUERIES: resourceType = "Query"; return ChunkCategory::Resource;
+    case GEN_FEEDBACK:
+    case CREATE_FEEDBACK: resourceType = "Transform Feedback"; return ChunkCategory::Resource;
+
+    // storage allocation and sources aren't creations, but their bytes belong to the resource
+    case TEXSTORAGE1D:
+    case TEXSTORAGE2D:
+    case TEXSTORAGE3D:
+    case TEXSTORAGE2DMS:
+    case TEXSTORAGE3DMS: resourceType = "Texture"; break;
+    case BUFFERSTORAGE: resourceType = "Buffer"; break;
+    case RENDERBUFFER_STORAGE:
+    case RENDERBUFFER_STORAGEMS: resourceType = "Renderbuffer"; break;
+    case SHADERSOURCE: resourceType = "Shader"; break;
+
+    default: break;
+  }
+
+  return ChunkCategory::Other;
+}
+
 template <>
 string ToStrHelper<false, GLChunkType>::Get(const GLChunkType &el)
 {
@@ -1119,18 +1233,61 @@ WrappedOpenGL::~WrappedOpenGL()
 
   SAFE_DELETE(m_ResourceManager);
 
+  for(size_t i = 0; i < m_ContextCaches.size(); i++)
+    delete m_ContextCaches[i];
+
   if(RenderDoc::Inst().GetCrashHandler())
     RenderDoc::Inst().GetCrashHandler()->UnregisterMemoryRegion(this);
 }
 
+WrappedOpenGL::CurrentContextCache *WrappedOpenGL::GetContextCache()
+{
+  CurrentContextCache *cache =
+      (CurrentContextCache *)Threading::GetTLSValue(m_CurrentContextTLSSlot);
+  if(cache)
+    return cache;
+
+  cache = new CurrentContextCache();
+  cache->ctx = (void *)m_ActiveContexts[Threading::GetCurrentID()].ctx;
+  cache->data = NULL;
+  cache->generation = m_ContextDataGeneration;
+
+  Threading::SetTLSValue(m_CurrentContextTLSSlot, (void *)cache);
+
+  // save it for deletion on shutdown
+  {
+    SCOPED_LOCK(m_ContextCachesLock);
+    m_ContextCaches.push_back(cache);
+  }
+
+  return cache;
+}
+
+void WrappedOpenGL::SetActiveContext(const GLWindowingData &winData)
+{
+  m_ActiveContexts[Threading::GetCurrentID()] = winData;
+
+  CurrentContextCache *cache = GetContextCache();
+  cache->ctx = (void *)winData.ctx;
+  cache->data = NULL;
+}
+
 void *WrappedOpenGL::GetCtx()
 {
-  return (void *)m_ActiveContexts[Threading::GetCurrentID()].ctx;
+  return GetContextCache()->ctx;
 }
 
 WrappedOpenGL::ContextData &WrappedOpenGL::GetCtxData()
 {
-  return m_ContextData[GetCtx()];
+  CurrentContextCache *cache = GetContextCache();
+
+  if(cache->data == NULL || cache->generation != m_ContextDataGeneration)
+  {
+    cache->data = &m_ContextData[cache->ctx];
+    cache->generation = m_ContextDataGeneration;
+  }
+
+  return *cache->data;
 }
 
 // defined in gl_<platform>_hooks.cpp
@@ -1173,6 +1330,9 @@ void WrappedOpenGL::DeleteContext(void *contextHandle)
   }
 
   m_ContextData.erase(contextHandle);
+
+  // any thread may have this context's data cached
+  m_ContextDataGeneration++;
 }
 
 void WrappedOpenGL::ContextData::UnassociateWindow(void *wndHandle)
@@ -1413,7 +1573,7 @@ void WrappedOpenGL::RegisterContext(GLWindowingData winData, void *shareContext,
 
 void WrappedOpenGL::ActivateContext(GLWindowingData winData)
 {
-  m_ActiveContexts[Threading::GetCurrentID()] = winData;
+  SetActiveContext(winData);
   if(winData.ctx)
   {
     for(auto it = m_LastContexts.begin(); it != m_LastContexts.end(); ++it)
@@ -1871,7 +2031,7 @@ void WrappedOpenGL::RenderOverlayStr(float x, float y, const char *text)
 
   RDCASSERT(strlen(text) < (size_t)FONT_MAX_CHARS);
 
-  ContextData &ctxdata = m_ContextData[GetCtx()];
+  ContextData &ctxdata = GetCtxData();
 
   if(!ctxdata.built || !ctxdata.ready)
     return;
@@ -2578,7 +2738,7 @@ void WrappedOpenGL::MakeValidContextCurrent(GLWindowingData &prevctx, void *favo
              Threading::GetCurrentID());
     }
 
-    m_ActiveContexts[Threading::GetCurrentID()] = prevctx;
+    SetActiveContext(prevctx);
     m_Platform.MakeContextCurrent(prevctx);
   }
 }
@@ -2635,7 +2795,7 @@ void WrappedOpenGL::StartFrameCapture(void *dev, void *wnd)
   if(switchctx.ctx != prevctx.ctx)
   {
     m_Platform.MakeContextCurrent(prevctx);
-    m_ActiveContexts[Threading::GetCurrentID()] = prevctx;
+    SetActiveContext(prevctx);
   }
 
   RDCLOG("Starting capture, frame %u", m_FrameCounter);
@@ -2752,7 +2912,7 @@ bool WrappedOpenGL::EndFrameCapture(void *dev, void *wnd)
     if(switchctx.ctx != prevctx.ctx)
     {
       m_Platform.MakeContextCurrent(prevctx);
-      m_ActiveContexts[Threading::GetCurrentID()] = prevctx;
+      SetActiveContext(prevctx);
     }
 
     return true;
@@ -2826,7 +2986,7 @@ bool WrappedOpenGL::EndFrameCapture(void *dev, void *wnd)
     if(switchctx.ctx != prevctx.ctx)
     {
       m_Platform.MakeContextCurrent(prevctx);
-      m_ActiveContexts[Threading::GetCurrentID()] = prevctx;
+      SetActiveContext(prevctx);
     }
 
     return false;
@@ -3962,15 +4122,10 @@ void WrappedOpenGL::ContextReplayLog(LogState readType, uint32_t startEventID, u
 
     SetupDrawcallPointers(&m_Drawcalls, GetFrameRecord().drawcallList, NULL, NULL);
 
-    // it's easier to remove duplicate usages here than check it as we go.
-    // this means if textures are bound in multiple places in the same draw
-    // we don't have duplicate uses
-    for(auto it = m_ResourceUses.begin(); it != m_ResourceUses.end(); ++it)
-    {
-      vector<EventUsage> &v = it->second;
-      std::sort(v.begin(), v.end());
-      v.erase(std::unique(v.begin(), v.end()), v.end());
-    }
+    // it's easier to remove duplicate usages here than check it as we go. This means if textures
+    // are bound in multiple places in the same draw we don't have duplicate uses. Building the
+    // index takes care of this.
+    m_ResourceUsage.Build(m_ResourceUses);
   }
 
   GetResourceManager()->MarkInFrame(false);
@@ -231,7 +231,9 @@ private:
 
   list<DrawcallTreeNode *> m_DrawcallStack;
 
+  // usages are accumulated here during the initial read, then packed into m_ResourceUsage
   map<ResourceId, vector<EventUsage> > m_ResourceUses;
+  ResourceUsageIndex m_ResourceUsage;
 
   bool m_FetchCounters;
 
@@ -474,6 +476,24 @@ private:
 
   map<void *, ContextData> m_ContextData;
 
+  // per-thread cache of the current context and its ContextData, so that wrapped functions don't
+  // do two map lookups every time they need it. The ContextData pointer is re-fetched whenever a
+  // context has been deleted since it was cached.
+  struct CurrentContextCache
+  {
+    void *ctx;
+    ContextData *data;
+    uint32_t generation;
+  };
+
+  uint64_t m_CurrentContextTLSSlot;
+  uint32_t m_ContextDataGeneration;
+  Threading::CriticalSection m_ContextCachesLock;
+  vector<CurrentContextCache *> m_ContextCaches;
+
+  CurrentContextCache *GetContextCache();
+  void SetActiveContext(const GLWindowingData &winData);
+
   ContextData &GetCtxData();
   GLuint GetUniformProgram();
 
@@ -535,6 +555,7 @@ public:
 
   uint32_t GetLogVersion() { return m_InitParams.SerialiseVersion; }
   static const char *GetChunkName(uint32_t idx);
+  static ChunkCategory GetChunkCategory(uint32_t idx, const char *&resourceType);
   GLResourceManager *GetResourceManager() { return m_ResourceManager; }
   ResourceId GetDeviceResourceID() { return m_DeviceResourceID; }
   ResourceId GetContextResourceID() { return m_ContextResourceID; }
@@ -571,7 +592,11 @@ public:
   const DrawcallDescription *GetDrawcall(uint32_t eventID);
 
   void SuppressDebugMessages(bool suppress) { m_SuppressDebugMessages = suppress; }
-  vector<EventUsage> GetUsage(ResourceId id) { return m_ResourceUses[id]; }
+  vector<EventUsage> GetUsage(ResourceId id, uint32_t minEventID, uint32_t maxEventID,
+                              uint64_t usageMask)
+  {
+    return m_ResourceUsage.Query(id, minEventID, maxEventID, usageMask);
+  }
   void CreateContext(GLWindowingData winData, void *shareContext, GLInitParams initParams,
                      bool core, bool attribsCreate);
   void RegisterContext(GLWindowingData winData, void *shareContext, bool core, bool attribsCreate);
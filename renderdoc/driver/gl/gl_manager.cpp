@@ -966,6 +966,12 @@ bool GLResourceManager::Force_InitialState(GLResource res, bool prepare)
 
 bool GLResourceManager::Serialise_InitialState(ResourceId resid, GLResource res)
 {
+  // initial contents are often identical between resources (e.g. zero-filled buffers or default
+  // textures). Other GL chunks can't be deduplicated, as buffer data chunks are later updated
+  // in-place to shadow the buffer's contents.
+  if(m_State >= WRITING)
+    m_pSerialiser->SetDeduplicateBuffers(true);
+
   SERIALISE_ELEMENT(ResourceId, Id, GetID(res));
 
   if(m_State < WRITING)
@@ -1613,6 +1619,9 @@ bool GLResourceManager::Serialise_InitialState(ResourceId resid, GLResource res)
     RDCERR("Unexpected type of resource requiring initial state");
   }
 
+  if(m_State >= WRITING)
+    m_pSerialiser->SetDeduplicateBuffers(false);
+
   return true;
 }
 
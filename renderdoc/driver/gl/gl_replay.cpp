@@ -3245,9 +3245,10 @@ void GLReplay::SetProxyBufferData(ResourceId bufid, byte *data, size_t dataSize)
   m_pDriver->glNamedBufferSubDataEXT(buf, 0, dataSize, data);
 }
 
-vector<EventUsage> GLReplay::GetUsage(ResourceId id)
+vector<EventUsage> GLReplay::GetUsage(ResourceId id, uint32_t minEventID, uint32_t maxEventID,
+                                      uint64_t usageMask)
 {
-  return m_pDriver->GetUsage(id);
+  return m_pDriver->GetUsage(id, minEventID, maxEventID, usageMask);
 }
 
 #pragma endregion
@@ -3375,3 +3376,8 @@ ReplayStatus GLES_CreateReplayDevice(const char *logfile, IReplayDriver **driver
 static DriverRegistration GLESDriverRegistration(RDC_OpenGLES, "OpenGLES", &GLES_CreateReplayDevice);
 
 #endif
+
+static DriverRegistration GLChunkRegistration(RDC_OpenGL, &WrappedOpenGL::GetChunkName,
+                                              &WrappedOpenGL::GetChunkCategory);
+static DriverRegistration GLESChunkRegistration(RDC_OpenGLES, &WrappedOpenGL::GetChunkName,
+                                                &WrappedOpenGL::GetChunkCategory);
@@ -103,7 +103,8 @@ public:
 
   vector<DebugMessage> GetDebugMessages();
 
-  vector<EventUsage> GetUsage(ResourceId id);
+  vector<EventUsage> GetUsage(ResourceId id, uint32_t minEventID, uint32_t maxEventID,
+                              uint64_t usageMask);
 
   FrameRecord GetFrameRecord();
 
@@ -218,6 +219,7 @@ public:
   bool IsRenderOutput(ResourceId id);
 
   void FileChanged() {}
+  bool HasFileChanged() { return false; }
   void InitCallstackResolver();
   bool HasCallstacks();
   Callstack::StackResolver *GetCallstackResolver();
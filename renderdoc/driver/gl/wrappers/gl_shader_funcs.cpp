@@ -26,6 +26,7 @@
 #include "../gl_driver.h"
 #include "../gl_shader_refl.h"
 #include "common/common.h"
+#include "common/shader_cache.h"
 #include "driver/shaders/spirv/spirv_common.h"
 #include "serialise/string_utils.h"
 
@@ -71,14 +72,40 @@ void WrappedOpenGL::ShaderData::Compile(WrappedOpenGL &gl)
     prog = sepProg;
     MakeShaderReflection(gl.GetHookset(), type, sepProg, reflection, pointSizeUsed, clipDistanceUsed);
 
-    vector<uint32_t> spirvwords;
+    // the disassembly is only dependent on the sources, so on replay look it up in the persistent
+    // cache before going to the expense of compiling to SPIR-V
+    bool useCache = RenderDoc::Inst().IsReplayApp();
+    uint64_t key = 0;
 
-    string s = CompileSPIRV(SPIRVShaderStage(ShaderIdx(type)), sources, spirvwords);
-    if(!spirvwords.empty())
-      ParseSPIRV(&spirvwords.front(), spirvwords.size(), spirv);
+    if(useCache)
+    {
+      key = Hash64(&type, sizeof(type));
+      for(size_t i = 0; i < sources.size(); i++)
+        key = Hash64(sources[i].c_str(), sources[i].size(), key);
+      key = ShaderAnalysisCache::MakeKey("gldisasm", 8, key);
+    }
+
+    std::vector<byte> disasm;
+    if(useCache && ShaderAnalysisCache::Fetch(key, disasm))
+    {
+      reflection.Disassembly = string(disasm.begin(), disasm.end());
+    }
+    else
+    {
+      vector<uint32_t> spirvwords;
+
+      string s = CompileSPIRV(SPIRVShaderStage(ShaderIdx(type)), sources, spirvwords);
+      if(!spirvwords.empty())
+        ParseSPIRV(&spirvwords.front(), spirvwords.size(), spirv);
 
-    // for classic GL, entry point is always main
-    reflection.Disassembly = spirv.Disassemble("main");
+      // for classic GL, entry point is always main. This is cached by the sources above, so
+      // don't also cache it by the SPIR-V
+      reflection.Disassembly = spirv.DisassembleUncached("main");
+
+      if(useCache)
+        ShaderAnalysisCache::Store(key, (const byte *)reflection.Disassembly.elems,
+                                   reflection.Disassembly.count);
+    }
 
     create_array_uninit(reflection.DebugInfo.files, sources.size());
     for(size_t i = 0; i < sources.size(); i++)
@@ -107,9 +107,20 @@ struct SPVModule
 
   SPVInstruction *GetByID(uint32_t id);
   string Disassemble(const string &entryPoint);
+  // skips the cache, for callers that cache the disassembly themselves under a different key
+  string DisassembleUncached(const string &entryPoint);
 
   void MakeReflection(ShaderStage stage, const string &entryPoint, ShaderReflection &reflection,
                       ShaderBindpointMapping &mapping, SPIRVPatchData &patchData);
+
+private:
+  // the above functions look up their results in the persistent shader analysis cache by the
+  // hash of the SPIR-V and only call these to do the actual work on a miss.
+  void MakeReflectionUncached(ShaderStage stage, const string &entryPoint,
+                              ShaderReflection &reflection, ShaderBindpointMapping &mapping,
+                              SPIRVPatchData &patchData);
+
+  uint64_t GetCacheKey(const char *kind, ShaderStage stage, const string &entryPoint);
 };
 
 string CompileSPIRV(SPIRVShaderStage shadType, const vector<string> &sources,
@@ -26,6 +26,8 @@
 #include <utility>
 #include "api/replay/renderdoc_replay.h"
 #include "common/common.h"
+#include "common/shader_cache.h"
+#include "core/core.h"
 #include "maths/formatpacking.h"
 #include "serialise/serialiser.h"
 #include "spirv_common.h"
@@ -2154,7 +2156,7 @@ void FindFirstInstructionUse(SPVInstruction *op, SPVInstruction *search, SPVInst
   }
 }
 
-string SPVModule::Disassemble(const string &entryPoint)
+string SPVModule::DisassembleUncached(const string &entryPoint)
 {
   string retDisasm = "";
 
@@ -3861,9 +3863,9 @@ void AddSignatureParameter(bool isInput, ShaderStage stage, uint32_t id,
   }
 }
 
-void SPVModule::MakeReflection(ShaderStage stage, const string &entryPoint,
-                               ShaderReflection &reflection, ShaderBindpointMapping &mapping,
-                               SPIRVPatchData &patchData)
+void SPVModule::MakeReflectionUncached(ShaderStage stage, const string &entryPoint,
+                                       ShaderReflection &reflection,
+                                       ShaderBindpointMapping &mapping, SPIRVPatchData &patchData)
 {
   vector<SigParameter> inputs;
   vector<SigParameter> outputs;
@@ -4463,6 +4465,89 @@ void SPVModule::MakeReflection(ShaderStage stage, const string &entryPoint,
   }
 }
 
+// these are defined along with the other replay types in core/replay_proxy.cpp
+template <>
+void Serialiser::Serialise(const char *name, ShaderReflection &el);
+template <>
+void Serialiser::Serialise(const char *name, ShaderBindpointMapping &el);
+
+template <>
+void Serialiser::Serialise(const char *name, SPIRVPatchData::OutputAccess &el)
+{
+  Serialise("", el.ID);
+  Serialise("", el.accessChain);
+}
+
+uint64_t SPVModule::GetCacheKey(const char *kind, ShaderStage stage, const string &entryPoint)
+{
+  uint64_t seed = Hash64(kind, strlen(kind));
+  seed = Hash64(&stage, sizeof(stage), seed);
+  seed = Hash64(entryPoint.c_str(), entryPoint.size(), seed);
+
+  return ShaderAnalysisCache::MakeKey(spirv.data(), spirv.size() * sizeof(uint32_t), seed);
+}
+
+string SPVModule::Disassemble(const string &entryPoint)
+{
+  // only cache on replay, we don't want to add disk I/O to pipeline creation in the application
+  if(spirv.empty() || !RenderDoc::Inst().IsReplayApp())
+    return DisassembleUncached(entryPoint);
+
+  uint64_t key = GetCacheKey("disasm", ShaderStage::Vertex, entryPoint);
+
+  std::vector<byte> blob;
+  if(ShaderAnalysisCache::Fetch(key, blob))
+    return string(blob.begin(), blob.end());
+
+  string ret = DisassembleUncached(entryPoint);
+
+  ShaderAnalysisCache::Store(key, (const byte *)ret.c_str(), ret.size());
+
+  return ret;
+}
+
+void SPVModule::MakeReflection(ShaderStage stage, const string &entryPoint,
+                               ShaderReflection &reflection, ShaderBindpointMapping &mapping,
+                               SPIRVPatchData &patchData)
+{
+  if(spirv.empty() || !RenderDoc::Inst().IsReplayApp())
+  {
+    MakeReflectionUncached(stage, entryPoint, reflection, mapping, patchData);
+    return;
+  }
+
+  uint64_t key = GetCacheKey("reflection", stage, entryPoint);
+
+  std::vector<byte> blob;
+  if(ShaderAnalysisCache::Fetch(key, blob))
+  {
+    Serialiser ser(blob.size(), blob.data(), false);
+
+    ser.Serialise("reflection", reflection);
+    ser.Serialise("mapping", mapping);
+    ser.Serialise("patchData", patchData.outputs);
+
+    if(!ser.HasError())
+      return;
+
+    RDCWARN("Couldn't deserialise cached reflection, regenerating");
+
+    reflection = ShaderReflection();
+    mapping = ShaderBindpointMapping();
+    patchData = SPIRVPatchData();
+  }
+
+  MakeReflectionUncached(stage, entryPoint, reflection, mapping, patchData);
+
+  Serialiser ser(NULL, Serialiser::WRITING, false);
+
+  ser.Serialise("reflection", reflection);
+  ser.Serialise("mapping", mapping);
+  ser.Serialise("patchData", patchData.outputs);
+
+  ShaderAnalysisCache::Store(key, ser.GetRawPtr(0), (size_t)ser.GetOffset());
+}
+
 void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
 {
   if(spirv[0] != (uint32_t)spv::MagicNumber)
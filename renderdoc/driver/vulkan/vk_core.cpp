@@ -170,6 +170,7 @@ VkInitParams::VkInitParams()
 // Here we list which non-current versions we support, and what changed
 const uint32_t VkInitParams::VK_OLD_VERSIONS[VkInitParams::VK_NUM_SUPPORTED_OLD_VERSIONS] = {
     0x0000005,    // from 0x5 to 0x6, we added serialisation of the original swapchain's imageUsage
+    0x0000006,    // from 0x6 to 0x7, initial state data is written as non-zero page spans
 };
 
 ReplayStatus VkInitParams::Serialise()
@@ -256,6 +257,19 @@ void VkInitParams::Set(const VkInstanceCreateInfo *pCreateInfo, ResourceId inst)
   InstanceID = inst;
 }
 
+struct TempMemStatsList
+{
+  Threading::CriticalSection lock;
+  vector<WrappedVulkan::TempMemStats *> stats;
+};
+
+static TempMemStatsList &GetTempMemStatsList()
+{
+  // never freed, the stats are function-local statics that outlive any driver
+  static TempMemStatsList *list = new TempMemStatsList();
+  return *list;
+}
+
 WrappedVulkan::WrappedVulkan(const char *logFilename) : m_RenderState(&m_CreationInfo)
 {
 #if ENABLED(RDOC_RELEASE)
@@ -281,6 +295,7 @@ WrappedVulkan::WrappedVulkan(const char *logFilename) : m_RenderState(&m_Creatio
   {
     m_State = WRITING_IDLE;
     m_pSerialiser = new Serialiser(NULL, Serialiser::WRITING, debugSerialiser);
+    m_pSerialiser->SetDeduplicateBuffers(true);
   }
 
   InitSPIRVCompiler();
@@ -289,6 +304,8 @@ WrappedVulkan::WrappedVulkan(const char *logFilename) : m_RenderState(&m_Creatio
   m_Replay.SetDriver(this);
 
   m_FrameCounter = 0;
+  m_CaptureCount = 0;
+  m_InitStateReadbacks.Reset();
 
   m_AppControlledCapture = false;
 
@@ -378,9 +395,20 @@ WrappedVulkan::~WrappedVulkan()
 
   for(size_t i = 0; i < m_ThreadTempMem.size(); i++)
   {
-    delete[] m_ThreadTempMem[i]->memory;
+    for(size_t b = 0; b < m_ThreadTempMem[i]->blocks.size(); b++)
+      delete[] m_ThreadTempMem[i]->blocks[b].memory;
     delete m_ThreadTempMem[i];
   }
+
+  {
+    TempMemStatsList &list = GetTempMemStatsList();
+
+    SCOPED_LOCK(list.lock);
+    for(size_t i = 0; i < list.stats.size(); i++)
+      if(list.stats[i]->peak > 0)
+        RDCDEBUG("Peak temporary memory in %s: %llu bytes", list.stats[i]->name,
+                 (uint64_t)list.stats[i]->peak);
+  }
 }
 
 VkCommandBuffer WrappedVulkan::GetNextCmd()
@@ -582,6 +610,62 @@ const char *WrappedVulkan::GetChunkName(uint32_t idx)
   return VkChunkNames[idx - FIRST_CHUNK_ID];
 }
 
+ChunkCategory WrappedVulkan::GetChunkCategory(uint32_t idx, const char *&resourceType)
+{
+  switch((VulkanChunkType)idx)
+  {
+    case CAPTURE_SCOPE: return ChunkCategory::CaptureScope;
+
+    case DRAW:
+    case DRAW_INDIRECT:
+    case DRAW_INDEXED:
+    case DRAW_INDEXED_INDIRECT: return ChunkCategory::Drawcall;
+
+    case DISPATCH:
+    case DISPATCH_INDIRECT: return ChunkCategory::Dispatch;
+
+    case CLEAR_COLOR:
+    case CLEAR_DEPTHSTENCIL:
+    case CLEAR_ATTACH:
+    case FILL_BUF: return ChunkCategory::Clear;
+
+    case COPY_BUF2IMG:
+    case COPY_IMG2BUF:
+    case COPY_BUF:
+    case COPY_IMG:
+    case BLIT_IMG:
+    case RESOLVE_IMG: return ChunkCategory::Copy;
+
+    case UNMAP_MEM:
+    case FLUSH_MEM: resourceType = "Memory"; return ChunkCategory::Upload;
+    case UPDATE_BUF: resourceType = "Buffer"; return ChunkCategory::Upload;
+
+    case ALLOC_MEM: resourceType = "Memory"; return ChunkCategory::Resource;
+    case CREATE_BUFFER: resourceType = "Buffer"; return ChunkCategory::Resource;
+    case CREATE_BUFFER_VIEW: resourceType = "Buffer View"; return ChunkCategory::Resource;
+    case CREATE_IMAGE: resourceType = "Image"; return ChunkCategory::Resource;
+    case CREATE_IMAGE_VIEW: resourceType = "Image View"; return ChunkCategory::Resource;
+    case CREATE_SAMPLER: resourceType = "Sampler"; return ChunkCategory::Resource;
+    case CREATE_SHADER_MODULE: resourceType = "Shader Module"; return ChunkCategory::Resource;
+    case CREATE_GRAPHICS_PIPE:
+    case CREATE_COMPUTE_PIPE: resourceType = "Pipeline"; return ChunkCategory::Resource;
+    case CREATE_PIPE_LAYOUT: resourceType = "Pipeline Layout"; return ChunkCategory::Resource;
+    case CREATE_RENDERPASS: resourceType = "Render Pass"; return ChunkCategory::Resource;
+    case CREATE_FRAMEBUFFER: resourceType = "Framebuffer"; return ChunkCategory::Resource;
+    case CREATE_DESCRIPTOR_SET_LAYOUT:
+      resourceType = "Descriptor Set Layout";
+      return ChunkCategory::Resource;
+    case ALLOC_DESC_SET: resourceType = "Descriptor Set"; return ChunkCategory::Resource;
+    case CREATE_QUERY_POOL: resourceType = "Query Pool"; return ChunkCategory::Resource;
+    case CREATE_CMD_BUFFER: resourceType = "Command Buffer"; return ChunkCategory::Resource;
+    case CREATE_SWAP_BUFFER: resourceType = "Swapchain"; return ChunkCategory::Resource;
+
+    default: break;
+  }
+
+  return ChunkCategory::Other;
+}
+
 template <>
 string ToStrHelper<false, VulkanChunkType>::Get(const VulkanChunkType &el)
 {
@@ -609,36 +693,117 @@ void WrappedVulkan::SetDebugMessageSink(WrappedVulkan::ScopedDebugMessageSink *s
   Threading::SetTLSValue(debugMessageSinkTLSSlot, (void *)sink);
 }
 
-byte *WrappedVulkan::GetTempMemory(size_t s)
+// smallest block we allocate for temporary memory, most calls only need a few hundred bytes
+static const size_t TempMemMinBlockSize = 64 * 1024;
+
+WrappedVulkan::TempMem *WrappedVulkan::GetThreadTempMem()
 {
   TempMem *mem = (TempMem *)Threading::GetTLSValue(tempMemoryTLSSlot);
-  if(mem && mem->size >= s)
-    return mem->memory;
+  if(mem)
+    return mem;
+
+  mem = new TempMem();
 
-  // alloc or grow alloc
-  TempMem *newmem = mem;
+  Threading::SetTLSValue(tempMemoryTLSSlot, (void *)mem);
 
-  if(!newmem)
-    newmem = new TempMem();
+  // save it for deletion on shutdown
+  {
+    SCOPED_LOCK(m_ThreadTempMemLock);
+    m_ThreadTempMem.push_back(mem);
+  }
+
+  return mem;
+}
+
+byte *WrappedVulkan::GetTempMemory(size_t s)
+{
+  TempMem *mem = GetThreadTempMem();
 
-  // free old memory, don't need to keep contents
-  if(newmem->memory)
-    delete[] newmem->memory;
+  RDCASSERTMSG("Temporary memory allocated outside of SCOPED_TEMP_MEMORY()", mem->depth > 0);
 
-  // alloc new memory
-  newmem->size = s;
-  newmem->memory = new byte[s];
+  // keep every allocation aligned for any structure that might be copied into it
+  s = AlignUp16(s);
 
-  Threading::SetTLSValue(tempMemoryTLSSlot, (void *)newmem);
+  mem->used += s;
 
-  // if this is entirely new, save it for deletion on shutdown
-  if(!mem)
+  // use the current block if there's space, or a later block left over from a previous scope
+  while(mem->block < mem->blocks.size())
   {
-    SCOPED_LOCK(m_ThreadTempMemLock);
-    m_ThreadTempMem.push_back(newmem);
+    TempMem::Block &b = mem->blocks[mem->block];
+
+    if(mem->offset + s <= b.size)
+    {
+      byte *ret = b.memory + mem->offset;
+      mem->offset += s;
+      return ret;
+    }
+
+    mem->block++;
+    mem->offset = 0;
   }
 
-  return newmem->memory;
+  // start a new block. Earlier blocks can't be resized as previous allocations may be live
+  TempMem::Block b;
+  b.size = RDCMAX(s, RDCMAX(mem->used, TempMemMinBlockSize));
+  b.memory = new byte[b.size];
+
+  mem->blocks.push_back(b);
+  mem->block = mem->blocks.size() - 1;
+  mem->offset = s;
+
+  return b.memory;
+}
+
+WrappedVulkan::TempMemStats::TempMemStats(const char *n) : name(n), peak(0)
+{
+  TempMemStatsList &list = GetTempMemStatsList();
+
+  SCOPED_LOCK(list.lock);
+  list.stats.push_back(this);
+}
+
+WrappedVulkan::ScopedTempMemory::ScopedTempMemory(WrappedVulkan *driver, TempMemStats &s)
+    : mem(driver->GetThreadTempMem()), stats(s)
+{
+  block = mem->block;
+  offset = mem->offset;
+  used = mem->used;
+
+  mem->depth++;
+}
+
+WrappedVulkan::ScopedTempMemory::~ScopedTempMemory()
+{
+  // stats are only for tuning, so a racy update from different threads doesn't matter
+  size_t scopeUsed = mem->used - used;
+  if(scopeUsed > stats.peak)
+    stats.peak = scopeUsed;
+
+  mem->block = block;
+  mem->offset = offset;
+  mem->used = used;
+
+  mem->depth--;
+
+  // once nothing is live, replace multiple blocks with one big enough for all of them, so we
+  // settle on a single block sized for the largest usage
+  if(mem->depth == 0 && mem->blocks.size() > 1)
+  {
+    TempMem::Block b = {NULL, 0};
+
+    for(size_t i = 0; i < mem->blocks.size(); i++)
+    {
+      b.size += mem->blocks[i].size;
+      delete[] mem->blocks[i].memory;
+    }
+
+    b.memory = new byte[b.size];
+
+    mem->blocks.clear();
+    mem->blocks.push_back(b);
+    mem->block = 0;
+    mem->offset = 0;
+  }
 }
 
 Serialiser *WrappedVulkan::GetThreadSerialiser()
@@ -657,6 +822,7 @@ Serialiser *WrappedVulkan::GetThreadSerialiser()
 
   ser = new Serialiser(NULL, Serialiser::WRITING, debugSerialiser);
   ser->SetUserData(m_ResourceManager);
+  ser->SetDeduplicateBuffers(true);
 
   ser->SetChunkNameLookup(&GetChunkName);
 
@@ -670,6 +836,29 @@ Serialiser *WrappedVulkan::GetThreadSerialiser()
   return ser;
 }
 
+void WrappedVulkan::MarkDescSetReferenced(DescriptorSetData *descInfo)
+{
+  // marking the same refs twice has no further effect, so if the set hasn't changed since it was
+  // last marked in this capture there's nothing to do
+  if(descInfo->markedCapture == m_CaptureCount &&
+     descInfo->markedGeneration == descInfo->flatGeneration)
+    return;
+
+  for(size_t i = 0; i < descInfo->flatFrameRefs.size(); i++)
+    GetResourceManager()->MarkResourceFrameReferenced(descInfo->flatFrameRefs[i].first,
+                                                      descInfo->flatFrameRefs[i].second);
+
+  for(size_t i = 0; i < descInfo->flatSparseRefs.size(); i++)
+  {
+    VkResourceRecord *record = GetResourceManager()->GetResourceRecord(descInfo->flatSparseRefs[i]);
+
+    GetResourceManager()->MarkSparseMapReferenced(record->sparseInfo);
+  }
+
+  descInfo->markedGeneration = descInfo->flatGeneration;
+  descInfo->markedCapture = m_CaptureCount;
+}
+
 static VkResult FillPropertyCountAndList(const VkExtensionProperties *src, uint32_t numExts,
                                          uint32_t *dstCount, VkExtensionProperties *dstProps)
 {
@@ -1053,7 +1242,7 @@ bool WrappedVulkan::Serialise_BeginCaptureFrame(bool applyInitialState)
   vector<VkImageMemoryBarrier> imgBarriers;
 
   {
-    SCOPED_LOCK(m_ImageLayoutsLock);    // not needed on replay, but harmless also
+    SCOPED_WRITELOCK(m_ImageLayoutsLock);    // not needed on replay, but harmless also
     GetResourceManager()->SerialiseImageStates(m_ImageLayouts, imgBarriers);
   }
 
@@ -1138,6 +1327,10 @@ void WrappedVulkan::StartFrameCapture(void *dev, void *wnd)
     SCOPED_LOCK(m_CapTransitionLock);
     GetResourceManager()->PrepareInitialContents();
 
+    // submit the readbacks but don't wait for them here, they are synced before the
+    // application can next modify anything on the GPU
+    KickInitialStateReadbacks();
+
     RDCDEBUG("Attempting capture");
     m_FrameCaptureRecord->DeleteChunks();
 
@@ -1154,6 +1347,8 @@ void WrappedVulkan::StartFrameCapture(void *dev, void *wnd)
       m_HeaderChunk = scope.Get();
     }
 
+    m_CaptureCount++;
+
     m_State = WRITING_CAPFRAME;
   }
 
@@ -1230,6 +1425,9 @@ bool WrappedVulkan::EndFrameCapture(void *dev, void *wnd)
     SCOPED_LOCK(m_CapTransitionLock);
     EndCaptureFrame(backbuffer);
 
+    // normally this has already happened on the first submit in the frame
+    SyncInitialStateReadbacks();
+
     m_State = WRITING_IDLE;
 
     // m_SuccessfulCapture = false;
@@ -1850,6 +2048,8 @@ void WrappedVulkan::ContextReplayLog(LogState readType, uint32_t startEventID, u
 
     std::sort(m_Events.begin(), m_Events.end(), SortEID());
     m_ParentDrawcall.children.clear();
+
+    m_ResourceUsage.Build(m_ResourceUses);
   }
 
   ObjDisp(GetDev())->DeviceWaitIdle(Unwrap(GetDev()));
@@ -2466,6 +2666,14 @@ void WrappedVulkan::ReplayLog(uint32_t startEventID, uint32_t endEventID, Replay
   }
 }
 
+void WrappedVulkan::FlushDeferredCommand(VkResourceRecord *record)
+{
+  const CaptureOptions &opts = RenderDoc::Inst().GetCaptureOptions();
+
+  if(opts.CaptureCallstacks || opts.APIValidation)
+    record->ExpandDeferredCommands(this);
+}
+
 void WrappedVulkan::Serialise_DebugMessages(Serialiser *localSerialiser, bool isDrawcall)
 {
   SCOPED_SERIALISE_CONTEXT(DEBUG_MESSAGES);
@@ -44,10 +44,10 @@ struct VkInitParams : public RDCInitParams
 
   void Set(const VkInstanceCreateInfo *pCreateInfo, ResourceId inst);
 
-  static const uint32_t VK_SERIALISE_VERSION = 0x0000006;
+  static const uint32_t VK_SERIALISE_VERSION = 0x0000007;
 
   // backwards compatibility for old logs described at the declaration of this array
-  static const uint32_t VK_NUM_SUPPORTED_OLD_VERSIONS = 1;
+  static const uint32_t VK_NUM_SUPPORTED_OLD_VERSIONS = 2;
   static const uint32_t VK_OLD_VERSIONS[VK_NUM_SUPPORTED_OLD_VERSIONS];
 
   // version number internal to vulkan stream
@@ -228,15 +228,53 @@ private:
   Threading::CriticalSection m_ThreadSerialisersLock;
   vector<Serialiser *> m_ThreadSerialisers;
 
+  // thread-local temporary memory is a linear allocator. Memory returned from GetTempMemory()
+  // stays valid until the enclosing SCOPED_TEMP_MEMORY() exits, so wrapped functions that call
+  // into other wrapped functions don't clobber each other's unwrapped arrays.
   uint64_t tempMemoryTLSSlot;
   struct TempMem
   {
-    TempMem() : memory(NULL), size(0) {}
-    byte *memory;
-    size_t size;
+    TempMem() : block(0), offset(0), used(0), depth(0) {}
+    struct Block
+    {
+      byte *memory;
+      size_t size;
+    };
+    // blocks are never reallocated while a scope is open, instead allocations that don't fit
+    // start a new block. Once the outermost scope exits they are coalesced into one block.
+    vector<Block> blocks;
+    size_t block, offset;
+    // total bytes allocated in all blocks and the number of open scopes
+    size_t used;
+    uint32_t depth;
   };
   Threading::CriticalSection m_ThreadTempMemLock;
   vector<TempMem *> m_ThreadTempMem;
+  TempMem *GetThreadTempMem();
+
+  // peak temporary memory used by each function using SCOPED_TEMP_MEMORY(), reported on
+  // shutdown for tuning
+  struct TempMemStats
+  {
+    TempMemStats(const char *n);
+    const char *name;
+    size_t peak;
+  };
+  friend struct TempMemStatsList;
+
+  struct ScopedTempMemory
+  {
+    ScopedTempMemory(WrappedVulkan *driver, TempMemStats &stats);
+    ~ScopedTempMemory();
+
+    TempMem *mem;
+    TempMemStats &stats;
+    size_t block, offset, used;
+  };
+
+#define SCOPED_TEMP_MEMORY()                           \
+  static TempMemStats temp_memory_stats(__FUNCTION__); \
+  ScopedTempMemory temp_memory_scope(this, temp_memory_stats);
 
   VulkanReplay m_Replay;
 
@@ -270,6 +308,10 @@ private:
 
   uint32_t m_FrameCounter;
 
+  // incremented each time a capture starts, so per-resource state can tell
+  // which capture it was last updated in
+  uint32_t m_CaptureCount;
+
   vector<FrameDescription> m_CapturedFrames;
   FrameRecord m_FrameRecord;
   vector<DrawcallDescription *> m_Drawcalls;
@@ -378,6 +420,40 @@ private:
   vector<VkDeviceMemory> m_CleanupMems;
   vector<VkEvent> m_CleanupEvents;
 
+  // initial state readbacks are recorded when a capture starts but not waited on per-resource.
+  // Copies are submitted in batches and a single fence is submitted once all resources are
+  // prepared. The temporary objects the copies use are kept here until that fence has been
+  // waited on in SyncInitialStateReadbacks(), which happens lazily the first time the
+  // application could modify the source data (or when the capture ends).
+  struct
+  {
+    void Reset()
+    {
+      fence = VK_NULL_HANDLE;
+      inFlight = 0;
+      hostMapped = false;
+      batchBytes = 0;
+      buffers.clear();
+      images.clear();
+    }
+
+    VkFence fence;
+    volatile int32_t inFlight;
+    // set if a prepared memory object was mapped, so the host can write to it without any
+    // further API call that we could sync on
+    bool hostMapped;
+    VkDeviceSize batchBytes;
+
+    vector<VkBuffer> buffers;
+    vector<pair<VkImage, VkDeviceMemory> > images;
+
+    Threading::CriticalSection lock;
+  } m_InitStateReadbacks;
+
+  void AddInitialStateReadback(VkDeviceSize size);
+  void KickInitialStateReadbacks();
+  void SyncInitialStateReadbacks();
+
   const VkPhysicalDeviceProperties &GetDeviceProps() { return m_PhysicalDeviceData.props; }
   VkDriverInfo GetDriverVersion() { return VkDriverInfo(m_PhysicalDeviceData.props); }
   const VkFormatProperties &GetFormatProperties(VkFormat f)
@@ -568,9 +644,11 @@ private:
   Threading::CriticalSection m_CoherentMapsLock;
 
   // used both on capture and replay side to track image layouts. Only locked
-  // in capture
+  // in capture - recording barriers into a command buffer only reads image
+  // dimensions so can share the lock, anything that changes the layouts or
+  // adds/removes images must take it exclusively.
   map<ResourceId, ImageLayouts> m_ImageLayouts;
-  Threading::CriticalSection m_ImageLayoutsLock;
+  Threading::RWLock m_ImageLayoutsLock;
 
   // find swapchain for an image
   map<RENDERDOC_WindowHandle, VkSwapchainKHR> m_SwapLookup;
@@ -585,9 +663,11 @@ private:
   // immutable creation data
   VulkanCreationInfo m_CreationInfo;
 
+  // usages are accumulated here during the initial read, then packed into m_ResourceUsage
   map<ResourceId, vector<EventUsage> > m_ResourceUses;
+  ResourceUsageIndex m_ResourceUsage;
 
-  // returns thread-local temporary memory
+  // returns thread-local temporary memory, valid until the current SCOPED_TEMP_MEMORY() exits
   byte *GetTempMemory(size_t s);
   template <class T>
   T *GetTempArray(uint32_t arraycount)
@@ -596,6 +676,36 @@ private:
   }
 
   Serialiser *GetThreadSerialiser();
+
+  // mark a descriptor set's bound resources as frame referenced, see DescriptorSetData
+  void MarkDescSetReferenced(DescriptorSetData *descInfo);
+
+  // serialise a command recorded into a DeferredCmdStream, see vk_resources.h. Each is defined
+  // alongside the command's wrapper.
+  static Chunk *Expand_vkCmdDraw(WrappedVulkan *driver, const byte *args);
+  static Chunk *Expand_vkCmdDrawIndexed(WrappedVulkan *driver, const byte *args);
+  static Chunk *Expand_vkCmdDrawIndirect(WrappedVulkan *driver, const byte *args);
+  static Chunk *Expand_vkCmdDrawIndexedIndirect(WrappedVulkan *driver, const byte *args);
+  static Chunk *Expand_vkCmdDispatch(WrappedVulkan *driver, const byte *args);
+  static Chunk *Expand_vkCmdDispatchIndirect(WrappedVulkan *driver, const byte *args);
+  static Chunk *Expand_vkCmdBindPipeline(WrappedVulkan *driver, const byte *args);
+  static Chunk *Expand_vkCmdBindIndexBuffer(WrappedVulkan *driver, const byte *args);
+  static Chunk *Expand_vkCmdBindVertexBuffers(WrappedVulkan *driver, const byte *args);
+  static Chunk *Expand_vkCmdBindDescriptorSets(WrappedVulkan *driver, const byte *args);
+  static Chunk *Expand_vkCmdPushConstants(WrappedVulkan *driver, const byte *args);
+  static Chunk *Expand_vkCmdSetViewport(WrappedVulkan *driver, const byte *args);
+  static Chunk *Expand_vkCmdSetScissor(WrappedVulkan *driver, const byte *args);
+  static Chunk *Expand_vkCmdSetLineWidth(WrappedVulkan *driver, const byte *args);
+  static Chunk *Expand_vkCmdSetDepthBias(WrappedVulkan *driver, const byte *args);
+  static Chunk *Expand_vkCmdSetBlendConstants(WrappedVulkan *driver, const byte *args);
+  static Chunk *Expand_vkCmdSetDepthBounds(WrappedVulkan *driver, const byte *args);
+  static Chunk *Expand_vkCmdSetStencilCompareMask(WrappedVulkan *driver, const byte *args);
+  static Chunk *Expand_vkCmdSetStencilWriteMask(WrappedVulkan *driver, const byte *args);
+  static Chunk *Expand_vkCmdSetStencilReference(WrappedVulkan *driver, const byte *args);
+
+  // a chunk's callstack and debug messages are gathered when it's serialised, so while either is
+  // enabled the command just deferred into the record is serialised immediately instead.
+  void FlushDeferredCommand(VkResourceRecord *record);
   Serialiser *GetMainSerialiser() { return m_pSerialiser; }
   void Serialise_CaptureScope(uint64_t offset);
   bool HasSuccessfulCapture();
@@ -625,6 +735,7 @@ private:
                                           VulkanResourceManager::InitialContentData contents);
   bool Serialise_SparseImageInitialState(ResourceId id,
                                          VulkanResourceManager::InitialContentData contents);
+  void SerialiseInitialData(byte *ptr, VkDeviceSize size);
   bool Apply_SparseInitialState(WrappedVkBuffer *buf,
                                 VulkanResourceManager::InitialContentData contents);
   bool Apply_SparseInitialState(WrappedVkImage *im,
@@ -691,6 +802,7 @@ public:
 
   ResourceId GetContextResourceID() { return m_FrameCaptureRecord->GetResourceID(); }
   static const char *GetChunkName(uint32_t idx);
+  static ChunkCategory GetChunkCategory(uint32_t idx, const char *&resourceType);
   VulkanResourceManager *GetResourceManager() { return m_ResourceManager; }
   VulkanDebugManager *GetDebugManager() { return m_DebugManager; }
   LogState GetState() { return m_State; }
@@ -714,7 +826,11 @@ public:
   uint32_t GetMaxEID() { return m_Events.back().eventID; }
   const DrawcallDescription *GetDrawcall(uint32_t eventID);
 
-  vector<EventUsage> GetUsage(ResourceId id) { return m_ResourceUses[id]; }
+  vector<EventUsage> GetUsage(ResourceId id, uint32_t minEventID, uint32_t maxEventID,
+                              uint64_t usageMask)
+  {
+    return m_ResourceUsage.Query(id, minEventID, maxEventID, usageMask);
+  }
   // return the pre-selected device and queue
   VkDevice GetDev()
   {
@@ -160,11 +160,106 @@ void InitDeviceExtensionTables(VkDevice device)
 
 #undef DeviceGPA
 
-static Threading::CriticalSection devlock;
-std::map<void *, VkLayerDispatchTableExtended> devlookup;
+// Maps from a dispatchable handle's loader key to its dispatch table. Looked up on every call
+// through ObjDisp() so reads must be cheap and never block. The tables themselves live in a map
+// that only grows, so their addresses are stable. Every insertion builds a new immutable
+// open-addressing index over them and publishes it with a single pointer swap. Readers load the
+// current index and probe it without taking any lock.
+//
+// Old indices are retired but never freed, as a reader may still be probing one. Devices and
+// instances are created a handful of times per process so this is bounded and small.
+template <typename TableType>
+class DispatchTableLookup
+{
+public:
+  DispatchTableLookup() : m_Current(NULL) {}
+  TableType *Insert(void *key)
+  {
+    SCOPED_LOCK(m_Lock);
+
+    TableType *table = &m_Tables[key];
+    RDCEraseEl(*table);
+
+    // keep the load factor at or below 50% so probes are short
+    size_t capacity = 8;
+    while(capacity < m_Tables.size() * 2)
+      capacity *= 2;
+
+    Index *index = new Index;
+    index->mask = capacity - 1;
+    index->entries.resize(capacity);
+
+    for(auto it = m_Tables.begin(); it != m_Tables.end(); ++it)
+    {
+      size_t slot = Hash(it->first) & index->mask;
+      while(index->entries[slot].key != NULL)
+        slot = (slot + 1) & index->mask;
+
+      index->entries[slot].key = it->first;
+      index->entries[slot].table = &it->second;
+    }
+
+    // full barrier, so the index contents are visible before the pointer is. Only one writer can
+    // be here at once so this never fails.
+    Index *prev = m_Current;
+    Atomic::CmpExchPtr((void *volatile *)&m_Current, prev, index);
+
+    if(prev)
+      m_Retired.push_back(prev);
+
+    return table;
+  }
+
+  TableType *Find(void *key) const
+  {
+    // readers only dereference through the pointer they loaded, so the address dependency orders
+    // these loads after the publishing barrier above.
+    const Index *index = m_Current;
+
+    if(index == NULL)
+      return NULL;
+
+    size_t slot = Hash(key) & index->mask;
+    for(;;)
+    {
+      const Entry &e = index->entries[slot];
+      if(e.key == key)
+        return e.table;
+      if(e.key == NULL)
+        return NULL;
+      slot = (slot + 1) & index->mask;
+    }
+  }
+
+private:
+  struct Entry
+  {
+    Entry() : key(NULL), table(NULL) {}
+    void *key;
+    TableType *table;
+  };
+
+  struct Index
+  {
+    size_t mask;
+    std::vector<Entry> entries;
+  };
 
-static Threading::CriticalSection instlock;
-std::map<void *, VkLayerInstanceDispatchTableExtended> instlookup;
+  static size_t Hash(void *key)
+  {
+    // keys are heap pointers, so the low bits carry little information
+    uint64_t k = (uint64_t)(uintptr_t)key;
+    return (size_t)((k * 0x9E3779B97F4A7C15ULL) >> 32);
+  }
+
+  Threading::CriticalSection m_Lock;
+  std::map<void *, TableType> m_Tables;
+  std::vector<Index *> m_Retired;
+  Index *volatile m_Current;
+};
+
+static DispatchTableLookup<VkLayerDispatchTableExtended> devlookup;
+static DispatchTableLookup<VkLayerInstanceDispatchTableExtended> instlookup;
 
 static void *GetKey(void *obj)
 {
@@ -176,13 +271,7 @@ void InitDeviceTable(VkDevice dev, PFN_vkGetDeviceProcAddr gpa)
 {
   void *key = GetKey(dev);
 
-  VkLayerDispatchTableExtended *table = NULL;
-
-  {
-    SCOPED_LOCK(devlock);
-    RDCEraseEl(devlookup[key]);
-    table = &devlookup[key];
-  }
+  VkLayerDispatchTableExtended *table = devlookup.Insert(key);
 
   table->GetDeviceProcAddr = gpa;
 
@@ -199,13 +288,7 @@ void InitInstanceTable(VkInstance inst, PFN_vkGetInstanceProcAddr gpa)
 {
   void *key = GetKey(inst);
 
-  VkLayerInstanceDispatchTableExtended *table = NULL;
-
-  {
-    SCOPED_LOCK(instlock);
-    RDCEraseEl(instlookup[key]);
-    table = &instlookup[key];
-  }
+  VkLayerInstanceDispatchTableExtended *table = instlookup.Insert(key);
 
   // init the GetInstanceProcAddr function first
   table->GetInstanceProcAddr = gpa;
@@ -228,18 +311,12 @@ VkLayerDispatchTableExtended *GetDeviceDispatchTable(void *device)
   if(replay)
     return &replayDeviceTable;
 
-  void *key = GetKey(device);
-
-  {
-    SCOPED_LOCK(devlock);
+  VkLayerDispatchTableExtended *table = devlookup.Find(GetKey(device));
 
-    auto it = devlookup.find(key);
+  if(table == NULL)
+    RDCFATAL("Bad device pointer");
 
-    if(it == devlookup.end())
-      RDCFATAL("Bad device pointer");
-
-    return &it->second;
-  }
+  return table;
 }
 
 VkLayerInstanceDispatchTableExtended *GetInstanceDispatchTable(void *instance)
@@ -247,16 +324,10 @@ VkLayerInstanceDispatchTableExtended *GetInstanceDispatchTable(void *instance)
   if(replay)
     return &replayInstanceTable;
 
-  void *key = GetKey(instance);
+  VkLayerInstanceDispatchTableExtended *table = instlookup.Find(GetKey(instance));
 
-  {
-    SCOPED_LOCK(instlock);
-
-    auto it = instlookup.find(key);
+  if(table == NULL)
+    RDCFATAL("Bad device pointer");
 
-    if(it == instlookup.end())
-      RDCFATAL("Bad device pointer");
-
-    return &it->second;
-  }
+  return table;
 }
@@ -34,12 +34,11 @@
 // VKTODOLOW The code pattern for creating a few contiguous arrays all in one
 // AllocAlignedBuffer for the initial contents buffer is ugly.
 
-// VKTODOLOW in general we do a lot of "create buffer, use it, flush/sync then destroy".
-// I don't know what the exact cost is, but it would be nice to batch up the buffers/etc
-// used across init state use, and only do a single flush. Also we could then get some
-// nice command buffer reuse (although need to be careful we don't create too large a
-// command buffer that stalls the GPU).
-// See INITSTATEBATCH
+// On capture, Prepare_*InitialState records its copies into internal command buffers and
+// hands the temporary objects to AddInitialStateReadback() instead of flushing per resource.
+// The copies are submitted in batches and only waited on in SyncInitialStateReadbacks().
+// VKTODOLOW on replay we still do "create buffer, use it, flush/sync then destroy" per
+// resource, that could be batched the same way. See INITSTATEBATCH
 
 struct MemIDOffset
 {
@@ -115,7 +114,6 @@ bool WrappedVulkan::Prepare_SparseInitialState(WrappedVkBuffer *buf)
   memcpy(binds, &buf->record->sparseInfo->opaquemappings[0], sizeof(VkSparseMemoryBind) * numElems);
 
   VkDevice d = GetDev();
-  // INITSTATEBATCH
   VkCommandBuffer cmd = GetNextCmd();
 
   VkBufferCreateInfo bufInfo = {
@@ -198,17 +196,20 @@ bool WrappedVulkan::Prepare_SparseInitialState(WrappedVkBuffer *buf)
     ObjDisp(d)->CmdCopyBuffer(Unwrap(cmd), srcBuf, dstBuf, 1, &region);
 
     bufdeletes.push_back(srcBuf);
+
+    MemMapState *mapState = GetRecord(it->first)->memMapState;
+    if(mapState && mapState->mappedPtr)
+      m_InitStateReadbacks.hostMapped = true;
   }
 
   vkr = ObjDisp(d)->EndCommandBuffer(Unwrap(cmd));
   RDCASSERTEQUAL(vkr, VK_SUCCESS);
 
-  // INITSTATEBATCH
-  SubmitCmds();
-  FlushQ();
+  // the buffers are destroyed once the copies have completed
+  m_InitStateReadbacks.buffers.insert(m_InitStateReadbacks.buffers.end(), bufdeletes.begin(),
+                                      bufdeletes.end());
 
-  for(size_t i = 0; i < bufdeletes.size(); i++)
-    ObjDisp(d)->DestroyBuffer(Unwrap(d), bufdeletes[i], NULL);
+  AddInitialStateReadback(info->totalSize);
 
   GetResourceManager()->SetInitialContents(
       id, VulkanResourceManager::InitialContentData(GetWrapped(readbackmem), 0, (byte *)info));
@@ -290,7 +291,6 @@ bool WrappedVulkan::Prepare_SparseInitialState(WrappedVkImage *im)
   }
 
   VkDevice d = GetDev();
-  // INITSTATEBATCH
   VkCommandBuffer cmd = GetNextCmd();
 
   VkBufferCreateInfo bufInfo = {
@@ -373,17 +373,20 @@ bool WrappedVulkan::Prepare_SparseInitialState(WrappedVkImage *im)
     ObjDisp(d)->CmdCopyBuffer(Unwrap(cmd), srcBuf, dstBuf, 1, &region);
 
     bufdeletes.push_back(srcBuf);
+
+    MemMapState *mapState = GetRecord(it->first)->memMapState;
+    if(mapState && mapState->mappedPtr)
+      m_InitStateReadbacks.hostMapped = true;
   }
 
   vkr = ObjDisp(d)->EndCommandBuffer(Unwrap(cmd));
   RDCASSERTEQUAL(vkr, VK_SUCCESS);
 
-  // INITSTATEBATCH
-  SubmitCmds();
-  FlushQ();
+  // the buffers are destroyed once the copies have completed
+  m_InitStateReadbacks.buffers.insert(m_InitStateReadbacks.buffers.end(), bufdeletes.begin(),
+                                      bufdeletes.end());
 
-  for(size_t i = 0; i < bufdeletes.size(); i++)
-    ObjDisp(d)->DestroyBuffer(Unwrap(d), bufdeletes[i], NULL);
+  AddInitialStateReadback(state->totalSize);
 
   GetResourceManager()->SetInitialContents(
       id, VulkanResourceManager::InitialContentData(GetWrapped(readbackmem), 0, (byte *)blob));
@@ -391,6 +394,127 @@ bool WrappedVulkan::Prepare_SparseInitialState(WrappedVkImage *im)
   return true;
 }
 
+// granularity at which initial state data is checked for zeros. Zero runs shorter than this are
+// written out as-is, so the data isn't fragmented into lots of tiny buffers
+static const VkDeviceSize InitialDataPageSize = 4096;
+
+// limit on a single span, as buffers are serialised with 32-bit lengths
+static const VkDeviceSize InitialDataMaxSpan = 0x40000000;
+
+static bool IsZeroPage(const byte *data, size_t size)
+{
+  // mapped memory and page offsets are always at least 8-byte aligned
+  const uint64_t *words = (const uint64_t *)data;
+  size_t numWords = size / sizeof(uint64_t);
+
+  for(size_t i = 0; i < numWords; i++)
+    if(words[i] != 0)
+      return false;
+
+  for(size_t i = numWords * sizeof(uint64_t); i < size; i++)
+    if(data[i] != 0)
+      return false;
+
+  return true;
+}
+
+void WrappedVulkan::SerialiseInitialData(byte *ptr, VkDeviceSize size)
+{
+  // older logs wrote the whole data as one buffer
+  if(GetLogVersion() < 0x0000007)
+  {
+    size_t dummy = (size_t)size;
+    m_pSerialiser->SerialiseBuffer("data", ptr, dummy);
+    return;
+  }
+
+  // Initial contents are frequently mostly zero - freshly allocated memory, or memory that is
+  // only partly bound to resources. So we write a list of the non-zero spans (as offset/length
+  // pairs), then each span's data. On replay the data is read straight into the mapped upload
+  // memory and the gaps in between are cleared.
+  vector<uint64_t> spans;
+
+  if(m_State >= WRITING)
+  {
+    for(VkDeviceSize offs = 0; offs < size; offs += InitialDataPageSize)
+    {
+      VkDeviceSize len = RDCMIN(InitialDataPageSize, size - offs);
+
+      if(IsZeroPage(ptr + offs, (size_t)len))
+        continue;
+
+      // extend the previous span if this page follows on directly from it
+      if(!spans.empty() && spans[spans.size() - 2] + spans.back() == offs &&
+         spans.back() < InitialDataMaxSpan)
+      {
+        spans.back() += len;
+      }
+      else
+      {
+        spans.push_back(offs);
+        spans.push_back(len);
+      }
+    }
+  }
+
+  uint64_t *spanData = spans.empty() ? NULL : &spans[0];
+  uint32_t numSpanWords = (uint32_t)spans.size();
+
+  m_pSerialiser->SerialisePODArray("spans", spanData, numSpanWords);
+
+  if(m_State < WRITING && spanData)
+  {
+    spans.assign(spanData, spanData + numSpanWords);
+    delete[] spanData;
+  }
+
+  VkDeviceSize zeroStart = 0;
+
+  for(size_t i = 0; i + 1 < spans.size(); i += 2)
+  {
+    VkDeviceSize offs = spans[i];
+    size_t len = (size_t)spans[i + 1];
+
+    if(offs < zeroStart || offs + len > size)
+    {
+      RDCERR("Invalid initial data span %llu-%llu in %llu bytes", offs, offs + len, size);
+      break;
+    }
+
+    if(m_State >= WRITING)
+    {
+      byte *data = ptr + offs;
+      m_pSerialiser->SerialiseBuffer("data", data, len);
+    }
+    else
+    {
+      memset(ptr + zeroStart, 0, (size_t)(offs - zeroStart));
+
+      // the stored length comes from the capture, so read into a separate allocation and only copy
+      // it into the span once it's known to fit
+      byte *data = NULL;
+      size_t dataLen = 0;
+      m_pSerialiser->SerialiseBuffer("data", data, dataLen);
+
+      if(dataLen != len)
+      {
+        RDCERR("Initial data span at %llu has %llu bytes, expected %llu", offs, (uint64_t)dataLen,
+               (uint64_t)len);
+        SAFE_DELETE_ARRAY(data);
+        break;
+      }
+
+      memcpy(ptr + offs, data, len);
+      SAFE_DELETE_ARRAY(data);
+    }
+
+    zeroStart = offs + len;
+  }
+
+  if(m_State < WRITING && zeroStart < size)
+    memset(ptr + zeroStart, 0, (size_t)(size - zeroStart));
+}
+
 bool WrappedVulkan::Serialise_SparseBufferInitialState(
     ResourceId id, VulkanResourceManager::InitialContentData contents)
 {
@@ -413,10 +537,8 @@ bool WrappedVulkan::Serialise_SparseBufferInitialState(
     ObjDisp(d)->MapMemory(Unwrap(d), ToHandle<VkDeviceMemory>(contents.resource), 0, VK_WHOLE_SIZE,
                           0, (void **)&ptr);
 
-    size_t dataSize = (size_t)info->totalSize;
-
     m_pSerialiser->Serialise("totalSize", info->totalSize);
-    m_pSerialiser->SerialiseBuffer("data", ptr, dataSize);
+    SerialiseInitialData(ptr, info->totalSize);
 
     ObjDisp(d)->UnmapMemory(Unwrap(d), ToHandle<VkDeviceMemory>(contents.resource));
   }
@@ -510,8 +632,7 @@ bool WrappedVulkan::Serialise_SparseBufferInitialState(
     byte *ptr = NULL;
     ObjDisp(d)->MapMemory(Unwrap(d), Unwrap(mem), 0, VK_WHOLE_SIZE, 0, (void **)&ptr);
 
-    size_t dummy = 0;
-    m_pSerialiser->SerialiseBuffer("data", ptr, dummy);
+    SerialiseInitialData(ptr, info->totalSize);
 
     ObjDisp(d)->UnmapMemory(Unwrap(d), Unwrap(mem));
 
@@ -564,10 +685,8 @@ bool WrappedVulkan::Serialise_SparseImageInitialState(ResourceId id,
     ObjDisp(d)->MapMemory(Unwrap(d), ToHandle<VkDeviceMemory>(contents.resource), 0, VK_WHOLE_SIZE,
                           0, (void **)&ptr);
 
-    size_t dataSize = (size_t)state->totalSize;
-
     m_pSerialiser->Serialise("totalSize", state->totalSize);
-    m_pSerialiser->SerialiseBuffer("data", ptr, dataSize);
+    SerialiseInitialData(ptr, state->totalSize);
 
     ObjDisp(d)->UnmapMemory(Unwrap(d), ToHandle<VkDeviceMemory>(contents.resource));
   }
@@ -719,8 +838,7 @@ bool WrappedVulkan::Serialise_SparseImageInitialState(ResourceId id,
     byte *ptr = NULL;
     ObjDisp(d)->MapMemory(Unwrap(d), Unwrap(mem), 0, VK_WHOLE_SIZE, 0, (void **)&ptr);
 
-    size_t dummy = 0;
-    m_pSerialiser->SerialiseBuffer("data", ptr, dummy);
+    SerialiseInitialData(ptr, state->totalSize);
 
     ObjDisp(d)->UnmapMemory(Unwrap(d), Unwrap(mem));
 
@@ -974,6 +1092,90 @@ bool WrappedVulkan::Apply_SparseInitialState(WrappedVkImage *im,
   return true;
 }
 
+// how much readback data to accumulate in recorded command buffers before submitting them, so
+// the GPU starts copying while we're still preparing the remaining resources
+static const VkDeviceSize InitialStateBatchSize = 64 * 1024 * 1024;
+
+void WrappedVulkan::AddInitialStateReadback(VkDeviceSize size)
+{
+  m_InitStateReadbacks.batchBytes += size;
+
+  if(m_InitStateReadbacks.batchBytes >= InitialStateBatchSize)
+  {
+    SubmitCmds();
+    m_InitStateReadbacks.batchBytes = 0;
+  }
+}
+
+void WrappedVulkan::KickInitialStateReadbacks()
+{
+  SubmitCmds();
+  m_InitStateReadbacks.batchBytes = 0;
+
+  // nothing was read back (or we've already synced)
+  if(m_InitStateReadbacks.buffers.empty() && m_InitStateReadbacks.images.empty())
+    return;
+
+  VkDevice d = GetDev();
+  VkResult vkr = VK_SUCCESS;
+
+  if(m_InitStateReadbacks.fence == VK_NULL_HANDLE)
+  {
+    VkFenceCreateInfo fenceInfo = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO, NULL, 0};
+
+    // not wrapped, this is only ever used internally
+    vkr = ObjDisp(d)->CreateFence(Unwrap(d), &fenceInfo, NULL, &m_InitStateReadbacks.fence);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+  }
+
+  // an empty submit, the fence signals once all the batches submitted above have completed
+  vkr = ObjDisp(m_Queue)->QueueSubmit(Unwrap(m_Queue), 0, NULL, m_InitStateReadbacks.fence);
+  RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+  m_InitStateReadbacks.inFlight = 1;
+
+  // the host could write to mapped memory as soon as we return, so wait now
+  if(m_InitStateReadbacks.hostMapped)
+    SyncInitialStateReadbacks();
+}
+
+void WrappedVulkan::SyncInitialStateReadbacks()
+{
+  // cheap early-out, this is checked on every queue submit
+  if(m_InitStateReadbacks.inFlight == 0)
+    return;
+
+  SCOPED_LOCK(m_InitStateReadbacks.lock);
+
+  // another thread might have synced while we waited for the lock
+  if(m_InitStateReadbacks.inFlight == 0)
+    return;
+
+  VkDevice d = GetDev();
+
+  VkResult vkr =
+      ObjDisp(d)->WaitForFences(Unwrap(d), 1, &m_InitStateReadbacks.fence, VK_TRUE, UINT64_MAX);
+  RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+  vkr = ObjDisp(d)->ResetFences(Unwrap(d), 1, &m_InitStateReadbacks.fence);
+  RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+  for(size_t i = 0; i < m_InitStateReadbacks.buffers.size(); i++)
+    ObjDisp(d)->DestroyBuffer(Unwrap(d), m_InitStateReadbacks.buffers[i], NULL);
+
+  for(size_t i = 0; i < m_InitStateReadbacks.images.size(); i++)
+  {
+    ObjDisp(d)->DestroyImage(Unwrap(d), m_InitStateReadbacks.images[i].first, NULL);
+    ObjDisp(d)->FreeMemory(Unwrap(d), m_InitStateReadbacks.images[i].second, NULL);
+  }
+
+  m_InitStateReadbacks.buffers.clear();
+  m_InitStateReadbacks.images.clear();
+  m_InitStateReadbacks.hostMapped = false;
+
+  m_InitStateReadbacks.inFlight = 0;
+}
+
 bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
 {
   ResourceId id = GetResourceManager()->GetID(res);
@@ -1026,12 +1228,11 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
     }
 
     VkDevice d = GetDev();
-    // INITSTATEBATCH
     VkCommandBuffer cmd = GetNextCmd();
 
     ImageLayouts *layout = NULL;
     {
-      SCOPED_LOCK(m_ImageLayoutsLock);
+      SCOPED_WRITELOCK(m_ImageLayoutsLock);
       layout = &m_ImageLayouts[im->id];
     }
 
@@ -1293,17 +1494,13 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
     vkr = ObjDisp(d)->EndCommandBuffer(Unwrap(cmd));
     RDCASSERTEQUAL(vkr, VK_SUCCESS);
 
-    // INITSTATEBATCH
-    SubmitCmds();
-    FlushQ();
-
-    ObjDisp(d)->DestroyBuffer(Unwrap(d), dstBuf, NULL);
+    // the buffer and any MSAA array copy are destroyed once the copies have completed
+    m_InitStateReadbacks.buffers.push_back(dstBuf);
 
     if(arrayIm != VK_NULL_HANDLE)
-    {
-      ObjDisp(d)->DestroyImage(Unwrap(d), arrayIm, NULL);
-      ObjDisp(d)->FreeMemory(Unwrap(d), arrayMem, NULL);
-    }
+      m_InitStateReadbacks.images.push_back(std::make_pair(arrayIm, arrayMem));
+
+    AddInitialStateReadback(mrq.size);
 
     GetResourceManager()->SetInitialContents(
         id, VulkanResourceManager::InitialContentData(GetWrapped(readbackmem), (uint32_t)mrq.size,
@@ -1316,7 +1513,6 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
     VkResult vkr = VK_SUCCESS;
 
     VkDevice d = GetDev();
-    // INITSTATEBATCH
     VkCommandBuffer cmd = GetNextCmd();
 
     VkResourceRecord *record = GetResourceManager()->GetResourceRecord(id);
@@ -1386,12 +1582,16 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
     vkr = ObjDisp(d)->EndCommandBuffer(Unwrap(cmd));
     RDCASSERTEQUAL(vkr, VK_SUCCESS);
 
-    // INITSTATEBATCH
-    SubmitCmds();
-    FlushQ();
+    // the buffers are destroyed once the copy has completed
+    m_InitStateReadbacks.buffers.push_back(srcBuf);
+    m_InitStateReadbacks.buffers.push_back(dstBuf);
+
+    // if the application has this memory mapped it can write to it at any time, so we can't
+    // defer waiting on the copy past the start of the capture
+    if(record->memMapState && record->memMapState->mappedPtr)
+      m_InitStateReadbacks.hostMapped = true;
 
-    ObjDisp(d)->DestroyBuffer(Unwrap(d), srcBuf, NULL);
-    ObjDisp(d)->DestroyBuffer(Unwrap(d), dstBuf, NULL);
+    AddInitialStateReadback(datasize);
 
     GetResourceManager()->SetInitialContents(
         id, VulkanResourceManager::InitialContentData(GetWrapped(readbackmem), (uint32_t)datasize,
@@ -1463,10 +1663,8 @@ bool WrappedVulkan::Serialise_InitialState(ResourceId resid, WrappedVkRes *)
       ObjDisp(d)->MapMemory(Unwrap(d), ToHandle<VkDeviceMemory>(initContents.resource), 0,
                             VK_WHOLE_SIZE, 0, (void **)&ptr);
 
-      size_t dataSize = (size_t)initContents.num;
-
       m_pSerialiser->Serialise("dataSize", initContents.num);
-      m_pSerialiser->SerialiseBuffer("data", ptr, dataSize);
+      SerialiseInitialData(ptr, initContents.num);
 
       ObjDisp(d)->UnmapMemory(Unwrap(d), ToHandle<VkDeviceMemory>(initContents.resource));
     }
@@ -1696,8 +1894,7 @@ bool WrappedVulkan::Serialise_InitialState(ResourceId resid, WrappedVkRes *)
       byte *ptr = NULL;
       ObjDisp(d)->MapMemory(Unwrap(d), Unwrap(uploadmem), 0, VK_WHOLE_SIZE, 0, (void **)&ptr);
 
-      size_t dummy = 0;
-      m_pSerialiser->SerialiseBuffer("data", ptr, dummy);
+      SerialiseInitialData(ptr, dataSize);
 
       ObjDisp(d)->UnmapMemory(Unwrap(d), Unwrap(uploadmem));
 
@@ -1936,8 +2133,7 @@ bool WrappedVulkan::Serialise_InitialState(ResourceId resid, WrappedVkRes *)
       byte *ptr = NULL;
       ObjDisp(d)->MapMemory(Unwrap(d), Unwrap(mem), 0, VK_WHOLE_SIZE, 0, (void **)&ptr);
 
-      size_t dummy = 0;
-      m_pSerialiser->SerialiseBuffer("data", ptr, dummy);
+      SerialiseInitialData(ptr, dataSize);
 
       ObjDisp(d)->UnmapMemory(Unwrap(d), Unwrap(mem));
 
@@ -49,6 +49,14 @@ bool VulkanResourceManager::SerialisableResource(ResourceId id, VkResourceRecord
 #define TRDBG(...)
 #endif
 
+struct BarrierStateSearch
+{
+  bool operator()(const pair<ResourceId, ImageRegionState> &a, ResourceId b) const
+  {
+    return a.first < b;
+  }
+};
+
 template <typename SrcBarrierType>
 void VulkanResourceManager::RecordSingleBarrier(vector<pair<ResourceId, ImageRegionState> > &dststates,
                                                 ResourceId id, const SrcBarrierType &t,
@@ -56,7 +64,9 @@ void VulkanResourceManager::RecordSingleBarrier(vector<pair<ResourceId, ImageReg
 {
   bool done = false;
 
-  auto it = dststates.begin();
+  // states are kept sorted by ID, so skip straight to the ones for this image rather than
+  // walking every state recorded so far in the command buffer
+  auto it = std::lower_bound(dststates.begin(), dststates.end(), id, BarrierStateSearch());
   for(; it != dststates.end(); ++it)
   {
     // image barriers are handled by initially inserting one subresource range for each aspect,
@@ -425,6 +435,66 @@ void VulkanResourceManager::ApplyBarriers(vector<pair<ResourceId, ImageRegionSta
 
     TRDBG("Matching image has %u subresource states", stit->second.subresourceStates.size());
 
+    // once an image has been split there is one state per subresource, stored slice-major, so
+    // the subresources covered by the barrier can be indexed directly instead of scanning all
+    // of them. This matters for large arrays or mip chains transitioned a subresource at a time
+    {
+      ImageLayouts &layout = stit->second;
+      vector<ImageRegionState> &subStates = layout.subresourceStates;
+
+      if(subStates.size() > 1 && subStates.size() == size_t(layout.layerCount * layout.levelCount) &&
+         t.subresourceRange.baseMipLevel + nummips <= uint32_t(layout.levelCount) &&
+         t.subresourceRange.baseArrayLayer + numslices <= uint32_t(layout.layerCount))
+      {
+        done = true;
+
+        for(uint32_t s = 0; done && s < numslices; s++)
+        {
+          for(uint32_t m = 0; m < nummips; m++)
+          {
+            uint32_t slice = t.subresourceRange.baseArrayLayer + s;
+            uint32_t mip = t.subresourceRange.baseMipLevel + m;
+
+            ImageRegionState &sub = subStates[slice * layout.levelCount + mip];
+
+            // if the layout isn't what we expect, fall back to searching below
+            if(sub.subresourceRange.baseArrayLayer != slice ||
+               sub.subresourceRange.baseMipLevel != mip || sub.subresourceRange.layerCount != 1 ||
+               sub.subresourceRange.levelCount != 1)
+            {
+              done = false;
+              break;
+            }
+          }
+        }
+
+        if(done)
+        {
+          for(uint32_t s = 0; s < numslices; s++)
+          {
+            for(uint32_t m = 0; m < nummips; m++)
+            {
+              ImageRegionState &sub =
+                  subStates[(t.subresourceRange.baseArrayLayer + s) * layout.levelCount +
+                            t.subresourceRange.baseMipLevel + m];
+
+              if(sub.oldLayout == UNKNOWN_PREV_IMG_LAYOUT)
+                sub.oldLayout = t.oldLayout;
+
+              // an exact match with a single subresource reports back the layout it came from,
+              // the same as the search below
+              if(nummips == 1 && numslices == 1)
+                t.oldLayout = sub.newLayout;
+
+              sub.newLayout = t.newLayout;
+            }
+          }
+
+          continue;
+        }
+      }
+    }
+
     auto it = stit->second.subresourceStates.begin();
     for(; it != stit->second.subresourceStates.end(); ++it)
     {
@@ -4206,9 +4206,10 @@ void VulkanReplay::InitPostVSBuffers(const vector<uint32_t> &events)
   m_pDriver->ReplayLog(events.front(), events.back(), eReplay_Full);
 }
 
-vector<EventUsage> VulkanReplay::GetUsage(ResourceId id)
+vector<EventUsage> VulkanReplay::GetUsage(ResourceId id, uint32_t minEventID,
+                                          uint32_t maxEventID, uint64_t usageMask)
 {
-  return m_pDriver->GetUsage(id);
+  return m_pDriver->GetUsage(id, minEventID, maxEventID, usageMask);
 }
 
 MeshFormat VulkanReplay::GetPostVSBuffers(uint32_t eventID, uint32_t instID, MeshDataStage stage)
@@ -5270,6 +5271,8 @@ struct VulkanDriverRegistration
   VulkanDriverRegistration()
   {
     RenderDoc::Inst().RegisterReplayProvider(RDC_Vulkan, "Vulkan", &Vulkan_CreateReplayDevice);
+    RenderDoc::Inst().RegisterChunkCategoriser(RDC_Vulkan, &WrappedVulkan::GetChunkName,
+                                               &WrappedVulkan::GetChunkCategory);
     RenderDoc::Inst().SetVulkanLayerCheck(&VulkanReplay::CheckVulkanLayer);
     RenderDoc::Inst().SetVulkanLayerInstall(&VulkanReplay::InstallVulkanLayer);
   }
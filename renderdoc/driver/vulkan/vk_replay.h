@@ -144,7 +144,8 @@ public:
 
   ShaderReflection *GetShader(ResourceId shader, string entryPoint);
 
-  vector<EventUsage> GetUsage(ResourceId id);
+  vector<EventUsage> GetUsage(ResourceId id, uint32_t minEventID, uint32_t maxEventID,
+                              uint64_t usageMask);
 
   FrameRecord GetFrameRecord();
   vector<DebugMessage> GetDebugMessages();
@@ -243,6 +244,7 @@ public:
   bool IsRenderOutput(ResourceId id);
 
   void FileChanged();
+  bool HasFileChanged() { return false; }
 
   void InitCallstackResolver();
   bool HasCallstacks();
@@ -728,6 +728,27 @@ uint32_t GetByteSize(uint32_t Width, uint32_t Height, uint32_t Depth, VkFormat F
   return ret;
 }
 
+void VkResourceRecord::ExpandDeferredCommands(WrappedVulkan *driver)
+{
+  LockChunks();
+
+  std::vector<byte> &data = cmdInfo->deferred.data;
+
+  for(size_t offs = 0; offs < data.size();)
+  {
+    const DeferredCmdStream::Header *header = (const DeferredCmdStream::Header *)&data[offs];
+
+    Chunk *chunk = header->expand(driver, &data[offs + DeferredCmdStream::HeaderSize]);
+    AddChunk(chunk, header->chunkID);
+
+    offs += header->size;
+  }
+
+  cmdInfo->deferred.clear();
+
+  UnlockChunks();
+}
+
 VkResourceRecord::~VkResourceRecord()
 {
   VkResourceType resType = Resource != NULL ? IdentifyTypeByPtr(Resource) : eResUnknown;
@@ -24,6 +24,8 @@
 
 #pragma once
 
+#include <algorithm>
+
 #include "common/wrapped_pool.h"
 #include "core/resource_manager.h"
 #include "vk_common.h"
@@ -880,6 +882,52 @@ struct SparseMapping
   void Update(uint32_t numBindings, const VkSparseImageMemoryBind *pBindings);
 };
 
+// Commands recorded while not capturing are kept as their raw arguments in a compact stream, and
+// only serialised into chunks if the command buffer is submitted while a frame is being
+// captured. Most command buffers never are, so in the common case we skip serialising and
+// allocating a chunk per command entirely.
+//
+// Each command's chunk ID is reserved when it's recorded, so expanded chunks slot into the right
+// place amongst any that were serialised immediately.
+//
+// Deferral is skipped while callstacks or API validation are enabled, since both are gathered at
+// serialise time and must come from the command's own call. See FlushDeferredCommand().
+struct DeferredCmdStream
+{
+  // serialises the command from its stored arguments, returning the chunk
+  typedef Chunk *(*ExpandFunction)(WrappedVulkan *driver, const byte *args);
+
+  struct Header
+  {
+    ExpandFunction expand;
+    int32_t chunkID;
+    uint32_t size;
+  };
+
+  // the arguments are 8-byte aligned after the header, including on 32-bit
+  static const size_t HeaderSize = (sizeof(Header) + 7) & ~size_t(7);
+
+  // returns storage for argsSize bytes of arguments, valid until the next Push()
+  byte *Push(ExpandFunction expand, int32_t chunkID, size_t argsSize)
+  {
+    size_t size = AlignUp(HeaderSize + argsSize, (size_t)8);
+    size_t offs = data.size();
+    data.resize(offs + size);
+
+    Header *header = (Header *)&data[offs];
+    header->expand = expand;
+    header->chunkID = chunkID;
+    header->size = (uint32_t)size;
+
+    return &data[offs + HeaderSize];
+  }
+
+  bool empty() const { return data.empty(); }
+  void clear() { data.clear(); }
+  void swap(DeferredCmdStream &other) { data.swap(other.data); }
+  std::vector<byte> data;
+};
+
 struct CmdBufferRecordingInfo
 {
   VkDevice device;
@@ -898,17 +946,24 @@ struct CmdBufferRecordingInfo
 
   // a list of descriptor sets that are bound at any point in this command buffer
   // used to look up all the frame refs per-desc set and apply them on queue
-  // submit with latest binding refs.
-  set<VkDescriptorSet> boundDescSets;
+  // submit with latest binding refs. Appended to while recording, then sorted
+  // and de-duplicated when the command buffer is baked.
+  vector<VkDescriptorSet> boundDescSets;
 
   vector<VkResourceRecord *> subcmds;
+
+  // commands recorded while idle that haven't been serialised yet
+  DeferredCmdStream deferred;
 };
 
 struct DescSetLayout;
 
 struct DescriptorSetData
 {
-  DescriptorSetData() : layout(NULL) {}
+  DescriptorSetData()
+      : layout(NULL), generation(0), flatGeneration(0), markedCapture(0), markedGeneration(0)
+  {
+  }
   ~DescriptorSetData()
   {
     for(size_t i = 0; i < descBindings.size(); i++)
@@ -929,6 +984,48 @@ struct DescriptorSetData
   // mapping information
   static const uint32_t SPARSE_REF_BIT = 0x80000000;
   map<ResourceId, pair<uint32_t, FrameRefType> > bindFrameRefs;
+
+  // incremented whenever bindFrameRefs changes
+  uint32_t generation;
+
+  // bindFrameRefs flattened into arrays sorted by ID, since they are walked on
+  // every bind and every submit but change much less often. Rebuilt by
+  // FlattenBindFrameRefs() once an update to the set is complete.
+  uint32_t flatGeneration;
+  vector<pair<ResourceId, FrameRefType> > flatFrameRefs;
+  vector<ResourceId> flatSparseRefs;
+  vector<ResourceId> flatWrittenRefs;
+
+  void FlattenBindFrameRefs()
+  {
+    if(flatGeneration == generation)
+      return;
+
+    flatFrameRefs.clear();
+    flatSparseRefs.clear();
+    flatWrittenRefs.clear();
+
+    flatFrameRefs.reserve(bindFrameRefs.size());
+
+    for(auto it = bindFrameRefs.begin(); it != bindFrameRefs.end(); ++it)
+    {
+      flatFrameRefs.push_back(std::make_pair(it->first, it->second.second));
+
+      if(it->second.first & SPARSE_REF_BIT)
+        flatSparseRefs.push_back(it->first);
+
+      if(it->second.second == eFrameRef_Write || it->second.second == eFrameRef_ReadBeforeWrite)
+        flatWrittenRefs.push_back(it->first);
+    }
+
+    flatGeneration = generation;
+  }
+
+  // the capture and generation in which these refs were last marked as frame
+  // referenced. Marking the same refs again is a no-op, so submits can skip
+  // sets that haven't changed since.
+  uint32_t markedCapture;
+  uint32_t markedGeneration;
 };
 
 struct MemMapState
@@ -989,12 +1086,28 @@ public:
     RDCASSERT(cmdInfo);
     SwapChunks(bakedCommands);
     cmdInfo->dirtied.swap(bakedCommands->cmdInfo->dirtied);
+    std::sort(cmdInfo->boundDescSets.begin(), cmdInfo->boundDescSets.end());
+    cmdInfo->boundDescSets.erase(
+        std::unique(cmdInfo->boundDescSets.begin(), cmdInfo->boundDescSets.end()),
+        cmdInfo->boundDescSets.end());
     cmdInfo->boundDescSets.swap(bakedCommands->cmdInfo->boundDescSets);
     cmdInfo->imgbarriers.swap(bakedCommands->cmdInfo->imgbarriers);
     cmdInfo->subcmds.swap(bakedCommands->cmdInfo->subcmds);
     cmdInfo->sparse.swap(bakedCommands->cmdInfo->sparse);
+    cmdInfo->deferred.swap(bakedCommands->cmdInfo->deferred);
+  }
+
+  // reserves space for a deferred command's arguments (plus any trailing array data) and the ID
+  // its chunk will have once it's expanded. See DeferredCmdStream
+  template <typename ArgsType>
+  ArgsType *DeferCommand(DeferredCmdStream::ExpandFunction expand, size_t trailingBytes = 0)
+  {
+    return (ArgsType *)cmdInfo->deferred.Push(expand, GetID(), sizeof(ArgsType) + trailingBytes);
   }
 
+  // serialise any deferred commands into chunks, so that this record can be inserted into a frame
+  void ExpandDeferredCommands(WrappedVulkan *driver);
+
   void AddBindFrameRef(ResourceId id, FrameRefType ref, bool hasSparse = false)
   {
     if(id == ResourceId())
@@ -1003,6 +1116,8 @@ public:
       return;
     }
 
+    descInfo->generation++;
+
     if((descInfo->bindFrameRefs[id].first & ~DescriptorSetData::SPARSE_REF_BIT) == 0)
     {
       descInfo->bindFrameRefs[id] =
@@ -1033,6 +1148,8 @@ public:
     if(it == descInfo->bindFrameRefs.end())
       return;
 
+    descInfo->generation++;
+
     it->second.first--;
 
     if((it->second.first & ~DescriptorSetData::SPARSE_REF_BIT) == 0)
@@ -1114,7 +1114,7 @@ void WrappedVulkan::vkCmdEndRenderPass(VkCommandBuffer commandBuffer)
 
     // apply the implicit layout transitions here
     {
-      SCOPED_LOCK(m_ImageLayoutsLock);
+      SCOPED_READLOCK(m_ImageLayoutsLock);
       GetResourceManager()->RecordBarriers(GetRecord(commandBuffer)->cmdInfo->imgbarriers,
                                            m_ImageLayouts, (uint32_t)barriers.size(), &barriers[0]);
     }
@@ -1210,6 +1210,26 @@ bool WrappedVulkan::Serialise_vkCmdBindPipeline(Serialiser *localSerialiser,
   return true;
 }
 
+struct DeferredCmdBindPipeline
+{
+  VkCommandBuffer commandBuffer;
+  VkPipelineBindPoint pipelineBindPoint;
+  VkPipeline pipeline;
+};
+
+Chunk *WrappedVulkan::Expand_vkCmdBindPipeline(WrappedVulkan *driver, const byte *args)
+{
+  const DeferredCmdBindPipeline *cmd = (const DeferredCmdBindPipeline *)args;
+
+  Serialiser *localSerialiser = driver->GetThreadSerialiser();
+
+  SCOPED_SERIALISE_CONTEXT(BIND_PIPELINE);
+  driver->Serialise_vkCmdBindPipeline(localSerialiser, cmd->commandBuffer, cmd->pipelineBindPoint,
+                                      cmd->pipeline);
+
+  return scope.Get();
+}
+
 void WrappedVulkan::vkCmdBindPipeline(VkCommandBuffer commandBuffer,
                                       VkPipelineBindPoint pipelineBindPoint, VkPipeline pipeline)
 {
@@ -1221,12 +1241,14 @@ void WrappedVulkan::vkCmdBindPipeline(VkCommandBuffer commandBuffer,
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    DeferredCmdBindPipeline *deferred =
+        record->DeferCommand<DeferredCmdBindPipeline>(&Expand_vkCmdBindPipeline);
+    deferred->commandBuffer = commandBuffer;
+    deferred->pipelineBindPoint = pipelineBindPoint;
+    deferred->pipeline = pipeline;
 
-    SCOPED_SERIALISE_CONTEXT(BIND_PIPELINE);
-    Serialise_vkCmdBindPipeline(localSerialiser, commandBuffer, pipelineBindPoint, pipeline);
+    FlushDeferredCommand(record);
 
-    record->AddChunk(scope.Get());
     record->MarkResourceFrameReferenced(GetResID(pipeline), eFrameRef_Read);
   }
 }
@@ -1385,6 +1407,35 @@ bool WrappedVulkan::Serialise_vkCmdBindDescriptorSets(
   return true;
 }
 
+struct DeferredCmdBindDescriptorSets
+{
+  VkCommandBuffer commandBuffer;
+  VkPipelineBindPoint pipelineBindPoint;
+  VkPipelineLayout layout;
+  uint32_t firstSet;
+  uint32_t setCount;
+  uint32_t dynamicOffsetCount;
+  // followed by VkDescriptorSet pDescriptorSets[setCount],
+  //             uint32_t pDynamicOffsets[dynamicOffsetCount]
+};
+
+Chunk *WrappedVulkan::Expand_vkCmdBindDescriptorSets(WrappedVulkan *driver, const byte *args)
+{
+  const DeferredCmdBindDescriptorSets *cmd = (const DeferredCmdBindDescriptorSets *)args;
+  const VkDescriptorSet *pDescriptorSets = (const VkDescriptorSet *)(cmd + 1);
+  const uint32_t *pDynamicOffsets = (const uint32_t *)(pDescriptorSets + cmd->setCount);
+
+  Serialiser *localSerialiser = driver->GetThreadSerialiser();
+
+  SCOPED_SERIALISE_CONTEXT(BIND_DESCRIPTOR_SET);
+  driver->Serialise_vkCmdBindDescriptorSets(localSerialiser, cmd->commandBuffer,
+                                            cmd->pipelineBindPoint, cmd->layout, cmd->firstSet,
+                                            cmd->setCount, pDescriptorSets, cmd->dynamicOffsetCount,
+                                            pDynamicOffsets);
+
+  return scope.Get();
+}
+
 void WrappedVulkan::vkCmdBindDescriptorSets(VkCommandBuffer commandBuffer,
                                             VkPipelineBindPoint pipelineBindPoint,
                                             VkPipelineLayout layout, uint32_t firstSet,
@@ -1393,6 +1444,7 @@ void WrappedVulkan::vkCmdBindDescriptorSets(VkCommandBuffer commandBuffer,
                                             const uint32_t *pDynamicOffsets)
 {
   SCOPED_DBG_SINK();
+  SCOPED_TEMP_MEMORY();
 
   VkDescriptorSet *unwrapped = GetTempArray<VkDescriptorSet>(setCount);
   for(uint32_t i = 0; i < setCount; i++)
@@ -1406,16 +1458,33 @@ void WrappedVulkan::vkCmdBindDescriptorSets(VkCommandBuffer commandBuffer,
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    size_t trailingSize =
+        sizeof(VkDescriptorSet) * setCount + sizeof(uint32_t) * dynamicOffsetCount;
+    DeferredCmdBindDescriptorSets *deferred =
+        record->DeferCommand<DeferredCmdBindDescriptorSets>(&Expand_vkCmdBindDescriptorSets,
+                                                            trailingSize);
+    deferred->commandBuffer = commandBuffer;
+    deferred->pipelineBindPoint = pipelineBindPoint;
+    deferred->layout = layout;
+    deferred->firstSet = firstSet;
+    deferred->setCount = setCount;
+    deferred->dynamicOffsetCount = dynamicOffsetCount;
+
+    byte *trailing = (byte *)(deferred + 1);
+    memcpy(trailing, pDescriptorSets, sizeof(VkDescriptorSet) * setCount);
+    trailing += sizeof(VkDescriptorSet) * setCount;
+    memcpy(trailing, pDynamicOffsets, sizeof(uint32_t) * dynamicOffsetCount);
+
+    FlushDeferredCommand(record);
 
-    SCOPED_SERIALISE_CONTEXT(BIND_DESCRIPTOR_SET);
-    Serialise_vkCmdBindDescriptorSets(localSerialiser, commandBuffer, pipelineBindPoint, layout,
-                                      firstSet, setCount, pDescriptorSets, dynamicOffsetCount,
-                                      pDynamicOffsets);
-
-    record->AddChunk(scope.Get());
     record->MarkResourceFrameReferenced(GetResID(layout), eFrameRef_Read);
-    record->cmdInfo->boundDescSets.insert(pDescriptorSets, pDescriptorSets + setCount);
+    // sorted and de-duplicated in Bake(), but skip the common case of re-binding the same sets
+    vector<VkDescriptorSet> &boundDescSets = record->cmdInfo->boundDescSets;
+    for(uint32_t i = 0; i < setCount; i++)
+    {
+      if(boundDescSets.empty() || boundDescSets.back() != pDescriptorSets[i])
+        boundDescSets.push_back(pDescriptorSets[i]);
+    }
 
     // conservatively mark all writeable objects in the descriptor set as dirty here.
     // Technically not all might be written although that required verifying what the
@@ -1427,13 +1496,9 @@ void WrappedVulkan::vkCmdBindDescriptorSets(VkCommandBuffer commandBuffer,
     {
       VkResourceRecord *descSet = GetRecord(pDescriptorSets[i]);
 
-      map<ResourceId, pair<uint32_t, FrameRefType> > &frameRefs = descSet->descInfo->bindFrameRefs;
+      const vector<ResourceId> &written = descSet->descInfo->flatWrittenRefs;
 
-      for(auto it = frameRefs.begin(); it != frameRefs.end(); ++it)
-      {
-        if(it->second.second == eFrameRef_Write || it->second.second == eFrameRef_ReadBeforeWrite)
-          record->cmdInfo->dirtied.insert(it->first);
-      }
+      record->cmdInfo->dirtied.insert(written.begin(), written.end());
     }
   }
 }
@@ -1515,11 +1580,35 @@ bool WrappedVulkan::Serialise_vkCmdBindVertexBuffers(Serialiser *localSerialiser
   return true;
 }
 
+struct DeferredCmdBindVertexBuffers
+{
+  VkCommandBuffer commandBuffer;
+  uint32_t firstBinding;
+  uint32_t bindingCount;
+  // followed by VkBuffer pBuffers[bindingCount], VkDeviceSize pOffsets[bindingCount]
+};
+
+Chunk *WrappedVulkan::Expand_vkCmdBindVertexBuffers(WrappedVulkan *driver, const byte *args)
+{
+  const DeferredCmdBindVertexBuffers *cmd = (const DeferredCmdBindVertexBuffers *)args;
+  const VkBuffer *pBuffers = (const VkBuffer *)(cmd + 1);
+  const VkDeviceSize *pOffsets = (const VkDeviceSize *)(pBuffers + cmd->bindingCount);
+
+  Serialiser *localSerialiser = driver->GetThreadSerialiser();
+
+  SCOPED_SERIALISE_CONTEXT(BIND_VERTEX_BUFFERS);
+  driver->Serialise_vkCmdBindVertexBuffers(localSerialiser, cmd->commandBuffer, cmd->firstBinding,
+                                           cmd->bindingCount, pBuffers, pOffsets);
+
+  return scope.Get();
+}
+
 void WrappedVulkan::vkCmdBindVertexBuffers(VkCommandBuffer commandBuffer, uint32_t firstBinding,
                                            uint32_t bindingCount, const VkBuffer *pBuffers,
                                            const VkDeviceSize *pOffsets)
 {
   SCOPED_DBG_SINK();
+  SCOPED_TEMP_MEMORY();
 
   VkBuffer *unwrapped = GetTempArray<VkBuffer>(bindingCount);
   for(uint32_t i = 0; i < bindingCount; i++)
@@ -1532,13 +1621,21 @@ void WrappedVulkan::vkCmdBindVertexBuffers(VkCommandBuffer commandBuffer, uint32
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    size_t trailingSize = sizeof(VkBuffer) * bindingCount + sizeof(VkDeviceSize) * bindingCount;
+    DeferredCmdBindVertexBuffers *deferred =
+        record->DeferCommand<DeferredCmdBindVertexBuffers>(&Expand_vkCmdBindVertexBuffers,
+                                                           trailingSize);
+    deferred->commandBuffer = commandBuffer;
+    deferred->firstBinding = firstBinding;
+    deferred->bindingCount = bindingCount;
 
-    SCOPED_SERIALISE_CONTEXT(BIND_VERTEX_BUFFERS);
-    Serialise_vkCmdBindVertexBuffers(localSerialiser, commandBuffer, firstBinding, bindingCount,
-                                     pBuffers, pOffsets);
+    byte *trailing = (byte *)(deferred + 1);
+    memcpy(trailing, pBuffers, sizeof(VkBuffer) * bindingCount);
+    trailing += sizeof(VkBuffer) * bindingCount;
+    memcpy(trailing, pOffsets, sizeof(VkDeviceSize) * bindingCount);
+
+    FlushDeferredCommand(record);
 
-    record->AddChunk(scope.Get());
     for(uint32_t i = 0; i < bindingCount; i++)
     {
       record->MarkResourceFrameReferenced(GetResID(pBuffers[i]), eFrameRef_Read);
@@ -1595,6 +1692,27 @@ bool WrappedVulkan::Serialise_vkCmdBindIndexBuffer(Serialiser *localSerialiser,
   return true;
 }
 
+struct DeferredCmdBindIndexBuffer
+{
+  VkCommandBuffer commandBuffer;
+  VkBuffer buffer;
+  VkDeviceSize offset;
+  VkIndexType indexType;
+};
+
+Chunk *WrappedVulkan::Expand_vkCmdBindIndexBuffer(WrappedVulkan *driver, const byte *args)
+{
+  const DeferredCmdBindIndexBuffer *cmd = (const DeferredCmdBindIndexBuffer *)args;
+
+  Serialiser *localSerialiser = driver->GetThreadSerialiser();
+
+  SCOPED_SERIALISE_CONTEXT(BIND_INDEX_BUFFER);
+  driver->Serialise_vkCmdBindIndexBuffer(localSerialiser, cmd->commandBuffer, cmd->buffer,
+                                         cmd->offset, cmd->indexType);
+
+  return scope.Get();
+}
+
 void WrappedVulkan::vkCmdBindIndexBuffer(VkCommandBuffer commandBuffer, VkBuffer buffer,
                                          VkDeviceSize offset, VkIndexType indexType)
 {
@@ -1606,12 +1724,15 @@ void WrappedVulkan::vkCmdBindIndexBuffer(VkCommandBuffer commandBuffer, VkBuffer
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    DeferredCmdBindIndexBuffer *deferred =
+        record->DeferCommand<DeferredCmdBindIndexBuffer>(&Expand_vkCmdBindIndexBuffer);
+    deferred->commandBuffer = commandBuffer;
+    deferred->buffer = buffer;
+    deferred->offset = offset;
+    deferred->indexType = indexType;
 
-    SCOPED_SERIALISE_CONTEXT(BIND_INDEX_BUFFER);
-    Serialise_vkCmdBindIndexBuffer(localSerialiser, commandBuffer, buffer, offset, indexType);
+    FlushDeferredCommand(record);
 
-    record->AddChunk(scope.Get());
     record->MarkResourceFrameReferenced(GetResID(buffer), eFrameRef_Read);
     record->MarkResourceFrameReferenced(GetRecord(buffer)->baseResource, eFrameRef_Read);
     if(GetRecord(buffer)->sparseInfo)
@@ -1807,6 +1928,30 @@ bool WrappedVulkan::Serialise_vkCmdPushConstants(Serialiser *localSerialiser,
   return true;
 }
 
+struct DeferredCmdPushConstants
+{
+  VkCommandBuffer commandBuffer;
+  VkPipelineLayout layout;
+  VkShaderStageFlags stageFlags;
+  uint32_t start;
+  uint32_t length;
+  // followed by byte values[length]
+};
+
+Chunk *WrappedVulkan::Expand_vkCmdPushConstants(WrappedVulkan *driver, const byte *args)
+{
+  const DeferredCmdPushConstants *cmd = (const DeferredCmdPushConstants *)args;
+  const byte *values = (const byte *)(cmd + 1);
+
+  Serialiser *localSerialiser = driver->GetThreadSerialiser();
+
+  SCOPED_SERIALISE_CONTEXT(PUSH_CONST);
+  driver->Serialise_vkCmdPushConstants(localSerialiser, cmd->commandBuffer, cmd->layout,
+                                       cmd->stageFlags, cmd->start, cmd->length, values);
+
+  return scope.Get();
+}
+
 void WrappedVulkan::vkCmdPushConstants(VkCommandBuffer commandBuffer, VkPipelineLayout layout,
                                        VkShaderStageFlags stageFlags, uint32_t start,
                                        uint32_t length, const void *values)
@@ -1820,13 +1965,18 @@ void WrappedVulkan::vkCmdPushConstants(VkCommandBuffer commandBuffer, VkPipeline
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    size_t trailingSize = length;
+    DeferredCmdPushConstants *deferred =
+        record->DeferCommand<DeferredCmdPushConstants>(&Expand_vkCmdPushConstants, trailingSize);
+    deferred->commandBuffer = commandBuffer;
+    deferred->layout = layout;
+    deferred->stageFlags = stageFlags;
+    deferred->start = start;
+    deferred->length = length;
+    memcpy(deferred + 1, values, trailingSize);
 
-    SCOPED_SERIALISE_CONTEXT(PUSH_CONST);
-    Serialise_vkCmdPushConstants(localSerialiser, commandBuffer, layout, stageFlags, start, length,
-                                 values);
+    FlushDeferredCommand(record);
 
-    record->AddChunk(scope.Get());
     record->MarkResourceFrameReferenced(GetResID(layout), eFrameRef_Read);
   }
 }
@@ -1938,6 +2088,7 @@ void WrappedVulkan::vkCmdPipelineBarrier(
     uint32_t imageMemoryBarrierCount, const VkImageMemoryBarrier *pImageMemoryBarriers)
 {
   SCOPED_DBG_SINK();
+  SCOPED_TEMP_MEMORY();
 
   {
     byte *memory = GetTempMemory(sizeof(VkBufferMemoryBarrier) * bufferMemoryBarrierCount +
@@ -1980,7 +2131,7 @@ void WrappedVulkan::vkCmdPipelineBarrier(
 
     if(imageMemoryBarrierCount > 0)
     {
-      SCOPED_LOCK(m_ImageLayoutsLock);
+      SCOPED_READLOCK(m_ImageLayoutsLock);
       GetResourceManager()->RecordBarriers(GetRecord(commandBuffer)->cmdInfo->imgbarriers,
                                            m_ImageLayouts, imageMemoryBarrierCount,
                                            pImageMemoryBarriers);
@@ -2586,6 +2737,7 @@ void WrappedVulkan::vkCmdExecuteCommands(VkCommandBuffer commandBuffer, uint32_t
                                          const VkCommandBuffer *pCmdBuffers)
 {
   SCOPED_DBG_SINK();
+  SCOPED_TEMP_MEMORY();
 
   VkCommandBuffer *unwrapped = GetTempArray<VkCommandBuffer>(commandBufferCount);
   for(uint32_t i = 0; i < commandBufferCount; i++)
@@ -2611,6 +2763,7 @@ void WrappedVulkan::vkCmdExecuteCommands(VkCommandBuffer commandBuffer, uint32_t
         record->cmdInfo->dirtied.insert(execRecord->bakedCommands->cmdInfo->dirtied.begin(),
                                         execRecord->bakedCommands->cmdInfo->dirtied.end());
         record->cmdInfo->boundDescSets.insert(
+            record->cmdInfo->boundDescSets.end(),
             execRecord->bakedCommands->cmdInfo->boundDescSets.begin(),
             execRecord->bakedCommands->cmdInfo->boundDescSets.end());
         record->cmdInfo->subcmds.push_back(execRecord);
@@ -145,6 +145,8 @@ VkResult WrappedVulkan::vkCreateDescriptorSetLayout(VkDevice device,
                                                     const VkAllocationCallbacks *pAllocator,
                                                     VkDescriptorSetLayout *pSetLayout)
 {
+  SCOPED_TEMP_MEMORY();
+
   size_t tempmemSize = sizeof(VkDescriptorSetLayoutBinding) * pCreateInfo->bindingCount;
 
   // need to count how many VkSampler arrays to allocate for
@@ -264,6 +266,8 @@ VkResult WrappedVulkan::vkAllocateDescriptorSets(VkDevice device,
                                                  const VkDescriptorSetAllocateInfo *pAllocateInfo,
                                                  VkDescriptorSet *pDescriptorSets)
 {
+  SCOPED_TEMP_MEMORY();
+
   size_t tempmemSize = sizeof(VkDescriptorSetAllocateInfo) +
                        sizeof(VkDescriptorSetLayout) * pAllocateInfo->descriptorSetCount;
 
@@ -348,6 +352,8 @@ VkResult WrappedVulkan::vkAllocateDescriptorSets(VkDevice device,
 VkResult WrappedVulkan::vkFreeDescriptorSets(VkDevice device, VkDescriptorPool descriptorPool,
                                              uint32_t count, const VkDescriptorSet *pDescriptorSets)
 {
+  SCOPED_TEMP_MEMORY();
+
   VkDescriptorSet *unwrapped = GetTempArray<VkDescriptorSet>(count);
   for(uint32_t i = 0; i < count; i++)
     unwrapped[i] = Unwrap(pDescriptorSets[i]);
@@ -633,6 +639,7 @@ void WrappedVulkan::vkUpdateDescriptorSets(VkDevice device, uint32_t writeCount,
                                            const VkCopyDescriptorSet *pDescriptorCopies)
 {
   SCOPED_DBG_SINK();
+  SCOPED_TEMP_MEMORY();
 
   {
     // need to count up number of descriptor infos, to be able to alloc enough space
@@ -774,18 +781,7 @@ void WrappedVulkan::vkUpdateDescriptorSets(VkDevice device, uint32_t writeCount,
 
         VkResourceRecord *setrecord = GetRecord(pDescriptorCopies[i].srcSet);
 
-        for(auto refit = setrecord->descInfo->bindFrameRefs.begin();
-            refit != setrecord->descInfo->bindFrameRefs.end(); ++refit)
-        {
-          GetResourceManager()->MarkResourceFrameReferenced(refit->first, refit->second.second);
-
-          if(refit->second.first & DescriptorSetData::SPARSE_REF_BIT)
-          {
-            VkResourceRecord *record = GetResourceManager()->GetResourceRecord(refit->first);
-
-            GetResourceManager()->MarkSparseMapReferenced(record->sparseInfo);
-          }
-        }
+        MarkDescSetReferenced(setrecord->descInfo);
       }
     }
   }
@@ -1082,5 +1078,13 @@ void WrappedVulkan::vkUpdateDescriptorSets(VkDevice device, uint32_t writeCount,
         }
       }
     }
+
+    // now the updates are complete, refresh the flattened refs used on bind and submit. Each
+    // set only gets rebuilt once no matter how many writes or copies touched it
+    for(uint32_t i = 0; i < writeCount; i++)
+      GetRecord(pDescriptorWrites[i].dstSet)->descInfo->FlattenBindFrameRefs();
+
+    for(uint32_t i = 0; i < copyCount; i++)
+      GetRecord(pDescriptorCopies[i].dstSet)->descInfo->FlattenBindFrameRefs();
   }
 }
@@ -239,6 +239,7 @@ ReplayStatus WrappedVulkan::Initialise(VkInitParams &params)
   m_QueueFamilyIdx = ~0U;
   m_Queue = VK_NULL_HANDLE;
   m_InternalCmds.Reset();
+  m_InitStateReadbacks.Reset();
 
   if(ObjDisp(m_Instance)->CreateDebugReportCallbackEXT)
   {
@@ -387,6 +388,7 @@ VkResult WrappedVulkan::vkCreateInstance(const VkInstanceCreateInfo *pCreateInfo
   m_QueueFamilyIdx = ~0U;
   m_Queue = VK_NULL_HANDLE;
   m_InternalCmds.Reset();
+  m_InitStateReadbacks.Reset();
 
   if(RenderDoc::Inst().GetCaptureOptions().APIValidation &&
      ObjDisp(m_Instance)->CreateDebugReportCallbackEXT)
@@ -418,6 +420,11 @@ void WrappedVulkan::Shutdown()
   SubmitSemaphores();
   FlushQ();
 
+  SyncInitialStateReadbacks();
+
+  if(m_InitStateReadbacks.fence != VK_NULL_HANDLE)
+    ObjDisp(m_Device)->DestroyFence(Unwrap(m_Device), m_InitStateReadbacks.fence, NULL);
+
   // since we didn't create proper registered resources for our command buffers,
   // they won't be taken down properly with the pool. So we release them (just our
   // data) here.
@@ -1456,6 +1463,11 @@ void WrappedVulkan::vkDestroyDevice(VkDevice device, const VkAllocationCallbacks
   SubmitSemaphores();
   FlushQ();
 
+  SyncInitialStateReadbacks();
+
+  if(m_InitStateReadbacks.fence != VK_NULL_HANDLE)
+    ObjDisp(m_Device)->DestroyFence(Unwrap(m_Device), m_InitStateReadbacks.fence, NULL);
+
   // MULTIDEVICE this function will need to check if the device is the one we
   // used for debugmanager/cmd pool etc, and only remove child queues and
   // resources (instead of doing full resource manager shutdown).
@@ -1485,6 +1497,7 @@ void WrappedVulkan::vkDestroyDevice(VkDevice device, const VkAllocationCallbacks
   }
 
   m_InternalCmds.Reset();
+  m_InitStateReadbacks.Reset();
 
   m_QueueFamilyIdx = ~0U;
   m_Queue = VK_NULL_HANDLE;
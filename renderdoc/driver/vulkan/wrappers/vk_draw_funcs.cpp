@@ -134,6 +134,28 @@ bool WrappedVulkan::Serialise_vkCmdDraw(Serialiser *localSerialiser, VkCommandBu
   return true;
 }
 
+struct DeferredCmdDraw
+{
+  VkCommandBuffer commandBuffer;
+  uint32_t vertexCount;
+  uint32_t instanceCount;
+  uint32_t firstVertex;
+  uint32_t firstInstance;
+};
+
+Chunk *WrappedVulkan::Expand_vkCmdDraw(WrappedVulkan *driver, const byte *args)
+{
+  const DeferredCmdDraw *cmd = (const DeferredCmdDraw *)args;
+
+  Serialiser *localSerialiser = driver->GetThreadSerialiser();
+
+  SCOPED_SERIALISE_CONTEXT(DRAW);
+  driver->Serialise_vkCmdDraw(localSerialiser, cmd->commandBuffer, cmd->vertexCount,
+                              cmd->instanceCount, cmd->firstVertex, cmd->firstInstance);
+
+  return scope.Get();
+}
+
 void WrappedVulkan::vkCmdDraw(VkCommandBuffer commandBuffer, uint32_t vertexCount,
                               uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
 {
@@ -146,13 +168,14 @@ void WrappedVulkan::vkCmdDraw(VkCommandBuffer commandBuffer, uint32_t vertexCoun
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
-
-    SCOPED_SERIALISE_CONTEXT(DRAW);
-    Serialise_vkCmdDraw(localSerialiser, commandBuffer, vertexCount, instanceCount, firstVertex,
-                        firstInstance);
+    DeferredCmdDraw *deferred = record->DeferCommand<DeferredCmdDraw>(&Expand_vkCmdDraw);
+    deferred->commandBuffer = commandBuffer;
+    deferred->vertexCount = vertexCount;
+    deferred->instanceCount = instanceCount;
+    deferred->firstVertex = firstVertex;
+    deferred->firstInstance = firstInstance;
 
-    record->AddChunk(scope.Get());
+    FlushDeferredCommand(record);
   }
 }
 
@@ -231,6 +254,30 @@ bool WrappedVulkan::Serialise_vkCmdDrawIndexed(Serialiser *localSerialiser,
   return true;
 }
 
+struct DeferredCmdDrawIndexed
+{
+  VkCommandBuffer commandBuffer;
+  uint32_t indexCount;
+  uint32_t instanceCount;
+  uint32_t firstIndex;
+  int32_t vertexOffset;
+  uint32_t firstInstance;
+};
+
+Chunk *WrappedVulkan::Expand_vkCmdDrawIndexed(WrappedVulkan *driver, const byte *args)
+{
+  const DeferredCmdDrawIndexed *cmd = (const DeferredCmdDrawIndexed *)args;
+
+  Serialiser *localSerialiser = driver->GetThreadSerialiser();
+
+  SCOPED_SERIALISE_CONTEXT(DRAW_INDEXED);
+  driver->Serialise_vkCmdDrawIndexed(localSerialiser, cmd->commandBuffer, cmd->indexCount,
+                                     cmd->instanceCount, cmd->firstIndex, cmd->vertexOffset,
+                                     cmd->firstInstance);
+
+  return scope.Get();
+}
+
 void WrappedVulkan::vkCmdDrawIndexed(VkCommandBuffer commandBuffer, uint32_t indexCount,
                                      uint32_t instanceCount, uint32_t firstIndex,
                                      int32_t vertexOffset, uint32_t firstInstance)
@@ -245,13 +292,16 @@ void WrappedVulkan::vkCmdDrawIndexed(VkCommandBuffer commandBuffer, uint32_t ind
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
-
-    SCOPED_SERIALISE_CONTEXT(DRAW_INDEXED);
-    Serialise_vkCmdDrawIndexed(localSerialiser, commandBuffer, indexCount, instanceCount,
-                               firstIndex, vertexOffset, firstInstance);
+    DeferredCmdDrawIndexed *deferred =
+        record->DeferCommand<DeferredCmdDrawIndexed>(&Expand_vkCmdDrawIndexed);
+    deferred->commandBuffer = commandBuffer;
+    deferred->indexCount = indexCount;
+    deferred->instanceCount = instanceCount;
+    deferred->firstIndex = firstIndex;
+    deferred->vertexOffset = vertexOffset;
+    deferred->firstInstance = firstInstance;
 
-    record->AddChunk(scope.Get());
+    FlushDeferredCommand(record);
   }
 }
 
@@ -506,6 +556,28 @@ bool WrappedVulkan::Serialise_vkCmdDrawIndirect(Serialiser *localSerialiser,
   return true;
 }
 
+struct DeferredCmdDrawIndirect
+{
+  VkCommandBuffer commandBuffer;
+  VkBuffer buffer;
+  VkDeviceSize offset;
+  uint32_t count;
+  uint32_t stride;
+};
+
+Chunk *WrappedVulkan::Expand_vkCmdDrawIndirect(WrappedVulkan *driver, const byte *args)
+{
+  const DeferredCmdDrawIndirect *cmd = (const DeferredCmdDrawIndirect *)args;
+
+  Serialiser *localSerialiser = driver->GetThreadSerialiser();
+
+  SCOPED_SERIALISE_CONTEXT(DRAW_INDIRECT);
+  driver->Serialise_vkCmdDrawIndirect(localSerialiser, cmd->commandBuffer, cmd->buffer, cmd->offset,
+                                      cmd->count, cmd->stride);
+
+  return scope.Get();
+}
+
 void WrappedVulkan::vkCmdDrawIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer,
                                       VkDeviceSize offset, uint32_t count, uint32_t stride)
 {
@@ -517,12 +589,15 @@ void WrappedVulkan::vkCmdDrawIndirect(VkCommandBuffer commandBuffer, VkBuffer bu
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    DeferredCmdDrawIndirect *deferred =
+        record->DeferCommand<DeferredCmdDrawIndirect>(&Expand_vkCmdDrawIndirect);
+    deferred->commandBuffer = commandBuffer;
+    deferred->buffer = buffer;
+    deferred->offset = offset;
+    deferred->count = count;
+    deferred->stride = stride;
 
-    SCOPED_SERIALISE_CONTEXT(DRAW_INDIRECT);
-    Serialise_vkCmdDrawIndirect(localSerialiser, commandBuffer, buffer, offset, count, stride);
-
-    record->AddChunk(scope.Get());
+    FlushDeferredCommand(record);
 
     record->MarkResourceFrameReferenced(GetResID(buffer), eFrameRef_Read);
     record->MarkResourceFrameReferenced(GetRecord(buffer)->baseResource, eFrameRef_Read);
@@ -803,6 +878,28 @@ bool WrappedVulkan::Serialise_vkCmdDrawIndexedIndirect(Serialiser *localSerialis
   return true;
 }
 
+struct DeferredCmdDrawIndexedIndirect
+{
+  VkCommandBuffer commandBuffer;
+  VkBuffer buffer;
+  VkDeviceSize offset;
+  uint32_t count;
+  uint32_t stride;
+};
+
+Chunk *WrappedVulkan::Expand_vkCmdDrawIndexedIndirect(WrappedVulkan *driver, const byte *args)
+{
+  const DeferredCmdDrawIndexedIndirect *cmd = (const DeferredCmdDrawIndexedIndirect *)args;
+
+  Serialiser *localSerialiser = driver->GetThreadSerialiser();
+
+  SCOPED_SERIALISE_CONTEXT(DRAW_INDEXED_INDIRECT);
+  driver->Serialise_vkCmdDrawIndexedIndirect(localSerialiser, cmd->commandBuffer, cmd->buffer,
+                                             cmd->offset, cmd->count, cmd->stride);
+
+  return scope.Get();
+}
+
 void WrappedVulkan::vkCmdDrawIndexedIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer,
                                              VkDeviceSize offset, uint32_t count, uint32_t stride)
 {
@@ -815,12 +912,15 @@ void WrappedVulkan::vkCmdDrawIndexedIndirect(VkCommandBuffer commandBuffer, VkBu
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
-
-    SCOPED_SERIALISE_CONTEXT(DRAW_INDEXED_INDIRECT);
-    Serialise_vkCmdDrawIndexedIndirect(localSerialiser, commandBuffer, buffer, offset, count, stride);
+    DeferredCmdDrawIndexedIndirect *deferred =
+        record->DeferCommand<DeferredCmdDrawIndexedIndirect>(&Expand_vkCmdDrawIndexedIndirect);
+    deferred->commandBuffer = commandBuffer;
+    deferred->buffer = buffer;
+    deferred->offset = offset;
+    deferred->count = count;
+    deferred->stride = stride;
 
-    record->AddChunk(scope.Get());
+    FlushDeferredCommand(record);
 
     record->MarkResourceFrameReferenced(GetResID(buffer), eFrameRef_Read);
     record->MarkResourceFrameReferenced(GetRecord(buffer)->baseResource, eFrameRef_Read);
@@ -888,6 +988,26 @@ bool WrappedVulkan::Serialise_vkCmdDispatch(Serialiser *localSerialiser,
   return true;
 }
 
+struct DeferredCmdDispatch
+{
+  VkCommandBuffer commandBuffer;
+  uint32_t x;
+  uint32_t y;
+  uint32_t z;
+};
+
+Chunk *WrappedVulkan::Expand_vkCmdDispatch(WrappedVulkan *driver, const byte *args)
+{
+  const DeferredCmdDispatch *cmd = (const DeferredCmdDispatch *)args;
+
+  Serialiser *localSerialiser = driver->GetThreadSerialiser();
+
+  SCOPED_SERIALISE_CONTEXT(DISPATCH);
+  driver->Serialise_vkCmdDispatch(localSerialiser, cmd->commandBuffer, cmd->x, cmd->y, cmd->z);
+
+  return scope.Get();
+}
+
 void WrappedVulkan::vkCmdDispatch(VkCommandBuffer commandBuffer, uint32_t x, uint32_t y, uint32_t z)
 {
   SCOPED_DBG_SINK();
@@ -898,12 +1018,14 @@ void WrappedVulkan::vkCmdDispatch(VkCommandBuffer commandBuffer, uint32_t x, uin
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
-
-    SCOPED_SERIALISE_CONTEXT(DISPATCH);
-    Serialise_vkCmdDispatch(localSerialiser, commandBuffer, x, y, z);
+    DeferredCmdDispatch *deferred =
+        record->DeferCommand<DeferredCmdDispatch>(&Expand_vkCmdDispatch);
+    deferred->commandBuffer = commandBuffer;
+    deferred->x = x;
+    deferred->y = y;
+    deferred->z = z;
 
-    record->AddChunk(scope.Get());
+    FlushDeferredCommand(record);
   }
 }
 
@@ -985,6 +1107,26 @@ bool WrappedVulkan::Serialise_vkCmdDispatchIndirect(Serialiser *localSerialiser,
   return true;
 }
 
+struct DeferredCmdDispatchIndirect
+{
+  VkCommandBuffer commandBuffer;
+  VkBuffer buffer;
+  VkDeviceSize offset;
+};
+
+Chunk *WrappedVulkan::Expand_vkCmdDispatchIndirect(WrappedVulkan *driver, const byte *args)
+{
+  const DeferredCmdDispatchIndirect *cmd = (const DeferredCmdDispatchIndirect *)args;
+
+  Serialiser *localSerialiser = driver->GetThreadSerialiser();
+
+  SCOPED_SERIALISE_CONTEXT(DISPATCH_INDIRECT);
+  driver->Serialise_vkCmdDispatchIndirect(localSerialiser, cmd->commandBuffer, cmd->buffer,
+                                          cmd->offset);
+
+  return scope.Get();
+}
+
 void WrappedVulkan::vkCmdDispatchIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer,
                                           VkDeviceSize offset)
 {
@@ -996,12 +1138,13 @@ void WrappedVulkan::vkCmdDispatchIndirect(VkCommandBuffer commandBuffer, VkBuffe
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
-
-    SCOPED_SERIALISE_CONTEXT(DISPATCH_INDIRECT);
-    Serialise_vkCmdDispatchIndirect(localSerialiser, commandBuffer, buffer, offset);
+    DeferredCmdDispatchIndirect *deferred =
+        record->DeferCommand<DeferredCmdDispatchIndirect>(&Expand_vkCmdDispatchIndirect);
+    deferred->commandBuffer = commandBuffer;
+    deferred->buffer = buffer;
+    deferred->offset = offset;
 
-    record->AddChunk(scope.Get());
+    FlushDeferredCommand(record);
 
     record->MarkResourceFrameReferenced(GetResID(buffer), eFrameRef_Read);
     record->MarkResourceFrameReferenced(GetRecord(buffer)->baseResource, eFrameRef_Read);
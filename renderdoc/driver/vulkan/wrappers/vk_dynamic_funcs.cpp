@@ -64,6 +64,28 @@ bool WrappedVulkan::Serialise_vkCmdSetViewport(Serialiser *localSerialiser,
   return true;
 }
 
+struct DeferredCmdSetViewport
+{
+  VkCommandBuffer cmdBuffer;
+  uint32_t firstViewport;
+  uint32_t viewportCount;
+  // followed by VkViewport pViewports[viewportCount]
+};
+
+Chunk *WrappedVulkan::Expand_vkCmdSetViewport(WrappedVulkan *driver, const byte *args)
+{
+  const DeferredCmdSetViewport *cmd = (const DeferredCmdSetViewport *)args;
+  const VkViewport *pViewports = (const VkViewport *)(cmd + 1);
+
+  Serialiser *localSerialiser = driver->GetThreadSerialiser();
+
+  SCOPED_SERIALISE_CONTEXT(SET_VP);
+  driver->Serialise_vkCmdSetViewport(localSerialiser, cmd->cmdBuffer, cmd->firstViewport,
+                                     cmd->viewportCount, pViewports);
+
+  return scope.Get();
+}
+
 void WrappedVulkan::vkCmdSetViewport(VkCommandBuffer cmdBuffer, uint32_t firstViewport,
                                      uint32_t viewportCount, const VkViewport *pViewports)
 {
@@ -75,12 +97,15 @@ void WrappedVulkan::vkCmdSetViewport(VkCommandBuffer cmdBuffer, uint32_t firstVi
   {
     VkResourceRecord *record = GetRecord(cmdBuffer);
 
-    CACHE_THREAD_SERIALISER();
-
-    SCOPED_SERIALISE_CONTEXT(SET_VP);
-    Serialise_vkCmdSetViewport(localSerialiser, cmdBuffer, firstViewport, viewportCount, pViewports);
+    size_t trailingSize = sizeof(VkViewport) * viewportCount;
+    DeferredCmdSetViewport *deferred =
+        record->DeferCommand<DeferredCmdSetViewport>(&Expand_vkCmdSetViewport, trailingSize);
+    deferred->cmdBuffer = cmdBuffer;
+    deferred->firstViewport = firstViewport;
+    deferred->viewportCount = viewportCount;
+    memcpy(deferred + 1, pViewports, trailingSize);
 
-    record->AddChunk(scope.Get());
+    FlushDeferredCommand(record);
   }
 }
 
@@ -124,6 +149,28 @@ bool WrappedVulkan::Serialise_vkCmdSetScissor(Serialiser *localSerialiser,
   return true;
 }
 
+struct DeferredCmdSetScissor
+{
+  VkCommandBuffer cmdBuffer;
+  uint32_t firstScissor;
+  uint32_t scissorCount;
+  // followed by VkRect2D pScissors[scissorCount]
+};
+
+Chunk *WrappedVulkan::Expand_vkCmdSetScissor(WrappedVulkan *driver, const byte *args)
+{
+  const DeferredCmdSetScissor *cmd = (const DeferredCmdSetScissor *)args;
+  const VkRect2D *pScissors = (const VkRect2D *)(cmd + 1);
+
+  Serialiser *localSerialiser = driver->GetThreadSerialiser();
+
+  SCOPED_SERIALISE_CONTEXT(SET_SCISSOR);
+  driver->Serialise_vkCmdSetScissor(localSerialiser, cmd->cmdBuffer, cmd->firstScissor,
+                                    cmd->scissorCount, pScissors);
+
+  return scope.Get();
+}
+
 void WrappedVulkan::vkCmdSetScissor(VkCommandBuffer cmdBuffer, uint32_t firstScissor,
                                     uint32_t scissorCount, const VkRect2D *pScissors)
 {
@@ -135,12 +182,15 @@ void WrappedVulkan::vkCmdSetScissor(VkCommandBuffer cmdBuffer, uint32_t firstSci
   {
     VkResourceRecord *record = GetRecord(cmdBuffer);
 
-    CACHE_THREAD_SERIALISER();
-
-    SCOPED_SERIALISE_CONTEXT(SET_SCISSOR);
-    Serialise_vkCmdSetScissor(localSerialiser, cmdBuffer, firstScissor, scissorCount, pScissors);
+    size_t trailingSize = sizeof(VkRect2D) * scissorCount;
+    DeferredCmdSetScissor *deferred =
+        record->DeferCommand<DeferredCmdSetScissor>(&Expand_vkCmdSetScissor, trailingSize);
+    deferred->cmdBuffer = cmdBuffer;
+    deferred->firstScissor = firstScissor;
+    deferred->scissorCount = scissorCount;
+    memcpy(deferred + 1, pScissors, trailingSize);
 
-    record->AddChunk(scope.Get());
+    FlushDeferredCommand(record);
   }
 }
 
@@ -174,6 +224,24 @@ bool WrappedVulkan::Serialise_vkCmdSetLineWidth(Serialiser *localSerialiser,
   return true;
 }
 
+struct DeferredCmdSetLineWidth
+{
+  VkCommandBuffer cmdBuffer;
+  float lineWidth;
+};
+
+Chunk *WrappedVulkan::Expand_vkCmdSetLineWidth(WrappedVulkan *driver, const byte *args)
+{
+  const DeferredCmdSetLineWidth *cmd = (const DeferredCmdSetLineWidth *)args;
+
+  Serialiser *localSerialiser = driver->GetThreadSerialiser();
+
+  SCOPED_SERIALISE_CONTEXT(SET_LINE_WIDTH);
+  driver->Serialise_vkCmdSetLineWidth(localSerialiser, cmd->cmdBuffer, cmd->lineWidth);
+
+  return scope.Get();
+}
+
 void WrappedVulkan::vkCmdSetLineWidth(VkCommandBuffer cmdBuffer, float lineWidth)
 {
   SCOPED_DBG_SINK();
@@ -184,12 +252,12 @@ void WrappedVulkan::vkCmdSetLineWidth(VkCommandBuffer cmdBuffer, float lineWidth
   {
     VkResourceRecord *record = GetRecord(cmdBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    DeferredCmdSetLineWidth *deferred =
+        record->DeferCommand<DeferredCmdSetLineWidth>(&Expand_vkCmdSetLineWidth);
+    deferred->cmdBuffer = cmdBuffer;
+    deferred->lineWidth = lineWidth;
 
-    SCOPED_SERIALISE_CONTEXT(SET_LINE_WIDTH);
-    Serialise_vkCmdSetLineWidth(localSerialiser, cmdBuffer, lineWidth);
-
-    record->AddChunk(scope.Get());
+    FlushDeferredCommand(record);
   }
 }
 
@@ -228,6 +296,27 @@ bool WrappedVulkan::Serialise_vkCmdSetDepthBias(Serialiser *localSerialiser,
   return true;
 }
 
+struct DeferredCmdSetDepthBias
+{
+  VkCommandBuffer cmdBuffer;
+  float depthBias;
+  float depthBiasClamp;
+  float slopeScaledDepthBias;
+};
+
+Chunk *WrappedVulkan::Expand_vkCmdSetDepthBias(WrappedVulkan *driver, const byte *args)
+{
+  const DeferredCmdSetDepthBias *cmd = (const DeferredCmdSetDepthBias *)args;
+
+  Serialiser *localSerialiser = driver->GetThreadSerialiser();
+
+  SCOPED_SERIALISE_CONTEXT(SET_DEPTH_BIAS);
+  driver->Serialise_vkCmdSetDepthBias(localSerialiser, cmd->cmdBuffer, cmd->depthBias,
+                                      cmd->depthBiasClamp, cmd->slopeScaledDepthBias);
+
+  return scope.Get();
+}
+
 void WrappedVulkan::vkCmdSetDepthBias(VkCommandBuffer cmdBuffer, float depthBias,
                                       float depthBiasClamp, float slopeScaledDepthBias)
 {
@@ -240,13 +329,14 @@ void WrappedVulkan::vkCmdSetDepthBias(VkCommandBuffer cmdBuffer, float depthBias
   {
     VkResourceRecord *record = GetRecord(cmdBuffer);
 
-    CACHE_THREAD_SERIALISER();
-
-    SCOPED_SERIALISE_CONTEXT(SET_DEPTH_BIAS);
-    Serialise_vkCmdSetDepthBias(localSerialiser, cmdBuffer, depthBias, depthBiasClamp,
-                                slopeScaledDepthBias);
+    DeferredCmdSetDepthBias *deferred =
+        record->DeferCommand<DeferredCmdSetDepthBias>(&Expand_vkCmdSetDepthBias);
+    deferred->cmdBuffer = cmdBuffer;
+    deferred->depthBias = depthBias;
+    deferred->depthBiasClamp = depthBiasClamp;
+    deferred->slopeScaledDepthBias = slopeScaledDepthBias;
 
-    record->AddChunk(scope.Get());
+    FlushDeferredCommand(record);
   }
 }
 
@@ -290,6 +380,24 @@ bool WrappedVulkan::Serialise_vkCmdSetBlendConstants(Serialiser *localSerialiser
   return true;
 }
 
+struct DeferredCmdSetBlendConstants
+{
+  VkCommandBuffer cmdBuffer;
+  float blendConst[4];
+};
+
+Chunk *WrappedVulkan::Expand_vkCmdSetBlendConstants(WrappedVulkan *driver, const byte *args)
+{
+  const DeferredCmdSetBlendConstants *cmd = (const DeferredCmdSetBlendConstants *)args;
+
+  Serialiser *localSerialiser = driver->GetThreadSerialiser();
+
+  SCOPED_SERIALISE_CONTEXT(SET_BLEND_CONST);
+  driver->Serialise_vkCmdSetBlendConstants(localSerialiser, cmd->cmdBuffer, cmd->blendConst);
+
+  return scope.Get();
+}
+
 void WrappedVulkan::vkCmdSetBlendConstants(VkCommandBuffer cmdBuffer, const float *blendConst)
 {
   SCOPED_DBG_SINK();
@@ -300,12 +408,12 @@ void WrappedVulkan::vkCmdSetBlendConstants(VkCommandBuffer cmdBuffer, const floa
   {
     VkResourceRecord *record = GetRecord(cmdBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    DeferredCmdSetBlendConstants *deferred =
+        record->DeferCommand<DeferredCmdSetBlendConstants>(&Expand_vkCmdSetBlendConstants);
+    deferred->cmdBuffer = cmdBuffer;
+    memcpy(deferred->blendConst, blendConst, sizeof(deferred->blendConst));
 
-    SCOPED_SERIALISE_CONTEXT(SET_BLEND_CONST);
-    Serialise_vkCmdSetBlendConstants(localSerialiser, cmdBuffer, blendConst);
-
-    record->AddChunk(scope.Get());
+    FlushDeferredCommand(record);
   }
 }
 
@@ -342,6 +450,26 @@ bool WrappedVulkan::Serialise_vkCmdSetDepthBounds(Serialiser *localSerialiser,
   return true;
 }
 
+struct DeferredCmdSetDepthBounds
+{
+  VkCommandBuffer cmdBuffer;
+  float minDepthBounds;
+  float maxDepthBounds;
+};
+
+Chunk *WrappedVulkan::Expand_vkCmdSetDepthBounds(WrappedVulkan *driver, const byte *args)
+{
+  const DeferredCmdSetDepthBounds *cmd = (const DeferredCmdSetDepthBounds *)args;
+
+  Serialiser *localSerialiser = driver->GetThreadSerialiser();
+
+  SCOPED_SERIALISE_CONTEXT(SET_DEPTH_BOUNDS);
+  driver->Serialise_vkCmdSetDepthBounds(localSerialiser, cmd->cmdBuffer, cmd->minDepthBounds,
+                                        cmd->maxDepthBounds);
+
+  return scope.Get();
+}
+
 void WrappedVulkan::vkCmdSetDepthBounds(VkCommandBuffer cmdBuffer, float minDepthBounds,
                                         float maxDepthBounds)
 {
@@ -353,12 +481,13 @@ void WrappedVulkan::vkCmdSetDepthBounds(VkCommandBuffer cmdBuffer, float minDept
   {
     VkResourceRecord *record = GetRecord(cmdBuffer);
 
-    CACHE_THREAD_SERIALISER();
-
-    SCOPED_SERIALISE_CONTEXT(SET_DEPTH_BOUNDS);
-    Serialise_vkCmdSetDepthBounds(localSerialiser, cmdBuffer, minDepthBounds, maxDepthBounds);
+    DeferredCmdSetDepthBounds *deferred =
+        record->DeferCommand<DeferredCmdSetDepthBounds>(&Expand_vkCmdSetDepthBounds);
+    deferred->cmdBuffer = cmdBuffer;
+    deferred->minDepthBounds = minDepthBounds;
+    deferred->maxDepthBounds = maxDepthBounds;
 
-    record->AddChunk(scope.Get());
+    FlushDeferredCommand(record);
   }
 }
 
@@ -399,6 +528,26 @@ bool WrappedVulkan::Serialise_vkCmdSetStencilCompareMask(Serialiser *localSerial
   return true;
 }
 
+struct DeferredCmdSetStencilCompareMask
+{
+  VkCommandBuffer cmdBuffer;
+  VkStencilFaceFlags faceMask;
+  uint32_t compareMask;
+};
+
+Chunk *WrappedVulkan::Expand_vkCmdSetStencilCompareMask(WrappedVulkan *driver, const byte *args)
+{
+  const DeferredCmdSetStencilCompareMask *cmd = (const DeferredCmdSetStencilCompareMask *)args;
+
+  Serialiser *localSerialiser = driver->GetThreadSerialiser();
+
+  SCOPED_SERIALISE_CONTEXT(SET_STENCIL_COMP_MASK);
+  driver->Serialise_vkCmdSetStencilCompareMask(localSerialiser, cmd->cmdBuffer, cmd->faceMask,
+                                               cmd->compareMask);
+
+  return scope.Get();
+}
+
 void WrappedVulkan::vkCmdSetStencilCompareMask(VkCommandBuffer cmdBuffer,
                                                VkStencilFaceFlags faceMask, uint32_t compareMask)
 {
@@ -410,12 +559,13 @@ void WrappedVulkan::vkCmdSetStencilCompareMask(VkCommandBuffer cmdBuffer,
   {
     VkResourceRecord *record = GetRecord(cmdBuffer);
 
-    CACHE_THREAD_SERIALISER();
-
-    SCOPED_SERIALISE_CONTEXT(SET_STENCIL_COMP_MASK);
-    Serialise_vkCmdSetStencilCompareMask(localSerialiser, cmdBuffer, faceMask, compareMask);
+    DeferredCmdSetStencilCompareMask *deferred =
+        record->DeferCommand<DeferredCmdSetStencilCompareMask>(&Expand_vkCmdSetStencilCompareMask);
+    deferred->cmdBuffer = cmdBuffer;
+    deferred->faceMask = faceMask;
+    deferred->compareMask = compareMask;
 
-    record->AddChunk(scope.Get());
+    FlushDeferredCommand(record);
   }
 }
 
@@ -456,6 +606,26 @@ bool WrappedVulkan::Serialise_vkCmdSetStencilWriteMask(Serialiser *localSerialis
   return true;
 }
 
+struct DeferredCmdSetStencilWriteMask
+{
+  VkCommandBuffer cmdBuffer;
+  VkStencilFaceFlags faceMask;
+  uint32_t writeMask;
+};
+
+Chunk *WrappedVulkan::Expand_vkCmdSetStencilWriteMask(WrappedVulkan *driver, const byte *args)
+{
+  const DeferredCmdSetStencilWriteMask *cmd = (const DeferredCmdSetStencilWriteMask *)args;
+
+  Serialiser *localSerialiser = driver->GetThreadSerialiser();
+
+  SCOPED_SERIALISE_CONTEXT(SET_STENCIL_WRITE_MASK);
+  driver->Serialise_vkCmdSetStencilWriteMask(localSerialiser, cmd->cmdBuffer, cmd->faceMask,
+                                             cmd->writeMask);
+
+  return scope.Get();
+}
+
 void WrappedVulkan::vkCmdSetStencilWriteMask(VkCommandBuffer cmdBuffer, VkStencilFaceFlags faceMask,
                                              uint32_t writeMask)
 {
@@ -467,12 +637,13 @@ void WrappedVulkan::vkCmdSetStencilWriteMask(VkCommandBuffer cmdBuffer, VkStenci
   {
     VkResourceRecord *record = GetRecord(cmdBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    DeferredCmdSetStencilWriteMask *deferred =
+        record->DeferCommand<DeferredCmdSetStencilWriteMask>(&Expand_vkCmdSetStencilWriteMask);
+    deferred->cmdBuffer = cmdBuffer;
+    deferred->faceMask = faceMask;
+    deferred->writeMask = writeMask;
 
-    SCOPED_SERIALISE_CONTEXT(SET_STENCIL_WRITE_MASK);
-    Serialise_vkCmdSetStencilWriteMask(localSerialiser, cmdBuffer, faceMask, writeMask);
-
-    record->AddChunk(scope.Get());
+    FlushDeferredCommand(record);
   }
 }
 
@@ -513,6 +684,26 @@ bool WrappedVulkan::Serialise_vkCmdSetStencilReference(Serialiser *localSerialis
   return true;
 }
 
+struct DeferredCmdSetStencilReference
+{
+  VkCommandBuffer cmdBuffer;
+  VkStencilFaceFlags faceMask;
+  uint32_t reference;
+};
+
+Chunk *WrappedVulkan::Expand_vkCmdSetStencilReference(WrappedVulkan *driver, const byte *args)
+{
+  const DeferredCmdSetStencilReference *cmd = (const DeferredCmdSetStencilReference *)args;
+
+  Serialiser *localSerialiser = driver->GetThreadSerialiser();
+
+  SCOPED_SERIALISE_CONTEXT(SET_STENCIL_REF);
+  driver->Serialise_vkCmdSetStencilReference(localSerialiser, cmd->cmdBuffer, cmd->faceMask,
+                                             cmd->reference);
+
+  return scope.Get();
+}
+
 void WrappedVulkan::vkCmdSetStencilReference(VkCommandBuffer cmdBuffer, VkStencilFaceFlags faceMask,
                                              uint32_t reference)
 {
@@ -524,11 +715,12 @@ void WrappedVulkan::vkCmdSetStencilReference(VkCommandBuffer cmdBuffer, VkStenci
   {
     VkResourceRecord *record = GetRecord(cmdBuffer);
 
-    CACHE_THREAD_SERIALISER();
-
-    SCOPED_SERIALISE_CONTEXT(SET_STENCIL_REF);
-    Serialise_vkCmdSetStencilReference(localSerialiser, cmdBuffer, faceMask, reference);
+    DeferredCmdSetStencilReference *deferred =
+        record->DeferCommand<DeferredCmdSetStencilReference>(&Expand_vkCmdSetStencilReference);
+    deferred->cmdBuffer = cmdBuffer;
+    deferred->faceMask = faceMask;
+    deferred->reference = reference;
 
-    record->AddChunk(scope.Get());
+    FlushDeferredCommand(record);
   }
 }
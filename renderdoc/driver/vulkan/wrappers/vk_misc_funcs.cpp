@@ -140,8 +140,11 @@ void WrappedVulkan::vkDestroyImage(VkDevice device, VkImage obj,
   if(obj == VK_NULL_HANDLE)
     return;
 
+  // we might still be reading its initial contents
+  SyncInitialStateReadbacks();
+
   {
-    SCOPED_LOCK(m_ImageLayoutsLock);
+    SCOPED_WRITELOCK(m_ImageLayoutsLock);
     m_ImageLayouts.erase(GetResID(obj));
   }
   VkImage unwrappedObj = Unwrap(obj);
@@ -510,6 +513,8 @@ VkResult WrappedVulkan::vkCreateFramebuffer(VkDevice device,
                                             const VkAllocationCallbacks *pAllocator,
                                             VkFramebuffer *pFramebuffer)
 {
+  SCOPED_TEMP_MEMORY();
+
   VkImageView *unwrapped = GetTempArray<VkImageView>(pCreateInfo->attachmentCount);
   for(uint32_t i = 0; i < pCreateInfo->attachmentCount; i++)
     unwrapped[i] = Unwrap(pCreateInfo->pAttachments[i]);
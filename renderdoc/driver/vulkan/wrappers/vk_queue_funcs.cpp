@@ -453,6 +453,10 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
                                       const VkSubmitInfo *pSubmits, VkFence fence)
 {
   SCOPED_DBG_SINK();
+  SCOPED_TEMP_MEMORY();
+
+  // the application's work could overwrite resources we're still reading initial states from
+  SyncInitialStateReadbacks();
 
   size_t tempmemSize = sizeof(VkSubmitInfo) * submitCount;
 
@@ -599,7 +603,7 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
       ObjDisp(queue)->QueueSubmit(Unwrap(queue), submitCount, unwrappedSubmits, Unwrap(fence));
 
   bool capframe = false;
-  set<ResourceId> refdIDs;
+  vector<ResourceId> refdIDs;
 
   for(uint32_t s = 0; s < submitCount; s++)
   {
@@ -610,7 +614,7 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
       VkResourceRecord *record = GetRecord(pSubmits[s].pCommandBuffers[i]);
 
       {
-        SCOPED_LOCK(m_ImageLayoutsLock);
+        SCOPED_WRITELOCK(m_ImageLayoutsLock);
         GetResourceManager()->ApplyBarriers(record->bakedCommands->cmdInfo->imgbarriers,
                                             m_ImageLayouts);
       }
@@ -652,19 +656,12 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
 
           VkResourceRecord *setrecord = GetRecord(*it);
 
-          for(auto refit = setrecord->descInfo->bindFrameRefs.begin();
-              refit != setrecord->descInfo->bindFrameRefs.end(); ++refit)
-          {
-            refdIDs.insert(refit->first);
-            GetResourceManager()->MarkResourceFrameReferenced(refit->first, refit->second.second);
+          const vector<pair<ResourceId, FrameRefType> > &refs = setrecord->descInfo->flatFrameRefs;
 
-            if(refit->second.first & DescriptorSetData::SPARSE_REF_BIT)
-            {
-              VkResourceRecord *sparserecord = GetResourceManager()->GetResourceRecord(refit->first);
+          for(size_t r = 0; r < refs.size(); r++)
+            refdIDs.push_back(refs[r].first);
 
-              GetResourceManager()->MarkSparseMapReferenced(sparserecord->sparseInfo);
-            }
-          }
+          MarkDescSetReferenced(setrecord->descInfo);
         }
 
         for(auto it = record->bakedCommands->cmdInfo->sparse.begin();
@@ -694,6 +691,11 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
         if(fence != VK_NULL_HANDLE)
           GetResourceManager()->MarkResourceFrameReferenced(GetResID(fence), eFrameRef_Read);
 
+        // commands recorded while idle only get serialised now that we know they're needed
+        record->bakedCommands->ExpandDeferredCommands(this);
+        for(size_t sub = 0; sub < record->bakedCommands->cmdInfo->subcmds.size(); sub++)
+          record->bakedCommands->cmdInfo->subcmds[sub]->bakedCommands->ExpandDeferredCommands(this);
+
         {
           SCOPED_LOCK(m_CmdBufferRecordsLock);
           m_CmdBufferRecords.push_back(record->bakedCommands);
@@ -710,6 +712,9 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
 
   if(capframe)
   {
+    std::sort(refdIDs.begin(), refdIDs.end());
+    refdIDs.erase(std::unique(refdIDs.begin(), refdIDs.end()), refdIDs.end());
+
     vector<VkResourceRecord *> maps;
     {
       SCOPED_LOCK(m_CoherentMapsLock);
@@ -725,7 +730,7 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
       if(state.mapCoherent && state.mappedPtr && !state.mapFlushed)
       {
         // only need to flush memory that could affect this submitted batch of work
-        if(refdIDs.find(record->GetResourceID()) == refdIDs.end())
+        if(!std::binary_search(refdIDs.begin(), refdIDs.end(), record->GetResourceID()))
         {
           RDCDEBUG("Map of memory %llu not referenced in this queue - not flushing",
                    record->GetResourceID());
@@ -888,6 +893,10 @@ bool WrappedVulkan::Serialise_vkQueueBindSparse(Serialiser *localSerialiser, VkQ
 VkResult WrappedVulkan::vkQueueBindSparse(VkQueue queue, uint32_t bindInfoCount,
                                           const VkBindSparseInfo *pBindInfo, VkFence fence)
 {
+  SCOPED_TEMP_MEMORY();
+
+  SyncInitialStateReadbacks();
+
   if(m_State >= WRITING_CAPFRAME)
   {
     CACHE_THREAD_SERIALISER();
@@ -213,6 +213,8 @@ VkResult WrappedVulkan::vkAllocateMemory(VkDevice device, const VkMemoryAllocate
                                          const VkAllocationCallbacks *pAllocator,
                                          VkDeviceMemory *pMemory)
 {
+  SCOPED_TEMP_MEMORY();
+
   VkMemoryAllocateInfo info = *pAllocateInfo;
   if(m_State >= WRITING)
   {
@@ -476,6 +478,9 @@ void WrappedVulkan::vkFreeMemory(VkDevice device, VkDeviceMemory memory,
   if(memory == VK_NULL_HANDLE)
     return;
 
+  // we might still be reading its initial contents
+  SyncInitialStateReadbacks();
+
   // we just need to clean up after ourselves on replay
   WrappedVkNonDispRes *wrapped = (WrappedVkNonDispRes *)GetWrapped(memory);
 
@@ -504,6 +509,9 @@ void WrappedVulkan::vkFreeMemory(VkDevice device, VkDeviceMemory memory,
 VkResult WrappedVulkan::vkMapMemory(VkDevice device, VkDeviceMemory mem, VkDeviceSize offset,
                                     VkDeviceSize size, VkMemoryMapFlags flags, void **ppData)
 {
+  // once mapped the host can write to the memory, so any initial state copy must be finished
+  SyncInitialStateReadbacks();
+
   void *realData = NULL;
   VkResult ret =
       ObjDisp(device)->MapMemory(Unwrap(device), Unwrap(mem), offset, size, flags, &realData);
@@ -711,9 +719,7 @@ bool WrappedVulkan::Serialise_vkFlushMappedMemoryRanges(Serialiser *localSeriali
     // it's no longer safe to use state->mappedPtr, we need to save *precisely* what
     // was serialised. We do this by copying out of the serialiser since we know this
     // memory is not changing
-    size_t offs = size_t(localSerialiser->GetOffset() - memSize);
-
-    byte *serialisedData = localSerialiser->GetRawPtr(offs);
+    const byte *serialisedData = localSerialiser->GetLastBufferData();
 
     memcpy(state->refData, serialisedData + (size_t)memOffset, (size_t)memSize);
   }
@@ -747,6 +753,8 @@ bool WrappedVulkan::Serialise_vkFlushMappedMemoryRanges(Serialiser *localSeriali
 VkResult WrappedVulkan::vkFlushMappedMemoryRanges(VkDevice device, uint32_t memRangeCount,
                                                   const VkMappedMemoryRange *pMemRanges)
 {
+  SCOPED_TEMP_MEMORY();
+
   if(m_State >= WRITING)
   {
     bool capframe = false;
@@ -801,6 +809,8 @@ VkResult WrappedVulkan::vkFlushMappedMemoryRanges(VkDevice device, uint32_t memR
 VkResult WrappedVulkan::vkInvalidateMappedMemoryRanges(VkDevice device, uint32_t memRangeCount,
                                                        const VkMappedMemoryRange *pMemRanges)
 {
+  SCOPED_TEMP_MEMORY();
+
   VkMappedMemoryRange *unwrapped = GetTempArray<VkMappedMemoryRange>(memRangeCount);
   for(uint32_t i = 0; i < memRangeCount; i++)
   {
@@ -1318,7 +1328,7 @@ VkResult WrappedVulkan::vkCreateImage(VkDevice device, const VkImageCreateInfo *
 
     ImageLayouts *layout = NULL;
     {
-      SCOPED_LOCK(m_ImageLayoutsLock);
+      SCOPED_WRITELOCK(m_ImageLayoutsLock);
       layout = &m_ImageLayouts[id];
     }
 
@@ -80,6 +80,8 @@ VkResult WrappedVulkan::vkCreatePipelineLayout(VkDevice device,
                                                const VkAllocationCallbacks *pAllocator,
                                                VkPipelineLayout *pPipelineLayout)
 {
+  SCOPED_TEMP_MEMORY();
+
   VkDescriptorSetLayout *unwrapped = GetTempArray<VkDescriptorSetLayout>(pCreateInfo->setLayoutCount);
   for(uint32_t i = 0; i < pCreateInfo->setLayoutCount; i++)
     unwrapped[i] = Unwrap(pCreateInfo->pSetLayouts[i]);
@@ -356,6 +358,8 @@ VkResult WrappedVulkan::vkCreateGraphicsPipelines(VkDevice device, VkPipelineCac
                                                   const VkAllocationCallbacks *pAllocator,
                                                   VkPipeline *pPipelines)
 {
+  SCOPED_TEMP_MEMORY();
+
   // conservatively request memory for 5 stages on each pipeline
   // (worst case - can't have compute stage). Avoids needing to count
   byte *unwrapped = GetTempMemory(sizeof(VkGraphicsPipelineCreateInfo) * count +
@@ -510,6 +514,8 @@ VkResult WrappedVulkan::vkCreateComputePipelines(VkDevice device, VkPipelineCach
                                                  const VkAllocationCallbacks *pAllocator,
                                                  VkPipeline *pPipelines)
 {
+  SCOPED_TEMP_MEMORY();
+
   VkComputePipelineCreateInfo *unwrapped = GetTempArray<VkComputePipelineCreateInfo>(count);
 
   for(uint32_t i = 0; i < count; i++)
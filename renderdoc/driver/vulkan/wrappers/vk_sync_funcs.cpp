@@ -210,6 +210,7 @@ bool WrappedVulkan::Serialise_vkResetFences(Serialiser *localSerialiser, VkDevic
 VkResult WrappedVulkan::vkResetFences(VkDevice device, uint32_t fenceCount, const VkFence *pFences)
 {
   SCOPED_DBG_SINK();
+  SCOPED_TEMP_MEMORY();
 
   VkFence *unwrapped = GetTempArray<VkFence>(fenceCount);
   for(uint32_t i = 0; i < fenceCount; i++)
@@ -268,6 +269,7 @@ VkResult WrappedVulkan::vkWaitForFences(VkDevice device, uint32_t fenceCount,
                                         const VkFence *pFences, VkBool32 waitAll, uint64_t timeout)
 {
   SCOPED_DBG_SINK();
+  SCOPED_TEMP_MEMORY();
 
   VkFence *unwrapped = GetTempArray<VkFence>(fenceCount);
   for(uint32_t i = 0; i < fenceCount; i++)
@@ -784,6 +786,8 @@ void WrappedVulkan::vkCmdWaitEvents(VkCommandBuffer cmdBuffer, uint32_t eventCou
                                     uint32_t imageMemoryBarrierCount,
                                     const VkImageMemoryBarrier *pImageMemoryBarriers)
 {
+  SCOPED_TEMP_MEMORY();
+
   {
     byte *memory = GetTempMemory(sizeof(VkEvent) * eventCount +
                                  sizeof(VkBufferMemoryBarrier) * bufferMemoryBarrierCount +
@@ -827,7 +831,7 @@ void WrappedVulkan::vkCmdWaitEvents(VkCommandBuffer cmdBuffer, uint32_t eventCou
 
     if(imageMemoryBarrierCount > 0)
     {
-      SCOPED_LOCK(m_ImageLayoutsLock);
+      SCOPED_READLOCK(m_ImageLayoutsLock);
       GetResourceManager()->RecordBarriers(GetRecord(cmdBuffer)->cmdInfo->imgbarriers, m_ImageLayouts,
                                            imageMemoryBarrierCount, pImageMemoryBarriers);
     }
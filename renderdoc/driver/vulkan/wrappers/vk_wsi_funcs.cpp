@@ -534,7 +534,7 @@ void WrappedVulkan::WrapAndProcessCreatedSwapchain(VkDevice device,
 
         // fill out image info so we track resource state barriers
         {
-          SCOPED_LOCK(m_ImageLayoutsLock);
+          SCOPED_WRITELOCK(m_ImageLayoutsLock);
           m_ImageLayouts[imid].subresourceStates.clear();
           m_ImageLayouts[imid].subresourceStates.push_back(
               ImageRegionState(range, UNKNOWN_PREV_IMG_LAYOUT, VK_IMAGE_LAYOUT_UNDEFINED));
@@ -856,6 +856,8 @@ VkResult WrappedVulkan::vkCreateSharedSwapchainsKHR(VkDevice device, uint32_t sw
                                                     const VkAllocationCallbacks *pAllocator,
                                                     VkSwapchainKHR *pSwapchains)
 {
+  SCOPED_TEMP_MEMORY();
+
   VkSwapchainCreateInfoKHR *unwrapped = GetTempArray<VkSwapchainCreateInfoKHR>(swapchainCount);
   for(uint32_t i = 0; i < swapchainCount; i++)
   {
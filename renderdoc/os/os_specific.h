@@ -98,6 +98,27 @@ private:
   data m_Data;
 };
 
+// non-recursive reader/writer lock. Any number of readers may hold it at once, a writer holds it
+// alone. A thread must not take it again (in either mode) while it already holds it.
+template <class data>
+class RWLockTemplate
+{
+public:
+  RWLockTemplate();
+  ~RWLockTemplate();
+  void ReadLock();
+  void ReadUnlock();
+  void WriteLock();
+  void WriteUnlock();
+
+private:
+  // no copying
+  RWLockTemplate &operator=(const RWLockTemplate &other);
+  RWLockTemplate(const RWLockTemplate &other);
+
+  data m_Data;
+};
+
 void Init();
 void Shutdown();
 uint64_t AllocateTLSSlot();
@@ -106,6 +127,7 @@ void *GetTLSValue(uint64_t slot);
 void SetTLSValue(uint64_t slot, void *value);
 
 // must typedef CriticalSectionTemplate<X> CriticalSection
+// must typedef RWLockTemplate<X> RWLock
 
 typedef void (*ThreadEntry)(void *);
 typedef uint64_t ThreadHandle;
@@ -185,6 +207,7 @@ int64_t Inc64(volatile int64_t *i);
 int64_t Dec64(volatile int64_t *i);
 int64_t ExchAdd64(volatile int64_t *i, int64_t a);
 int32_t CmpExch32(volatile int32_t *dest, int32_t oldVal, int32_t newVal);
+void *CmpExchPtr(void *volatile *dest, void *oldVal, void *newVal);
 };
 
 namespace Callstack
@@ -244,7 +267,11 @@ void GetExecutableFilename(string &selfName);
 uint64_t GetModifiedTimestamp(const string &filename);
 
 void Copy(const char *from, const char *to, bool allowOverwrite);
+// renames a file in place, atomically replacing any existing file at the destination
+bool Move(const char *from, const char *to);
 void Delete(const char *path);
+// updates the last modified timestamp of a file to the current time
+void Touch(const char *path);
 std::vector<PathEntry> GetFilesInDirectory(const char *path);
 
 FILE *fopen(const char *filename, const char *mode);
@@ -265,6 +292,20 @@ bool feof(FILE *f);
 
 int fclose(FILE *f);
 
+// maps a whole file read-only into memory. Returns NULL if the file couldn't be opened or mapped,
+// or is empty. The mapping doesn't keep any handle open and must be released with UnmapFile.
+const byte *MapFile(const char *filename, uint64_t &size);
+void UnmapFile(const byte *ptr, uint64_t size);
+
+// watches a file for modifications. Returns NULL if this isn't supported on the platform, in which
+// case callers should fall back to polling GetModifiedTimestamp. Notifications can be spurious so
+// callers should check whether the contents have really changed.
+struct FileWatch;
+FileWatch *WatchFile(const char *filename);
+// waits up to timeoutMS for a change, returns true if the file might have been modified
+bool WaitForFileChange(FileWatch *watch, uint32_t timeoutMS);
+void UnwatchFile(FileWatch *watch);
+
 // functions for atomically appending to a log that may be in use in multiple
 // processes
 bool logfile_open(const char *filename);
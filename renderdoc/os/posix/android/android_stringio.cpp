@@ -56,6 +56,21 @@ bool GetKeyState(int key)
 
 namespace FileIO
 {
+// no file watching, callers poll instead
+FileWatch *WatchFile(const char *filename)
+{
+  return NULL;
+}
+
+bool WaitForFileChange(FileWatch *watch, uint32_t timeoutMS)
+{
+  return false;
+}
+
+void UnwatchFile(FileWatch *watch)
+{
+}
+
 const char *GetTempRootPath()
 {
   return "/sdcard";
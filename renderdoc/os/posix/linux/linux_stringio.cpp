@@ -26,7 +26,9 @@
 #include <iconv.h>
 #include <pwd.h>
 #include <stdio.h>
+#include <poll.h>
 #include <string.h>
+#include <sys/inotify.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <time.h>
@@ -277,6 +279,73 @@ void GetExecutableFilename(string &selfName)
 
   selfName = string(path);
 }
+
+struct FileWatch
+{
+  int fd;
+  string name;
+};
+
+FileWatch *WatchFile(const char *filename)
+{
+  int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if(fd < 0)
+    return NULL;
+
+  string path = GetFullPathname(filename);
+
+  // watch the directory rather than the file itself, since many programs save by writing a new
+  // file and renaming it over the old one, which would orphan a watch on the original inode.
+  // Waiting for the file to be closed after writing avoids seeing it half-written.
+  string dir = dirname(path);
+  if(inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+  {
+    RDCWARN("Couldn't watch %s for changes: %d", dir.c_str(), errno);
+    close(fd);
+    return NULL;
+  }
+
+  FileWatch *ret = new FileWatch;
+  ret->fd = fd;
+  ret->name = basename(path);
+  return ret;
+}
+
+bool WaitForFileChange(FileWatch *watch, uint32_t timeoutMS)
+{
+  pollfd pfd = {watch->fd, POLLIN, 0};
+  if(poll(&pfd, 1, (int)timeoutMS) <= 0)
+    return false;
+
+  bool changed = false;
+
+  // drain all pending events, looking for any that refer to our file
+  char buf[4096] __attribute__((aligned(__alignof__(inotify_event))));
+  ssize_t len = 0;
+  while((len = read(watch->fd, buf, sizeof(buf))) > 0)
+  {
+    for(char *ptr = buf; ptr < buf + len;)
+    {
+      inotify_event *ev = (inotify_event *)ptr;
+
+      if(ev->len > 0 && watch->name == ev->name)
+        changed = true;
+
+      ptr += sizeof(inotify_event) + ev->len;
+    }
+  }
+
+  return changed;
+}
+
+void UnwatchFile(FileWatch *watch)
+{
+  if(watch)
+  {
+    close(watch->fd);
+    delete watch;
+  }
+}
 };
 
 namespace StringFormat
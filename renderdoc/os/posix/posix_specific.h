@@ -58,6 +58,7 @@ struct pthreadLockData
   pthread_mutexattr_t attr;
 };
 typedef CriticalSectionTemplate<pthreadLockData> CriticalSection;
+typedef RWLockTemplate<pthread_rwlock_t> RWLock;
 };
 
 namespace Bits
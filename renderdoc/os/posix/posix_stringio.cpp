@@ -32,7 +32,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/file.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/time.h>
 #include <sys/types.h>
 #include <time.h>
 #include <unistd.h>
@@ -247,11 +249,21 @@ void Copy(const char *from, const char *to, bool allowOverwrite)
   ::fclose(tf);
 }
 
+bool Move(const char *from, const char *to)
+{
+  return rename(from, to) == 0;
+}
+
 void Delete(const char *path)
 {
   unlink(path);
 }
 
+void Touch(const char *path)
+{
+  utimes(path, NULL);
+}
+
 std::vector<PathEntry> GetFilesInDirectory(const char *path)
 {
   std::vector<PathEntry> ret;
@@ -385,6 +397,37 @@ int fclose(FILE *f)
   return ::fclose(f);
 }
 
+const byte *MapFile(const char *filename, uint64_t &size)
+{
+  size = 0;
+
+  int fd = open(filename, O_RDONLY);
+  if(fd < 0)
+    return NULL;
+
+  struct ::stat st;
+  void *ptr = MAP_FAILED;
+
+  if(fstat(fd, &st) == 0 && st.st_size > 0)
+  {
+    ptr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if(ptr != MAP_FAILED)
+      size = (uint64_t)st.st_size;
+  }
+
+  // the mapping holds its own reference to the file
+  close(fd);
+
+  return ptr != MAP_FAILED ? (const byte *)ptr : NULL;
+}
+
+void UnmapFile(const byte *ptr, uint64_t size)
+{
+  if(ptr)
+    munmap((void *)ptr, (size_t)size);
+}
+
 bool exists(const char *filename)
 {
   struct ::stat st;
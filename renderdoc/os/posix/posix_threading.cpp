@@ -64,6 +64,11 @@ int32_t CmpExch32(volatile int32_t *dest, int32_t oldVal, int32_t newVal)
 {
   return __sync_val_compare_and_swap(dest, oldVal, newVal);
 }
+
+void *CmpExchPtr(void *volatile *dest, void *oldVal, void *newVal)
+{
+  return __sync_val_compare_and_swap(dest, oldVal, newVal);
+}
 };
 
 namespace Threading
@@ -101,6 +106,42 @@ void CriticalSection::Unlock()
   pthread_mutex_unlock(&m_Data.lock);
 }
 
+template <>
+RWLock::RWLockTemplate()
+{
+  pthread_rwlock_init(&m_Data, NULL);
+}
+
+template <>
+RWLock::~RWLockTemplate()
+{
+  pthread_rwlock_destroy(&m_Data);
+}
+
+template <>
+void RWLock::ReadLock()
+{
+  pthread_rwlock_rdlock(&m_Data);
+}
+
+template <>
+void RWLock::ReadUnlock()
+{
+  pthread_rwlock_unlock(&m_Data);
+}
+
+template <>
+void RWLock::WriteLock()
+{
+  pthread_rwlock_wrlock(&m_Data);
+}
+
+template <>
+void RWLock::WriteUnlock()
+{
+  pthread_rwlock_unlock(&m_Data);
+}
+
 struct ThreadInitData
 {
   ThreadEntry entryFunc;
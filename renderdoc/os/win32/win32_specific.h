@@ -65,6 +65,7 @@ void WriteOutput(int channel, const char *str);
 namespace Threading
 {
 typedef CriticalSectionTemplate<CRITICAL_SECTION> CriticalSection;
+typedef RWLockTemplate<SRWLOCK> RWLock;
 };
 
 namespace Bits
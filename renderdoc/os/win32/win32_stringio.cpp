@@ -341,12 +341,37 @@ void Copy(const char *from, const char *to, bool allowOverwrite)
   ::CopyFileW(wfrom.c_str(), wto.c_str(), allowOverwrite == false);
 }
 
+bool Move(const char *from, const char *to)
+{
+  wstring wfrom = StringFormat::UTF82Wide(string(from));
+  wstring wto = StringFormat::UTF82Wide(string(to));
+
+  return ::MoveFileExW(wfrom.c_str(), wto.c_str(), MOVEFILE_REPLACE_EXISTING) == TRUE;
+}
+
 void Delete(const char *path)
 {
   wstring wpath = StringFormat::UTF82Wide(string(path));
   ::DeleteFileW(wpath.c_str());
 }
 
+void Touch(const char *path)
+{
+  wstring wpath = StringFormat::UTF82Wide(string(path));
+
+  HANDLE h = ::CreateFileW(wpath.c_str(), FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                           NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+  if(h == INVALID_HANDLE_VALUE)
+    return;
+
+  FILETIME now;
+  GetSystemTimeAsFileTime(&now);
+  ::SetFileTime(h, NULL, NULL, &now);
+
+  CloseHandle(h);
+}
+
 std::vector<PathEntry> GetFilesInDirectory(const char *path)
 {
   std::vector<PathEntry> ret;
@@ -535,6 +560,94 @@ int fclose(FILE *f)
   return ::fclose(f);
 }
 
+const byte *MapFile(const char *filename, uint64_t &size)
+{
+  size = 0;
+
+  wstring wfn = StringFormat::UTF82Wide(string(filename));
+
+  HANDLE file = CreateFileW(wfn.c_str(), GENERIC_READ,
+                            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+  if(file == INVALID_HANDLE_VALUE)
+    return NULL;
+
+  void *ptr = NULL;
+
+  LARGE_INTEGER fileSize = {};
+  if(GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+  {
+    HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+    if(mapping)
+    {
+      ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+      // the view holds its own reference to the mapping
+      CloseHandle(mapping);
+    }
+
+    if(ptr)
+      size = (uint64_t)fileSize.QuadPart;
+  }
+
+  CloseHandle(file);
+
+  return (const byte *)ptr;
+}
+
+void UnmapFile(const byte *ptr, uint64_t size)
+{
+  if(ptr)
+    UnmapViewOfFile(ptr);
+}
+
+struct FileWatch
+{
+  HANDLE notify;
+};
+
+FileWatch *WatchFile(const char *filename)
+{
+  string dir = dirname(GetFullPathname(filename));
+
+  // change notifications are per-directory and don't say which file changed, so any write in the
+  // same directory will wake the watcher.
+  HANDLE notify = FindFirstChangeNotificationW(StringFormat::UTF82Wide(dir).c_str(), FALSE,
+                                               FILE_NOTIFY_CHANGE_LAST_WRITE |
+                                                   FILE_NOTIFY_CHANGE_FILE_NAME |
+                                                   FILE_NOTIFY_CHANGE_SIZE);
+
+  if(notify == INVALID_HANDLE_VALUE)
+  {
+    RDCWARN("Couldn't watch %s for changes: %u", dir.c_str(), GetLastError());
+    return NULL;
+  }
+
+  FileWatch *ret = new FileWatch;
+  ret->notify = notify;
+  return ret;
+}
+
+bool WaitForFileChange(FileWatch *watch, uint32_t timeoutMS)
+{
+  if(WaitForSingleObject(watch->notify, timeoutMS) != WAIT_OBJECT_0)
+    return false;
+
+  FindNextChangeNotification(watch->notify);
+  return true;
+}
+
+void UnwatchFile(FileWatch *watch)
+{
+  if(watch)
+  {
+    FindCloseChangeNotification(watch->notify);
+    delete watch;
+  }
+}
+
 static HANDLE logHandle = NULL;
 
 bool logfile_open(const char *filename)
@@ -77,6 +77,11 @@ int32_t CmpExch32(volatile int32_t *dest, int32_t oldVal, int32_t newVal)
 {
   return (int32_t)InterlockedCompareExchange((volatile LONG *)dest, newVal, oldVal);
 }
+
+void *CmpExchPtr(void *volatile *dest, void *oldVal, void *newVal)
+{
+  return InterlockedCompareExchangePointer(dest, newVal, oldVal);
+}
 };
 
 namespace Threading
@@ -106,6 +111,35 @@ void CriticalSection::Unlock()
   LeaveCriticalSection(&m_Data);
 }
 
+RWLock::RWLockTemplate()
+{
+  InitializeSRWLock(&m_Data);
+}
+
+RWLock::~RWLockTemplate()
+{
+}
+
+void RWLock::ReadLock()
+{
+  AcquireSRWLockShared(&m_Data);
+}
+
+void RWLock::ReadUnlock()
+{
+  ReleaseSRWLockShared(&m_Data);
+}
+
+void RWLock::WriteLock()
+{
+  AcquireSRWLockExclusive(&m_Data);
+}
+
+void RWLock::WriteUnlock()
+{
+  ReleaseSRWLockExclusive(&m_Data);
+}
+
 struct ThreadInitData
 {
   ThreadEntry entryFunc;
@@ -22,7 +22,10 @@
  * THE SOFTWARE.
  ******************************************************************************/
 
+#include <algorithm>
+#include <set>
 #include "api/replay/renderdoc_replay.h"
+#include "common/threading.h"
 #include "core/core.h"
 #include "jpeg-compressor/jpgd.h"
 #include "jpeg-compressor/jpge.h"
@@ -53,6 +56,7 @@ public:
   rdctype::pair<ReplayStatus, IReplayController *> OpenCapture(float *progress);
 
   rdctype::array<byte> GetThumbnail(FileType type, uint32_t maxsize);
+  rdctype::pair<ReplayStatus, CaptureStatistics> GetStatistics();
 
 private:
   std::string m_Filename, m_DriverName, m_Ident;
@@ -112,11 +116,28 @@ rdctype::pair<ReplayStatus, IReplayController *> CaptureFile::OpenCapture(float
   return rdctype::make_pair<ReplayStatus, IReplayController *>(ret, render);
 }
 
-rdctype::array<byte> CaptureFile::GetThumbnail(FileType type, uint32_t maxsize)
+rdctype::pair<ReplayStatus, CaptureStatistics> CaptureFile::GetStatistics()
+{
+  CaptureStatistics stats;
+
+  if(m_Status != ReplayStatus::Succeeded)
+    return rdctype::make_pair<ReplayStatus, CaptureStatistics>(m_Status, stats);
+
+  ReplayStatus ret = RenderDoc::Inst().GetCaptureStatistics(Filename(), stats);
+
+  return rdctype::make_pair<ReplayStatus, CaptureStatistics>(ret, stats);
+}
+
+// reads the thumbnail from the first chunk of the capture and converts it to the requested format
+// and size. This doesn't need the capture to be otherwise valid or replayable, and the serialiser
+// only reads the section headers and the start of the frame data, so it's cheap even for large
+// captures.
+static rdctype::array<byte> ReadCaptureThumbnail(const char *filename, FileType type,
+                                                 uint32_t maxsize)
 {
   rdctype::array<byte> buf;
 
-  Serialiser ser(Filename(), Serialiser::READING, false);
+  Serialiser ser(filename, Serialiser::READING, false);
 
   if(ser.HasError())
     return buf;
@@ -243,6 +264,202 @@ rdctype::array<byte> CaptureFile::GetThumbnail(FileType type, uint32_t maxsize)
   return buf;
 }
 
+rdctype::array<byte> CaptureFile::GetThumbnail(FileType type, uint32_t maxsize)
+{
+  return ReadCaptureThumbnail(Filename(), type, maxsize);
+}
+
+// bump this if the way thumbnails are generated changes, to invalidate old cache entries
+static const uint64_t ThumbnailCacheVersion = 1;
+
+// total size we allow the thumbnail cache folder to grow to. When we go over, the least recently
+// used entries are evicted down to the low watermark.
+static const uint64_t ThumbnailCacheMaxSize = 64ULL * 1024 * 1024;
+static const uint64_t ThumbnailCacheLowWatermark =
+    ThumbnailCacheMaxSize - ThumbnailCacheMaxSize / 4;
+
+// temporary files older than this were left behind by a process that died part way through writing
+static const uint64_t ThumbnailStaleTempAge = 60 * 60;
+
+static string GetThumbnailCacheFolder()
+{
+  return FileIO::GetAppFolderFilename("thumbnails");
+}
+
+static string GetThumbnailCacheFilename(const string &capture, FileType type, uint32_t maxsize)
+{
+  // hashing the whole capture would cost far more than extracting the thumbnail, so entries are
+  // keyed by the path along with the file's size and modification time, which change whenever a
+  // capture is overwritten.
+  struct
+  {
+    uint64_t size;
+    uint64_t modified;
+    uint32_t type;
+    uint32_t maxsize;
+  } key;
+
+  RDCEraseEl(key);
+
+  FILE *f = FileIO::fopen(capture.c_str(), "rb");
+  if(f)
+  {
+    FileIO::fseek64(f, 0, SEEK_END);
+    key.size = FileIO::ftell64(f);
+    FileIO::fclose(f);
+  }
+
+  key.modified = FileIO::GetModifiedTimestamp(capture);
+  key.type = (uint32_t)type;
+  key.maxsize = maxsize;
+
+  uint64_t hash = Hash64(&key, sizeof(key),
+                         Hash64(capture.c_str(), capture.size(), ThumbnailCacheVersion));
+
+  const char *ext = "jpg";
+  if(type == FileType::PNG)
+    ext = "png";
+  else if(type == FileType::TGA)
+    ext = "tga";
+  else if(type == FileType::BMP)
+    ext = "bmp";
+
+  return GetThumbnailCacheFolder() + StringFormat::Fmt("/%016llx.%s", hash, ext);
+}
+
+// entries in keep were just returned to the caller, so they're never evicted even if they alone
+// take the cache over its limit
+static void EvictThumbnailCache(const std::set<string> &keep)
+{
+  string folder = GetThumbnailCacheFolder();
+
+  std::vector<PathEntry> entries = FileIO::GetFilesInDirectory(folder.c_str());
+
+  uint64_t totalSize = 0;
+  uint64_t now = Timing::GetUnixTimestamp();
+
+  for(auto it = entries.begin(); it != entries.end();)
+  {
+    if(it->flags & (PathProperty::Directory | PathProperty::ErrorUnknown |
+                    PathProperty::ErrorAccessDenied | PathProperty::ErrorInvalidPath))
+    {
+      it = entries.erase(it);
+      continue;
+    }
+
+    string filename = it->filename.c_str();
+
+    // another process could be about to move its temporary file into place, so those are only
+    // removed once they're clearly abandoned and never count towards the size
+    if(filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".tmp") == 0)
+    {
+      if(now > it->lastmod + ThumbnailStaleTempAge)
+        FileIO::Delete((folder + "/" + filename).c_str());
+
+      it = entries.erase(it);
+      continue;
+    }
+
+    totalSize += it->size;
+    ++it;
+  }
+
+  if(totalSize <= ThumbnailCacheMaxSize)
+    return;
+
+  std::sort(entries.begin(), entries.end(),
+            [](const PathEntry &a, const PathEntry &b) { return a.lastmod < b.lastmod; });
+
+  for(size_t i = 0; i < entries.size() && totalSize > ThumbnailCacheLowWatermark; i++)
+  {
+    string path = folder + "/" + entries[i].filename.c_str();
+
+    if(keep.find(path) != keep.end())
+      continue;
+
+    FileIO::Delete(path.c_str());
+    totalSize -= entries[i].size;
+  }
+
+  RDCDEBUG("Evicted thumbnail cache down to %llu bytes", totalSize);
+}
+
+static string GetCachedThumbnail(const string &capture, FileType type, uint32_t maxsize)
+{
+  string cached = GetThumbnailCacheFilename(capture, type, maxsize);
+
+  if(FileIO::exists(cached.c_str()))
+  {
+    // bump the timestamp so this entry is considered most recently used
+    FileIO::Touch(cached.c_str());
+    return cached;
+  }
+
+  rdctype::array<byte> thumb = ReadCaptureThumbnail(capture.c_str(), type, maxsize);
+
+  if(thumb.empty())
+    return "";
+
+  FileIO::CreateParentDirectory(cached);
+
+  // write to a file unique to this process and then move it into place, so that other processes
+  // generating the same thumbnail never see a partially written file.
+  string tempname = cached + StringFormat::Fmt(".%u.tmp", Process::GetCurrentPID());
+
+  FILE *f = FileIO::fopen(tempname.c_str(), "wb");
+
+  if(!f)
+  {
+    RDCWARN("Couldn't open thumbnail cache entry for write: %s", tempname.c_str());
+    return "";
+  }
+
+  bool success = FileIO::fwrite(thumb.elems, 1, thumb.size(), f) == thumb.size();
+
+  FileIO::fclose(f);
+
+  if(!success || !FileIO::Move(tempname.c_str(), cached.c_str()))
+  {
+    RDCWARN("Couldn't write thumbnail cache entry %s", cached.c_str());
+    FileIO::Delete(tempname.c_str());
+    return "";
+  }
+
+  return cached;
+}
+
+extern "C" RENDERDOC_API void RENDERDOC_CC
+RENDERDOC_GetCachedThumbnails(const rdctype::array<rdctype::str> &captures, FileType type,
+                              uint32_t maxsize, uint32_t numThreads,
+                              rdctype::array<rdctype::str> *thumbnails)
+{
+  std::vector<string> results(captures.size());
+
+  // results are written by index so the output order matches the input regardless of scheduling
+  Threading::ParallelFor(captures.count,
+                         [&](int32_t i) {
+                           results[i] = GetCachedThumbnail(captures[i].c_str(), type, maxsize);
+                         },
+                         numThreads);
+
+  // check the cache size once per batch rather than per thumbnail, so a large batch doesn't
+  // rescan the folder for every entry it adds
+  std::set<string> keep;
+  for(const string &r : results)
+    if(!r.empty())
+      keep.insert(r);
+
+  if(!keep.empty())
+    EvictThumbnailCache(keep);
+
+  if(thumbnails)
+  {
+    thumbnails->create(captures.count);
+    for(int32_t i = 0; i < captures.count; i++)
+      thumbnails->elems[i] = results[i];
+  }
+}
+
 extern "C" RENDERDOC_API ICaptureFile *RENDERDOC_CC RENDERDOC_OpenCaptureFile(const char *logfile)
 {
   return new CaptureFile(logfile);
@@ -27,8 +27,8 @@
 #include <string.h>
 #include <time.h>
 #include "common/dds_readwrite.h"
+#include "common/image_encode.h"
 #include "jpeg-compressor/jpgd.h"
-#include "jpeg-compressor/jpge.h"
 #include "maths/formatpacking.h"
 #include "os/os_specific.h"
 #include "serialise/serialiser.h"
@@ -165,11 +165,22 @@ static void fileWriteFunc(void *context, void *data, int size)
   FileIO::fwrite(data, 1, size, (FILE *)context);
 }
 
+// the maximum amount of readback data to keep cached, whether speculatively prefetched or from
+// explicit requests.
+static const uint64_t ReadbackCacheBudget = 256 * 1024 * 1024;
+
+// the number of min/max or histogram results to keep before the cache is reset
+static const size_t ReductionCacheMaxEntries = 4096;
+
 ReplayController::ReplayController()
 {
   m_pDevice = NULL;
 
   m_EventID = 100000;
+
+  m_ReadbackCacheSize = 0;
+
+  m_PrefetchEnabled = false;
 }
 
 ReplayController::~ReplayController()
@@ -181,6 +192,11 @@ ReplayController::~ReplayController()
 
   m_Outputs.clear();
 
+  for(size_t i = 0; i < m_ReadbackStreams.size(); i++)
+    SAFE_DELETE(m_ReadbackStreams[i]);
+
+  m_ReadbackStreams.clear();
+
   for(auto it = m_CustomShaders.begin(); it != m_CustomShaders.end(); ++it)
     m_pDevice->FreeCustomShader(*it);
 
@@ -210,6 +226,269 @@ void ReplayController::SetFrameEvent(uint32_t eventID, bool force)
     m_pDevice->ReplayLog(eventID, eReplay_OnlyDraw);
 
     FetchPipelineState();
+
+    // anything queued for the previous event is no longer interesting, queue up fetches for the
+    // outputs around the new event - most important first.
+    m_PrefetchQueue.clear();
+
+    DrawcallDescription *draw = m_PrefetchEnabled ? GetDrawcallByEID(eventID) : NULL;
+
+    if(draw)
+    {
+      QueuePrefetch(draw, true);
+      QueuePrefetch(GetDrawcallByEID((uint32_t)draw->next), false);
+      QueuePrefetch(GetDrawcallByEID((uint32_t)draw->previous), false);
+    }
+  }
+}
+
+void ReplayController::QueuePrefetch(const DrawcallDescription *draw, bool current)
+{
+  if(draw == NULL)
+    return;
+
+  ReadbackKey key = {};
+  key.eventID = current ? m_EventID : draw->eventID;
+
+  for(size_t i = 0; i < ARRAY_COUNT(draw->outputs); i++)
+  {
+    if(draw->outputs[i] == ResourceId())
+      continue;
+
+    key.id = draw->outputs[i];
+    m_PrefetchQueue.push_back(key);
+  }
+
+  if(draw->depthOut != ResourceId())
+  {
+    key.id = draw->depthOut;
+    m_PrefetchQueue.push_back(key);
+  }
+}
+
+void ReplayController::SetPrefetchEnabled(bool enabled)
+{
+  m_PrefetchEnabled = enabled;
+
+  if(!enabled)
+  {
+    m_PrefetchQueue.clear();
+
+    m_ReadbackCache.clear();
+    m_ReadbackLRU.clear();
+    m_ReadbackCacheSize = 0;
+  }
+}
+
+bool ReplayController::ProcessPrefetch()
+{
+  if(m_PrefetchQueue.empty())
+    return false;
+
+  // process all the fetches for one event at a time, so that we only need to move the replay away
+  // from the current event and back once. We always return to the current event before returning
+  // so that explicit requests in between are unaffected.
+  uint32_t eventID = m_PrefetchQueue.front().eventID;
+
+  bool moved = false;
+
+  while(!m_PrefetchQueue.empty() && m_PrefetchQueue.front().eventID == eventID)
+  {
+    ReadbackKey key = m_PrefetchQueue.front();
+    m_PrefetchQueue.pop_front();
+
+    if(!IsCacheableResource(key.id) || FindReadback(key))
+      continue;
+
+    if(eventID != m_EventID && !moved)
+    {
+      m_pDevice->ReplayLog(eventID, eReplay_Full);
+      moved = true;
+    }
+
+    FetchPrefetch(key);
+  }
+
+  if(moved)
+    m_pDevice->ReplayLog(m_EventID, eReplay_Full);
+
+  return !m_PrefetchQueue.empty();
+}
+
+void ReplayController::CancelPrefetch()
+{
+  m_PrefetchQueue.clear();
+}
+
+void ReplayController::FetchPrefetch(const ReadbackKey &key)
+{
+  ResourceId liveId = m_pDevice->GetLiveID(key.id);
+
+  if(liveId == ResourceId())
+    return;
+
+  size_t sz = 0;
+  byte *bytes =
+      m_pDevice->GetTextureData(liveId, key.arrayIdx, key.mip, GetTextureDataParams(), sz);
+
+  if(bytes && sz > 0)
+  {
+    vector<byte> data(bytes, bytes + sz);
+    CacheReadback(key, data);
+  }
+
+  SAFE_DELETE_ARRAY(bytes);
+}
+
+bool ReplayController::IsCacheableResource(ResourceId id)
+{
+  if(id == ResourceId())
+    return false;
+
+  // resources we created ourselves can change contents without the event changing
+  if(m_CustomShaders.find(id) != m_CustomShaders.end() ||
+     m_TargetResources.find(id) != m_TargetResources.end())
+    return false;
+
+  for(size_t i = 0; i < m_Outputs.size(); i++)
+    if(m_Outputs[i]->GetCustomShaderTexID() == id || m_Outputs[i]->GetDebugOverlayTexID() == id)
+      return false;
+
+  return true;
+}
+
+ReplayController::ReadbackData *ReplayController::FindReadback(const ReadbackKey &key)
+{
+  auto it = m_ReadbackCache.find(key);
+
+  if(it == m_ReadbackCache.end())
+    return NULL;
+
+  m_ReadbackLRU.splice(m_ReadbackLRU.begin(), m_ReadbackLRU, it->second.lru);
+
+  return &it->second;
+}
+
+void ReplayController::CacheReadback(const ReadbackKey &key, vector<byte> &data)
+{
+  uint64_t size = data.size();
+
+  // don't let one huge readback flush everything else out
+  if(size > ReadbackCacheBudget / 4)
+    return;
+
+  // replace any existing entry for the same key
+  auto existing = m_ReadbackCache.find(key);
+  if(existing != m_ReadbackCache.end())
+  {
+    m_ReadbackCacheSize -= existing->second.data.size();
+    m_ReadbackLRU.erase(existing->second.lru);
+    m_ReadbackCache.erase(existing);
+  }
+
+  // evict least recently used entries until there's room
+  while(!m_ReadbackLRU.empty() && m_ReadbackCacheSize + size > ReadbackCacheBudget)
+  {
+    auto lru = m_ReadbackCache.find(m_ReadbackLRU.back());
+    m_ReadbackCacheSize -= lru->second.data.size();
+    m_ReadbackCache.erase(lru);
+    m_ReadbackLRU.pop_back();
+  }
+
+  m_ReadbackLRU.push_front(key);
+
+  ReadbackData &entry = m_ReadbackCache[key];
+  entry.data.swap(data);
+  entry.lru = m_ReadbackLRU.begin();
+  m_ReadbackCacheSize += size;
+}
+
+void ReplayController::ClearReadbackCache()
+{
+  m_ReadbackCache.clear();
+  m_ReadbackLRU.clear();
+  m_ReadbackCacheSize = 0;
+  m_PrefetchQueue.clear();
+
+  m_MinMaxCache.clear();
+  m_HistogramCache.clear();
+}
+
+void ReplayController::GetMinMax(ResourceId id, ResourceId liveId, uint32_t sliceFace, uint32_t mip,
+                                 uint32_t sample, CompType typeHint, PixelValue &minval,
+                                 PixelValue &maxval)
+{
+  ReductionKey key = {};
+  key.eventID = m_EventID;
+  key.id = id;
+  key.sliceFace = sliceFace;
+  key.mip = mip;
+  key.sample = sample;
+  key.typeHint = typeHint;
+
+  bool cacheable = IsCacheableResource(id);
+
+  if(cacheable)
+  {
+    auto it = m_MinMaxCache.find(key);
+    if(it != m_MinMaxCache.end())
+    {
+      minval = it->second.first;
+      maxval = it->second.second;
+      return;
+    }
+  }
+
+  m_pDevice->GetMinMax(liveId, sliceFace, mip, sample, typeHint, &minval.value_f[0],
+                       &maxval.value_f[0]);
+
+  if(cacheable)
+  {
+    // results are tiny, so rather than tracking usage just start again if many build up
+    if(m_MinMaxCache.size() >= ReductionCacheMaxEntries)
+      m_MinMaxCache.clear();
+
+    m_MinMaxCache[key] = rdctype::make_pair(minval, maxval);
+  }
+}
+
+void ReplayController::GetHistogram(ResourceId id, ResourceId liveId, uint32_t sliceFace,
+                                    uint32_t mip, uint32_t sample, CompType typeHint, float minval,
+                                    float maxval, bool channels[4], vector<uint32_t> &histogram)
+{
+  ReductionKey key = {};
+  key.eventID = m_EventID;
+  key.id = id;
+  key.sliceFace = sliceFace;
+  key.mip = mip;
+  key.sample = sample;
+  key.typeHint = typeHint;
+  key.minval = minval;
+  key.maxval = maxval;
+  key.channels = (channels[0] ? 0x1 : 0) | (channels[1] ? 0x2 : 0) | (channels[2] ? 0x4 : 0) |
+                 (channels[3] ? 0x8 : 0);
+
+  bool cacheable = IsCacheableResource(id);
+
+  if(cacheable)
+  {
+    auto it = m_HistogramCache.find(key);
+    if(it != m_HistogramCache.end())
+    {
+      histogram = it->second;
+      return;
+    }
+  }
+
+  m_pDevice->GetHistogram(liveId, sliceFace, mip, sample, typeHint, minval, maxval, channels,
+                          histogram);
+
+  if(cacheable)
+  {
+    if(m_HistogramCache.size() >= ReductionCacheMaxEntries)
+      m_HistogramCache.clear();
+
+    m_HistogramCache[key] = histogram;
   }
 }
 
@@ -238,6 +517,21 @@ FrameDescription ReplayController::GetFrameInfo()
   return m_FrameRecord.frameInfo;
 }
 
+CaptureStatistics ReplayController::GetCaptureStatistics()
+{
+  CaptureStatistics ret;
+
+  // remote replays don't have the capture locally
+  if(m_Logfile.empty())
+    return ret;
+
+  // computed on demand, since most users never need it and it's a full pass over the file
+  if(m_CaptureStatistics.chunks.empty())
+    RenderDoc::Inst().GetCaptureStatistics(m_Logfile.c_str(), m_CaptureStatistics);
+
+  return m_CaptureStatistics;
+}
+
 DrawcallDescription *ReplayController::GetDrawcallByEID(uint32_t eventID)
 {
   if(eventID >= m_Drawcalls.size())
@@ -338,7 +632,18 @@ rdctype::array<DebugMessage> ReplayController::GetDebugMessages()
 
 rdctype::array<EventUsage> ReplayController::GetUsage(ResourceId id)
 {
-  return m_pDevice->GetUsage(m_pDevice->GetLiveID(id));
+  return m_pDevice->GetUsage(m_pDevice->GetLiveID(id), 0, ~0U, AllUsageMask);
+}
+
+rdctype::array<EventUsage> ReplayController::GetUsageInRange(
+    ResourceId id, uint32_t firstEventID, uint32_t lastEventID,
+    const rdctype::array<ResourceUsage> &usages)
+{
+  uint64_t mask = usages.empty() ? AllUsageMask : 0;
+  for(int32_t i = 0; i < usages.count; i++)
+    mask |= UsageMask(usages[i]);
+
+  return m_pDevice->GetUsage(m_pDevice->GetLiveID(id), firstEventID, lastEventID, mask);
 }
 
 MeshFormat ReplayController::GetPostVSData(uint32_t instID, MeshDataStage stage)
@@ -371,11 +676,32 @@ rdctype::array<byte> ReplayController::GetBufferData(ResourceId buff, uint64_t o
     return ret;
   }
 
+  ReadbackKey key = {};
+  key.eventID = m_EventID;
+  key.id = buff;
+  key.arrayIdx = key.mip = ~0U;
+  key.offset = offset;
+  key.length = len;
+
+  // readbacks are only cached to be picked up from a prefetch
+  bool cacheable = m_PrefetchEnabled && IsCacheableResource(buff);
+
+  ReadbackData *cached = cacheable ? FindReadback(key) : NULL;
+
+  if(cached)
+  {
+    create_array_init(ret, cached->data.size(), !cached->data.empty() ? &cached->data[0] : NULL);
+    return ret;
+  }
+
   vector<byte> retData;
   m_pDevice->GetBufferData(liveId, offset, len, retData);
 
   create_array_init(ret, retData.size(), !retData.empty() ? &retData[0] : NULL);
 
+  if(cacheable)
+    CacheReadback(key, retData);
+
   return ret;
 }
 
@@ -391,19 +717,204 @@ rdctype::array<byte> ReplayController::GetTextureData(ResourceId tex, uint32_t a
     return ret;
   }
 
+  ReadbackKey key = {};
+  key.eventID = m_EventID;
+  key.id = tex;
+  key.arrayIdx = arrayIdx;
+  key.mip = mip;
+
+  bool cacheable = m_PrefetchEnabled && IsCacheableResource(tex);
+
+  // explicit requests are serviced immediately, but can be satisfied by a previous prefetch
+  ReadbackData *cached = cacheable ? FindReadback(key) : NULL;
+
+  if(cached)
+  {
+    create_array_init(ret, cached->data.size(), !cached->data.empty() ? &cached->data[0] : NULL);
+    return ret;
+  }
+
   size_t sz = 0;
   byte *bytes = m_pDevice->GetTextureData(liveId, arrayIdx, mip, GetTextureDataParams(), sz);
 
   if(sz == 0 || bytes == NULL)
+  {
     create_array_uninit(ret, 0);
+  }
   else
+  {
     create_array_init(ret, sz, bytes);
 
+    if(cacheable)
+    {
+      vector<byte> data(bytes, bytes + sz);
+      CacheReadback(key, data);
+    }
+  }
+
   SAFE_DELETE_ARRAY(bytes);
 
   return ret;
 }
 
+// used when no chunk size is given. Chunks are returned as rdctype::array which can't be larger
+// than 2GB, so requested sizes are also clamped to a maximum.
+static const uint32_t DefaultReadbackChunkSize = 16 * 1024 * 1024;
+static const uint32_t MaxReadbackChunkSize = 1024 * 1024 * 1024;
+
+ReplayReadbackStream::ReplayReadbackStream(IReplayDriver *device, ResourceId liveId,
+                                           uint32_t chunkSize)
+{
+  m_pDevice = device;
+  m_LiveID = liveId;
+  m_ChunkSize = chunkSize == 0 ? DefaultReadbackChunkSize : RDCMIN(chunkSize, MaxReadbackChunkSize);
+
+  m_TotalSize = 0;
+  m_Offset = 0;
+
+  m_BufferOffset = 0;
+  m_TextureData = NULL;
+}
+
+ReplayReadbackStream::~ReplayReadbackStream()
+{
+  SAFE_DELETE_ARRAY(m_TextureData);
+}
+
+rdctype::array<byte> ReplayReadbackStream::ReadChunk()
+{
+  rdctype::array<byte> ret;
+
+  uint64_t size = RDCMIN((uint64_t)m_ChunkSize, m_TotalSize - m_Offset);
+
+  if(size == 0)
+  {
+    SAFE_DELETE_ARRAY(m_TextureData);
+    return ret;
+  }
+
+  if(m_TextureData)
+  {
+    create_array_init(ret, (size_t)size, m_TextureData + m_Offset);
+  }
+  else
+  {
+    m_pDevice->GetBufferData(m_LiveID, m_BufferOffset + m_Offset, size, m_BufferChunk);
+
+    // if the readback failed, end the stream rather than returning empty chunks forever
+    if(m_BufferChunk.empty())
+    {
+      RDCERR("Failed to read back buffer data at offset %llu", m_BufferOffset + m_Offset);
+      m_Offset = m_TotalSize;
+      return ret;
+    }
+
+    size = RDCMIN(size, (uint64_t)m_BufferChunk.size());
+
+    create_array_init(ret, (size_t)size, &m_BufferChunk[0]);
+  }
+
+  m_Offset += size;
+
+  // don't hold onto the texture data any longer than necessary
+  if(m_Offset == m_TotalSize)
+    SAFE_DELETE_ARRAY(m_TextureData);
+
+  return ret;
+}
+
+IReadbackStream *ReplayController::StreamBufferData(ResourceId buff, uint64_t offset, uint64_t len,
+                                                    uint32_t chunkSize)
+{
+  ResourceId liveId = buff == ResourceId() ? ResourceId() : m_pDevice->GetLiveID(buff);
+
+  if(liveId == ResourceId())
+  {
+    RDCERR("Couldn't get Live ID for %llu streaming buffer data", buff);
+    return NULL;
+  }
+
+  ReplayReadbackStream *stream = new ReplayReadbackStream(m_pDevice, liveId, chunkSize);
+
+  uint64_t length = m_pDevice->GetBuffer(liveId).length;
+
+  offset = RDCMIN(offset, length);
+
+  stream->m_BufferOffset = offset;
+  stream->m_TotalSize = (len == 0) ? length - offset : RDCMIN(len, length - offset);
+
+  m_ReadbackStreams.push_back(stream);
+
+  return stream;
+}
+
+IReadbackStream *ReplayController::StreamTextureData(ResourceId tex, uint32_t arrayIdx,
+                                                     uint32_t mip, uint32_t chunkSize)
+{
+  ResourceId liveId = m_pDevice->GetLiveID(tex);
+
+  if(liveId == ResourceId())
+  {
+    RDCERR("Couldn't get Live ID for %llu streaming texture data", tex);
+    return NULL;
+  }
+
+  ReplayReadbackStream *stream = new ReplayReadbackStream(m_pDevice, liveId, chunkSize);
+
+  size_t sz = 0;
+  byte *bytes = m_pDevice->GetTextureData(liveId, arrayIdx, mip, GetTextureDataParams(), sz);
+
+  if(sz == 0 || bytes == NULL)
+  {
+    SAFE_DELETE_ARRAY(bytes);
+  }
+  else
+  {
+    stream->m_TextureData = bytes;
+    stream->m_TotalSize = (uint64_t)sz;
+  }
+
+  m_ReadbackStreams.push_back(stream);
+
+  return stream;
+}
+
+void ReplayController::ShutdownReadbackStream(IReadbackStream *stream)
+{
+  for(auto it = m_ReadbackStreams.begin(); it != m_ReadbackStreams.end(); ++it)
+  {
+    if(*it == stream)
+    {
+      delete *it;
+      m_ReadbackStreams.erase(it);
+      return;
+    }
+  }
+
+  RDCERR("Unknown readback stream %p being shut down", stream);
+}
+
+// splat one channel of an 8-bit image across the others, and set alpha to full
+static void ExtractChannel(byte *data, uint32_t width, uint32_t height, uint32_t compCount,
+                           int32_t channel)
+{
+  uint32_t cc = compCount;
+
+  for(uint32_t y = 0; y < height; y++)
+  {
+    for(uint32_t x = 0; x < width; x++)
+    {
+      data[(y * width + x) * cc + 0] = data[(y * width + x) * cc + channel];
+      if(cc >= 2)
+        data[(y * width + x) * cc + 1] = data[(y * width + x) * cc + channel];
+      if(cc >= 3)
+        data[(y * width + x) * cc + 2] = data[(y * width + x) * cc + channel];
+      if(cc >= 4)
+        data[(y * width + x) * cc + 3] = 255;
+    }
+  }
+}
+
 bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path)
 {
   TextureSave sd = saveData;    // mutable copy
@@ -644,6 +1155,41 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
     slicePitch = rowPitch * td.height;
   }
 
+  bool extractChannel = sd.channelExtract >= 0 && td.format.compByteWidth == 1 &&
+                        (uint32_t)sd.channelExtract < td.format.compCount;
+
+  // DDS files are written out as each subresource is fetched rather than holding them all in
+  // memory first, so that saving large arrays only needs memory for one subresource at a time.
+  FILE *ddsFile = NULL;
+  dds_data ddsData = {};
+  uint32_t ddsWritten = 0;
+
+  if(sd.destType == FileType::DDS)
+  {
+    ddsData.width = td.width;
+    ddsData.height = td.height;
+    // saving a single depth slice of a 3D texture writes a 2D texture
+    ddsData.depth = numSlices == 1 ? 1 : td.depth;
+    ddsData.format = td.format;
+    ddsData.mips = numMips;
+    ddsData.slices = RDCMAX(1U, numSlices / td.depth);
+    ddsData.cubemap = td.cubemap && numSlices == 6;
+
+    ddsFile = FileIO::fopen(path, "wb");
+
+    if(!ddsFile)
+    {
+      RDCERR("Couldn't write to path %s, error: %s", path, FileIO::ErrorString().c_str());
+      return false;
+    }
+
+    if(!write_dds_header(ddsFile, ddsData))
+    {
+      FileIO::fclose(ddsFile);
+      return false;
+    }
+  }
+
   // loop over fetching subresources
   for(uint32_t s = 0; s < numSlices; s++)
   {
@@ -671,9 +1217,55 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
         for(size_t i = 0; i < subdata.size(); i++)
           delete[] subdata[i];
 
+        if(ddsFile)
+          FileIO::fclose(ddsFile);
+
         return false;
       }
 
+      if(ddsFile)
+      {
+        // matches the old behaviour of only extracting the channel in the first subresource
+        if(extractChannel && ddsWritten == 0)
+          ExtractChannel(bytes, td.width, td.height, td.format.compCount, sd.channelExtract);
+
+        // all the depth slices of a 3D texture are contiguous, as in the file, unless we only
+        // want one of them. Lower mips have fewer depth slices, so use the last one if the mip
+        // doesn't go as deep as the selected slice.
+        uint64_t size = dds_subresource_size(ddsData, m);
+        uint64_t offset = 0;
+        if(td.depth > 1 && numSlices == 1)
+          offset = size * RDCMIN(sliceOffset, RDCMAX(1U, td.depth >> m) - 1);
+
+        // the driver may return less data than the DDS layout expects, so don't read off the end
+        if(datasize < offset + size)
+        {
+          RDCERR("Mip %u, slice %u has %llu bytes, expected at least %llu", mip, slice,
+                 (uint64_t)datasize, offset + size);
+
+          delete[] bytes;
+          FileIO::fclose(ddsFile);
+          return false;
+        }
+
+        bool written = FileIO::fwrite(bytes + offset, 1, (size_t)size, ddsFile) == size;
+
+        delete[] bytes;
+        ddsWritten++;
+
+        if(!written)
+        {
+          RDCERR("Failed to write DDS data: %s", FileIO::ErrorString().c_str());
+          FileIO::fclose(ddsFile);
+          return false;
+        }
+
+        if(td.depth > 1 && numSlices > 1)
+          s += (RDCMAX(1U, td.depth >> m) - 1);
+
+        continue;
+      }
+
       if(td.depth == 1)
       {
         subdata.push_back(bytes);
@@ -833,29 +1425,9 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
   int numComps = td.format.compCount;
 
   // if we want a grayscale image of one channel, splat it across all channels
-  // and set alpha to full
-  if(sd.channelExtract >= 0 && td.format.compByteWidth == 1 &&
-     (uint32_t)sd.channelExtract < td.format.compCount)
-  {
-    uint32_t cc = td.format.compCount;
-
-    for(uint32_t y = 0; y < td.height; y++)
-    {
-      for(uint32_t x = 0; x < td.width; x++)
-      {
-        subdata[0][(y * td.width + x) * cc + 0] =
-            subdata[0][(y * td.width + x) * cc + sd.channelExtract];
-        if(cc >= 2)
-          subdata[0][(y * td.width + x) * cc + 1] =
-              subdata[0][(y * td.width + x) * cc + sd.channelExtract];
-        if(cc >= 3)
-          subdata[0][(y * td.width + x) * cc + 2] =
-              subdata[0][(y * td.width + x) * cc + sd.channelExtract];
-        if(cc >= 4)
-          subdata[0][(y * td.width + x) * cc + 3] = 255;
-      }
-    }
-  }
+  // and set alpha to full. DDS subresources were already handled as they were written
+  if(extractChannel && !subdata.empty())
+    ExtractChannel(subdata[0], td.width, td.height, td.format.compCount, sd.channelExtract);
 
   // handle formats that don't support alpha
   if(numComps == 4 && (sd.destType == FileType::BMP || sd.destType == FileType::JPG))
@@ -941,7 +1513,7 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
     rowPitch = td.width * 3;
   }
 
-  FILE *f = FileIO::fopen(path, "wb");
+  FILE *f = ddsFile ? ddsFile : FileIO::fopen(path, "wb");
 
   if(!f)
   {
@@ -952,18 +1524,8 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
   {
     if(sd.destType == FileType::DDS)
     {
-      dds_data ddsData;
-
-      ddsData.width = td.width;
-      ddsData.height = td.height;
-      ddsData.depth = td.depth;
-      ddsData.format = td.format;
-      ddsData.mips = numMips;
-      ddsData.slices = numSlices / td.depth;
-      ddsData.subdata = &subdata[0];
-      ddsData.cubemap = td.cubemap && numSlices == 6;
-
-      success = write_dds_to_file(f, ddsData);
+      // the subresources were all written as they were fetched
+      success = true;
     }
     else if(sd.destType == FileType::BMP)
     {
@@ -980,12 +1542,10 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
       for(uint32_t p = 0; sd.alpha == AlphaMapping::Discard && p < td.width * td.height; p++)
         subdata[0][p * 4 + 3] = 255;
 
-      int ret = stbi_write_png_to_func(fileWriteFunc, (void *)f, td.width, td.height, numComps,
-                                       subdata[0], rowPitch);
-      success = (ret != 0);
+      success = write_png_to_file(f, td.width, td.height, numComps, subdata[0], rowPitch);
 
       if(!success)
-        RDCERR("stbi_write_png_to_func failed: %d", ret);
+        RDCERR("write_png_to_file failed");
     }
     else if(sd.destType == FileType::TGA)
     {
@@ -1002,26 +1562,10 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
     }
     else if(sd.destType == FileType::JPG)
     {
-      jpge::params p;
-      p.m_quality = sd.jpegQuality;
-
-      int len = td.width * td.height * td.format.compCount;
-      // ensure buffer is at least 1024
-      if(len < 1024)
-        len = 1024;
-
-      char *jpgdst = new char[len];
-
-      success = jpge::compress_image_to_jpeg_file_in_memory(jpgdst, len, td.width, td.height,
-                                                            numComps, subdata[0], p);
+      success = write_jpg_to_file(f, td.width, td.height, numComps, subdata[0], sd.jpegQuality);
 
       if(!success)
-        RDCERR("jpge::compress_image_to_jpeg_file_in_memory failed");
-
-      if(success)
-        fwrite(jpgdst, 1, len, f);
-
-      delete[] jpgdst;
+        RDCERR("write_jpg_to_file failed");
     }
     else if(sd.destType == FileType::HDR || sd.destType == FileType::EXR)
     {
@@ -1040,8 +1584,6 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
         abgr[3] = new float[td.width * td.height];
       }
 
-      byte *srcData = subdata[0];
-
       ResourceFormat saveFmt = td.format;
       if(saveFmt.compType == CompType::Typeless)
         saveFmt.compType = sd.typeHint;
@@ -1054,8 +1596,18 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
       if(saveFmt.compType == CompType::Depth && pixStride == 3)
         pixStride = 4;
 
-      for(uint32_t y = 0; y < td.height; y++)
-      {
+      // the packed formats below are read as one 32-bit word per pixel
+      uint32_t rowStride = td.width * pixStride;
+      if(saveFmt.special && (saveFmt.specialFormat == SpecialFormat::R10G10B10A2 ||
+                             saveFmt.specialFormat == SpecialFormat::R11G11B10))
+        rowStride = td.width * 4;
+
+      // every row converts independently, so spread them across threads - for large HDR targets
+      // this is as expensive as the encode itself
+      Threading::ParallelFor((int32_t)td.height, [&](int32_t row) {
+        uint32_t y = (uint32_t)row;
+        byte *srcData = subdata[0] + size_t(y) * rowStride;
+
         for(uint32_t x = 0; x < td.width; x++)
         {
           float r = 0.0f;
@@ -1151,7 +1703,7 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
             abgr[3][(y * td.width + x)] = r;
           }
         }
-      }
+      });
 
       if(sd.destType == FileType::HDR)
       {
@@ -1248,64 +1800,9 @@ rdctype::array<PixelModification> ReplayController::PixelHistory(ResourceId targ
     }
   }
 
-  auto usage = m_pDevice->GetUsage(m_pDevice->GetLiveID(target));
-
-  vector<EventUsage> events;
-
-  for(size_t i = 0; i < usage.size(); i++)
-  {
-    if(usage[i].eventID > m_EventID)
-      continue;
-
-    switch(usage[i].usage)
-    {
-      case ResourceUsage::VertexBuffer:
-      case ResourceUsage::IndexBuffer:
-      case ResourceUsage::VS_Constants:
-      case ResourceUsage::HS_Constants:
-      case ResourceUsage::DS_Constants:
-      case ResourceUsage::GS_Constants:
-      case ResourceUsage::PS_Constants:
-      case ResourceUsage::CS_Constants:
-      case ResourceUsage::All_Constants:
-      case ResourceUsage::VS_Resource:
-      case ResourceUsage::HS_Resource:
-      case ResourceUsage::DS_Resource:
-      case ResourceUsage::GS_Resource:
-      case ResourceUsage::PS_Resource:
-      case ResourceUsage::CS_Resource:
-      case ResourceUsage::All_Resource:
-      case ResourceUsage::InputTarget:
-      case ResourceUsage::CopySrc:
-      case ResourceUsage::ResolveSrc:
-      case ResourceUsage::Barrier:
-      case ResourceUsage::Indirect:
-        // read-only, not a valid pixel history event
-        continue;
-
-      case ResourceUsage::Unused:
-      case ResourceUsage::StreamOut:
-      case ResourceUsage::VS_RWResource:
-      case ResourceUsage::HS_RWResource:
-      case ResourceUsage::DS_RWResource:
-      case ResourceUsage::GS_RWResource:
-      case ResourceUsage::PS_RWResource:
-      case ResourceUsage::CS_RWResource:
-      case ResourceUsage::All_RWResource:
-      case ResourceUsage::ColorTarget:
-      case ResourceUsage::DepthStencilTarget:
-      case ResourceUsage::Clear:
-      case ResourceUsage::Copy:
-      case ResourceUsage::CopyDst:
-      case ResourceUsage::Resolve:
-      case ResourceUsage::ResolveDst:
-      case ResourceUsage::GenMips:
-        // writing - include in pixel history events
-        break;
-    }
-
-    events.push_back(usage[i]);
-  }
+  // only writing usages up to the current event are valid pixel history events
+  vector<EventUsage> events =
+      m_pDevice->GetUsage(m_pDevice->GetLiveID(target), 0, m_EventID, WriteUsageMask());
 
   if(events.empty())
   {
@@ -1475,6 +1972,8 @@ void ReplayController::ReplaceResource(ResourceId from, ResourceId to)
 {
   m_pDevice->ReplaceResource(from, to);
 
+  ClearReadbackCache();
+
   SetFrameEvent(m_EventID, true);
 
   for(size_t i = 0; i < m_Outputs.size(); i++)
@@ -1486,6 +1985,8 @@ void ReplayController::RemoveReplacement(ResourceId id)
 {
   m_pDevice->RemoveReplacement(id);
 
+  ClearReadbackCache();
+
   SetFrameEvent(m_EventID, true);
 
   for(size_t i = 0; i < m_Outputs.size(); i++)
@@ -1497,6 +1998,8 @@ ReplayStatus ReplayController::CreateDevice(const char *logfile)
 {
   RDCLOG("Creating replay device for %s", logfile);
 
+  m_Logfile = logfile;
+
   RDCDriver driverType = RDC_Unknown;
   string driverName = "";
   uint64_t fileMachineIdent = 0;
@@ -1552,6 +2055,13 @@ ReplayStatus ReplayController::PostCreateInit(IReplayDriver *device)
 void ReplayController::FileChanged()
 {
   m_pDevice->FileChanged();
+
+  ClearReadbackCache();
+}
+
+bool ReplayController::HasFileChanged()
+{
+  return m_pDevice->HasFileChanged();
 }
 
 bool ReplayController::HasCallstacks()
@@ -1657,6 +2167,10 @@ extern "C" RENDERDOC_API void RENDERDOC_CC ReplayRenderer_FileChanged(IReplayCon
 {
   rend->FileChanged();
 }
+extern "C" RENDERDOC_API bool32 RENDERDOC_CC ReplayRenderer_HasFileChanged(IReplayController *rend)
+{
+  return rend->HasFileChanged();
+}
 
 extern "C" RENDERDOC_API bool32 RENDERDOC_CC ReplayRenderer_HasCallstacks(IReplayController *rend)
 {
@@ -1749,6 +2263,11 @@ extern "C" RENDERDOC_API void RENDERDOC_CC ReplayRenderer_GetFrameInfo(IReplayCo
   *frame = rend->GetFrameInfo();
 }
 extern "C" RENDERDOC_API void RENDERDOC_CC
+ReplayRenderer_GetCaptureStatistics(IReplayController *rend, CaptureStatistics *stats)
+{
+  *stats = rend->GetCaptureStatistics();
+}
+extern "C" RENDERDOC_API void RENDERDOC_CC
 ReplayRenderer_GetDrawcalls(IReplayController *rend, rdctype::array<DrawcallDescription> *draws)
 {
   *draws = rend->GetDrawcalls();
@@ -1837,6 +2356,13 @@ extern "C" RENDERDOC_API void RENDERDOC_CC ReplayRenderer_GetUsage(IReplayContro
   *usage = rend->GetUsage(id);
 }
 
+extern "C" RENDERDOC_API void RENDERDOC_CC ReplayRenderer_GetUsageInRange(
+    IReplayController *rend, ResourceId id, uint32_t firstEventID, uint32_t lastEventID,
+    const rdctype::array<ResourceUsage> *usages, rdctype::array<EventUsage> *usage)
+{
+  *usage = rend->GetUsageInRange(id, firstEventID, lastEventID, *usages);
+}
+
 extern "C" RENDERDOC_API void RENDERDOC_CC ReplayRenderer_GetCBufferVariableContents(
     IReplayController *rend, ResourceId shader, const char *entryPoint, uint32_t cbufslot,
     ResourceId buffer, uint64_t offs, rdctype::array<ShaderVariable> *vars)
@@ -1875,3 +2401,53 @@ extern "C" RENDERDOC_API void RENDERDOC_CC ReplayRenderer_GetTextureData(IReplay
 {
   *data = rend->GetTextureData(tex, arrayIdx, mip);
 }
+
+extern "C" RENDERDOC_API IReadbackStream *RENDERDOC_CC ReplayRenderer_StreamBufferData(
+    IReplayController *rend, ResourceId buff, uint64_t offset, uint64_t len, uint32_t chunkSize)
+{
+  return rend->StreamBufferData(buff, offset, len, chunkSize);
+}
+
+extern "C" RENDERDOC_API IReadbackStream *RENDERDOC_CC ReplayRenderer_StreamTextureData(
+    IReplayController *rend, ResourceId tex, uint32_t arrayIdx, uint32_t mip, uint32_t chunkSize)
+{
+  return rend->StreamTextureData(tex, arrayIdx, mip, chunkSize);
+}
+
+extern "C" RENDERDOC_API void RENDERDOC_CC
+ReplayRenderer_ShutdownReadbackStream(IReplayController *rend, IReadbackStream *stream)
+{
+  rend->ShutdownReadbackStream(stream);
+}
+
+extern "C" RENDERDOC_API uint64_t RENDERDOC_CC ReadbackStream_GetTotalSize(IReadbackStream *stream)
+{
+  return stream->GetTotalSize();
+}
+
+extern "C" RENDERDOC_API uint64_t RENDERDOC_CC ReadbackStream_GetOffset(IReadbackStream *stream)
+{
+  return stream->GetOffset();
+}
+
+extern "C" RENDERDOC_API void RENDERDOC_CC ReadbackStream_ReadChunk(IReadbackStream *stream,
+                                                                   rdctype::array<byte> *data)
+{
+  *data = stream->ReadChunk();
+}
+
+extern "C" RENDERDOC_API void RENDERDOC_CC
+ReplayRenderer_SetPrefetchEnabled(IReplayController *rend, bool32 enabled)
+{
+  rend->SetPrefetchEnabled(enabled != 0);
+}
+
+extern "C" RENDERDOC_API bool32 RENDERDOC_CC ReplayRenderer_ProcessPrefetch(IReplayController *rend)
+{
+  return rend->ProcessPrefetch();
+}
+
+extern "C" RENDERDOC_API void RENDERDOC_CC ReplayRenderer_CancelPrefetch(IReplayController *rend)
+{
+  rend->CancelPrefetch();
+}
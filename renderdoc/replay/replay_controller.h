@@ -25,6 +25,9 @@
 
 #pragma once
 
+#include <deque>
+#include <list>
+#include <map>
 #include <set>
 #include <vector>
 #include "api/replay/renderdoc_replay.h"
@@ -117,6 +120,35 @@ private:
   friend struct ReplayController;
 };
 
+struct ReplayReadbackStream : public IReadbackStream
+{
+public:
+  uint64_t GetTotalSize() { return m_TotalSize; }
+  uint64_t GetOffset() { return m_Offset; }
+  rdctype::array<byte> ReadChunk();
+
+private:
+  ReplayReadbackStream(IReplayDriver *device, ResourceId liveId, uint32_t chunkSize);
+  virtual ~ReplayReadbackStream();
+
+  IReplayDriver *m_pDevice;
+  ResourceId m_LiveID;
+  uint32_t m_ChunkSize;
+
+  uint64_t m_TotalSize;
+  uint64_t m_Offset;
+
+  // buffers are read back one chunk at a time, starting from this offset in the buffer
+  uint64_t m_BufferOffset;
+  vector<byte> m_BufferChunk;
+
+  // drivers can only read back whole texture subresources, so the data is fetched up front and
+  // handed out in chunks. It's released as soon as the last chunk has been read
+  byte *m_TextureData;
+
+  friend struct ReplayController;
+};
+
 struct ReplayController : public IReplayController
 {
 public:
@@ -129,6 +161,7 @@ public:
   ReplayStatus SetDevice(IReplayDriver *device);
 
   void FileChanged();
+  bool HasFileChanged();
 
   bool HasCallstacks();
   bool InitResolver();
@@ -155,6 +188,7 @@ public:
   void FreeTargetResource(ResourceId id);
 
   FrameDescription GetFrameInfo();
+  CaptureStatistics GetCaptureStatistics();
   rdctype::array<DrawcallDescription> GetDrawcalls();
   rdctype::array<CounterResult> FetchCounters(const rdctype::array<GPUCounter> &counters);
   rdctype::array<GPUCounter> EnumerateCounters();
@@ -176,12 +210,25 @@ public:
   MeshFormat GetPostVSData(uint32_t instID, MeshDataStage stage);
 
   rdctype::array<EventUsage> GetUsage(ResourceId id);
+  rdctype::array<EventUsage> GetUsageInRange(ResourceId id, uint32_t firstEventID,
+                                             uint32_t lastEventID,
+                                             const rdctype::array<ResourceUsage> &usages);
 
   rdctype::array<byte> GetBufferData(ResourceId buff, uint64_t offset, uint64_t len);
   rdctype::array<byte> GetTextureData(ResourceId buff, uint32_t arrayIdx, uint32_t mip);
 
+  IReadbackStream *StreamBufferData(ResourceId buff, uint64_t offset, uint64_t len,
+                                    uint32_t chunkSize);
+  IReadbackStream *StreamTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t mip,
+                                     uint32_t chunkSize);
+  void ShutdownReadbackStream(IReadbackStream *stream);
+
   bool SaveTexture(const TextureSave &saveData, const char *path);
 
+  void SetPrefetchEnabled(bool enabled);
+  bool ProcessPrefetch();
+  void CancelPrefetch();
+
   rdctype::array<ShaderVariable> GetCBufferVariableContents(ResourceId shader, const char *entryPoint,
                                                             uint32_t cbufslot, ResourceId buffer,
                                                             uint64_t offs);
@@ -198,10 +245,92 @@ private:
 
   DrawcallDescription *GetDrawcallByEID(uint32_t eventID);
 
+  // readback data is cached by the event it was fetched at, and the subresource or byte range.
+  // Buffer keys have arrayIdx and mip set to ~0U, texture keys have offset and length set to 0.
+  struct ReadbackKey
+  {
+    uint32_t eventID;
+    ResourceId id;
+    uint32_t arrayIdx, mip;
+    uint64_t offset, length;
+
+    bool operator<(const ReadbackKey &o) const
+    {
+      if(eventID != o.eventID)
+        return eventID < o.eventID;
+      if(id != o.id)
+        return id < o.id;
+      if(arrayIdx != o.arrayIdx)
+        return arrayIdx < o.arrayIdx;
+      if(mip != o.mip)
+        return mip < o.mip;
+      if(offset != o.offset)
+        return offset < o.offset;
+      return length < o.length;
+    }
+  };
+
+  struct ReadbackData
+  {
+    vector<byte> data;
+    // position in m_ReadbackLRU
+    std::list<ReadbackKey>::iterator lru;
+  };
+
+  // min/max and histogram results are cached alongside readbacks, as they're also fixed for a
+  // given texture subresource at an event. Histogram keys include the range and channels.
+  struct ReductionKey
+  {
+    uint32_t eventID;
+    ResourceId id;
+    uint32_t sliceFace, mip, sample;
+    CompType typeHint;
+    float minval, maxval;
+    uint32_t channels;
+
+    bool operator<(const ReductionKey &o) const
+    {
+      if(eventID != o.eventID)
+        return eventID < o.eventID;
+      if(id != o.id)
+        return id < o.id;
+      if(sliceFace != o.sliceFace)
+        return sliceFace < o.sliceFace;
+      if(mip != o.mip)
+        return mip < o.mip;
+      if(sample != o.sample)
+        return sample < o.sample;
+      if(typeHint != o.typeHint)
+        return typeHint < o.typeHint;
+      if(minval != o.minval)
+        return minval < o.minval;
+      if(maxval != o.maxval)
+        return maxval < o.maxval;
+      return channels < o.channels;
+    }
+  };
+
+  void GetMinMax(ResourceId id, ResourceId liveId, uint32_t sliceFace, uint32_t mip,
+                 uint32_t sample, CompType typeHint, PixelValue &minval, PixelValue &maxval);
+  void GetHistogram(ResourceId id, ResourceId liveId, uint32_t sliceFace, uint32_t mip,
+                    uint32_t sample, CompType typeHint, float minval, float maxval,
+                    bool channels[4], vector<uint32_t> &histogram);
+
+  bool IsCacheableResource(ResourceId id);
+  ReadbackData *FindReadback(const ReadbackKey &key);
+  void CacheReadback(const ReadbackKey &key, vector<byte> &data);
+  void ClearReadbackCache();
+
+  void QueuePrefetch(const DrawcallDescription *draw, bool current);
+  void FetchPrefetch(const ReadbackKey &key);
+
   IReplayDriver *GetDevice() { return m_pDevice; }
   FrameRecord m_FrameRecord;
   vector<DrawcallDescription *> m_Drawcalls;
 
+  string m_Logfile;
+  CaptureStatistics m_CaptureStatistics;
+
   uint32_t m_EventID;
 
   D3D11Pipe::State m_D3D11PipelineState;
@@ -210,6 +339,7 @@ private:
   VKPipe::State m_VulkanPipelineState;
 
   std::vector<ReplayOutput *> m_Outputs;
+  std::vector<ReplayReadbackStream *> m_ReadbackStreams;
 
   std::vector<BufferDescription> m_Buffers;
   std::vector<TextureDescription> m_Textures;
@@ -219,5 +349,18 @@ private:
   std::set<ResourceId> m_TargetResources;
   std::set<ResourceId> m_CustomShaders;
 
+  // only used while prefetching is enabled, since nothing else reads back the same data twice
+  std::map<ReadbackKey, ReadbackData> m_ReadbackCache;
+  // cached keys, most recently used first
+  std::list<ReadbackKey> m_ReadbackLRU;
+  uint64_t m_ReadbackCacheSize;
+
+  std::map<ReductionKey, rdctype::pair<PixelValue, PixelValue> > m_MinMaxCache;
+  std::map<ReductionKey, vector<uint32_t> > m_HistogramCache;
+
+  // speculative fetches waiting for idle time, in priority order, only if enabled
+  bool m_PrefetchEnabled;
+  std::deque<ReadbackKey> m_PrefetchQueue;
+
   friend struct ReplayOutput;
 };
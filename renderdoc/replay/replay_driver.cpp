@@ -23,6 +23,7 @@
  ******************************************************************************/
 
 #include "replay_driver.h"
+#include <algorithm>
 #include "maths/formatpacking.h"
 
 DrawcallDescription *SetupDrawcallPointers(vector<DrawcallDescription *> *drawcallTable,
@@ -80,6 +81,204 @@ DrawcallDescription *SetupDrawcallPointers(vector<DrawcallDescription *> *drawca
   return ret;
 }
 
+uint64_t WriteUsageMask()
+{
+  return UsageMask(ResourceUsage::StreamOut) | UsageMask(ResourceUsage::VS_RWResource) |
+         UsageMask(ResourceUsage::HS_RWResource) | UsageMask(ResourceUsage::DS_RWResource) |
+         UsageMask(ResourceUsage::GS_RWResource) | UsageMask(ResourceUsage::PS_RWResource) |
+         UsageMask(ResourceUsage::CS_RWResource) | UsageMask(ResourceUsage::All_RWResource) |
+         UsageMask(ResourceUsage::ColorTarget) | UsageMask(ResourceUsage::DepthStencilTarget) |
+         UsageMask(ResourceUsage::Clear) | UsageMask(ResourceUsage::Copy) |
+         UsageMask(ResourceUsage::CopyDst) | UsageMask(ResourceUsage::Resolve) |
+         UsageMask(ResourceUsage::ResolveDst) | UsageMask(ResourceUsage::GenMips) |
+         UsageMask(ResourceUsage::Unused);
+}
+
+vector<EventUsage> FilterUsage(const vector<EventUsage> &usage, uint32_t minEventID,
+                               uint32_t maxEventID, uint64_t usageMask)
+{
+  vector<EventUsage> ret;
+
+  // not all drivers keep their usage lists sorted, so this is a plain linear scan
+  for(size_t i = 0; i < usage.size(); i++)
+  {
+    const EventUsage &u = usage[i];
+    if(u.eventID >= minEventID && u.eventID <= maxEventID && (usageMask & UsageMask(u.usage)))
+      ret.push_back(u);
+  }
+
+  return ret;
+}
+
+void ResourceUsageIndex::Build(std::map<ResourceId, vector<EventUsage> > &uses)
+{
+  m_Entries.clear();
+  m_EventDeltas.clear();
+  m_Usages.clear();
+  m_BlockEventIDs.clear();
+  m_BlockOffsets.clear();
+  m_Views.clear();
+
+  size_t total = 0;
+  for(auto it = uses.begin(); it != uses.end(); ++it)
+    total += it->second.size();
+
+  m_Entries.reserve(uses.size());
+  m_Usages.reserve(total);
+  // most deltas fit in a byte
+  m_EventDeltas.reserve(total);
+  m_BlockEventIDs.reserve(total / BlockSize + uses.size());
+  m_BlockOffsets.reserve(total / BlockSize + uses.size());
+
+  // std::map iterates in ID order so the entries are sorted as we go
+  for(auto it = uses.begin(); it != uses.end(); ++it)
+  {
+    vector<EventUsage> &v = it->second;
+
+    if(v.empty())
+      continue;
+
+    std::sort(v.begin(), v.end());
+    v.erase(std::unique(v.begin(), v.end()), v.end());
+
+    Entry e;
+    e.id = it->first;
+    e.firstUsage = (uint32_t)m_Usages.size();
+    e.numUsages = (uint32_t)v.size();
+    e.firstBlock = (uint32_t)m_BlockEventIDs.size();
+    e.firstEventID = v.front().eventID;
+    e.lastEventID = v.back().eventID;
+    e.hasViews = false;
+    e.usageMask = 0;
+
+    uint32_t prevEID = 0;
+
+    for(size_t i = 0; i < v.size(); i++)
+    {
+      uint32_t eid = v[i].eventID;
+
+      if((i % BlockSize) == 0)
+      {
+        m_BlockEventIDs.push_back(eid);
+        m_BlockOffsets.push_back((uint32_t)m_EventDeltas.size());
+      }
+      else
+      {
+        // LEB128 encode the delta
+        uint32_t delta = eid - prevEID;
+        do
+        {
+          byte b = delta & 0x7f;
+          delta >>= 7;
+          if(delta)
+            b |= 0x80;
+          m_EventDeltas.push_back(b);
+        } while(delta);
+      }
+
+      prevEID = eid;
+
+      m_Usages.push_back((uint8_t)v[i].usage);
+      e.usageMask |= UsageMask(v[i].usage);
+
+      if(v[i].view != ResourceId())
+      {
+        m_Views.push_back(std::make_pair(e.firstUsage + (uint32_t)i, v[i].view));
+        e.hasViews = true;
+      }
+    }
+
+    m_Entries.push_back(e);
+  }
+
+  uses.clear();
+
+  RDCLOG("Built resource usage index: %zu usages over %zu resources in %zu bytes", m_Usages.size(),
+         m_Entries.size(), GetMemoryUsage());
+}
+
+vector<EventUsage> ResourceUsageIndex::Query(ResourceId id, uint32_t minEventID,
+                                             uint32_t maxEventID, uint64_t usageMask) const
+{
+  vector<EventUsage> ret;
+
+  auto entry = std::lower_bound(m_Entries.begin(), m_Entries.end(), id);
+
+  if(entry == m_Entries.end() || entry->id != id)
+    return ret;
+
+  const Entry &e = *entry;
+
+  if((e.usageMask & usageMask) == 0 || e.firstEventID > maxEventID || e.lastEventID < minEventID)
+    return ret;
+
+  // find the last block starting at or before minEventID
+  uint32_t numBlocks = (e.numUsages + BlockSize - 1) / BlockSize;
+  const uint32_t *blockBegin = &m_BlockEventIDs[e.firstBlock];
+  uint32_t block = uint32_t(std::upper_bound(blockBegin, blockBegin + numBlocks, minEventID) - blockBegin);
+  if(block > 0)
+    block--;
+
+  // blocks can share an event ID at their boundary, step back to the first so we don't skip
+  // any usages at minEventID.
+  while(block > 0 && blockBegin[block] >= minEventID)
+    block--;
+
+  const byte *delta = m_EventDeltas.data() + m_BlockOffsets[e.firstBlock + block];
+
+  uint32_t eid = 0;
+
+  for(uint32_t i = block * BlockSize; i < e.numUsages; i++)
+  {
+    if((i % BlockSize) == 0)
+    {
+      eid = m_BlockEventIDs[e.firstBlock + i / BlockSize];
+    }
+    else
+    {
+      uint32_t d = 0, shift = 0;
+      byte b;
+      do
+      {
+        b = *(delta++);
+        d |= uint32_t(b & 0x7f) << shift;
+        shift += 7;
+      } while(b & 0x80);
+
+      eid += d;
+    }
+
+    if(eid > maxEventID)
+      break;
+
+    ResourceUsage usage = (ResourceUsage)m_Usages[e.firstUsage + i];
+
+    if(eid < minEventID || (usageMask & UsageMask(usage)) == 0)
+      continue;
+
+    EventUsage u(eid, usage);
+
+    if(e.hasViews)
+    {
+      auto view = std::lower_bound(m_Views.begin(), m_Views.end(),
+                                   std::make_pair(e.firstUsage + i, ResourceId()));
+      if(view != m_Views.end() && view->first == e.firstUsage + i)
+        u.view = view->second;
+    }
+
+    ret.push_back(u);
+  }
+
+  return ret;
+}
+
+size_t ResourceUsageIndex::GetMemoryUsage() const
+{
+  return m_Entries.size() * sizeof(Entry) + m_EventDeltas.size() + m_Usages.size() +
+         m_BlockEventIDs.size() * sizeof(uint32_t) + m_BlockOffsets.size() * sizeof(uint32_t) +
+         m_Views.size() * sizeof(m_Views[0]);
+}
+
 FloatVector HighlightCache::InterpretVertex(byte *data, uint32_t vert, const MeshDisplay &cfg,
                                             byte *end, bool useidx, bool &valid)
 {
@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include <map>
 #include "api/replay/renderdoc_replay.h"
 #include "core/core.h"
 #include "maths/vec.h"
@@ -92,7 +93,8 @@ public:
 
   virtual ShaderReflection *GetShader(ResourceId shader, string entryPoint) = 0;
 
-  virtual vector<EventUsage> GetUsage(ResourceId id) = 0;
+  virtual vector<EventUsage> GetUsage(ResourceId id, uint32_t minEventID, uint32_t maxEventID,
+                                      uint64_t usageMask) = 0;
 
   virtual void SavePipelineState() = 0;
   virtual D3D11Pipe::State GetD3D11PipelineState() = 0;
@@ -148,6 +150,8 @@ public:
   virtual bool IsRenderOutput(ResourceId id) = 0;
 
   virtual void FileChanged() = 0;
+  // true if the file has changed on disk and FileChanged() should be called to pick it up
+  virtual bool HasFileChanged() = 0;
 
   virtual void InitCallstackResolver() = 0;
   virtual bool HasCallstacks() = 0;
@@ -210,6 +214,72 @@ DrawcallDescription *SetupDrawcallPointers(std::vector<DrawcallDescription *> *d
                                            DrawcallDescription *parent,
                                            DrawcallDescription *previous);
 
+// bitmask of ResourceUsage values, for filtering usage queries
+inline uint64_t UsageMask(ResourceUsage usage)
+{
+  return 1ULL << (uint32_t)usage;
+}
+
+static const uint64_t AllUsageMask = ~0ULL;
+
+// usages that (potentially) modify the contents of the resource
+uint64_t WriteUsageMask();
+
+// filters a list of usages sorted by event ID to those within [minEventID, maxEventID] and
+// matching the mask
+vector<EventUsage> FilterUsage(const vector<EventUsage> &usage, uint32_t minEventID,
+                               uint32_t maxEventID, uint64_t usageMask);
+
+// compact read-only index of resource usage over the whole frame, built once after the initial
+// read of a capture. Usages are stored in columns across all resources - event IDs as
+// variable-length deltas from the previous usage of the same resource with an absolute event ID
+// every few entries to allow seeking, and usage types as bytes. The rare usages with a view are
+// stored separately.
+class ResourceUsageIndex
+{
+public:
+  ResourceUsageIndex() {}
+  // consumes the usage map, which is cleared
+  void Build(std::map<ResourceId, vector<EventUsage> > &uses);
+
+  // returns the usages of id within [minEventID, maxEventID] and matching the mask, sorted by event
+  vector<EventUsage> Query(ResourceId id, uint32_t minEventID = 0, uint32_t maxEventID = ~0U,
+                           uint64_t usageMask = AllUsageMask) const;
+
+  size_t GetNumUsages() const { return m_Usages.size(); }
+  size_t GetMemoryUsage() const;
+
+private:
+  static const uint32_t BlockSize = 64;
+
+  struct Entry
+  {
+    ResourceId id;
+    uint32_t firstUsage;    // index into m_Usages
+    uint32_t numUsages;
+    uint32_t firstBlock;    // index into m_BlockEventIDs / m_BlockOffsets
+    uint32_t firstEventID;
+    uint32_t lastEventID;
+    bool hasViews;
+    uint64_t usageMask;    // all ResourceUsage values present for this resource
+
+    bool operator<(const ResourceId &o) const { return id < o; }
+  };
+
+  vector<Entry> m_Entries;    // sorted by ID
+
+  vector<byte> m_EventDeltas;
+  vector<uint8_t> m_Usages;
+
+  // the absolute event ID of the first usage in each block, and the offset in m_EventDeltas of the
+  // delta for the following usage
+  vector<uint32_t> m_BlockEventIDs;
+  vector<uint32_t> m_BlockOffsets;
+
+  // usage index -> view, sorted
+  vector<std::pair<uint32_t, ResourceId> > m_Views;
+};
+
 // simple cache for when we need buffer data for highlighting
 // vertices, typical use will be lots of vertices in the same
 // mesh, not jumping back and forth much between meshes.
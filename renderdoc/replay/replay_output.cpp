@@ -285,7 +285,8 @@ rdctype::pair<PixelValue, PixelValue> ReplayOutput::GetMinMax()
   PixelValue minval;
   PixelValue maxval;
 
-  ResourceId tex = m_pDevice->GetLiveID(m_RenderData.texDisplay.texid);
+  ResourceId id = m_RenderData.texDisplay.texid;
+  ResourceId tex = m_pDevice->GetLiveID(id);
 
   CompType typeHint = m_RenderData.texDisplay.typeHint;
   uint32_t slice = m_RenderData.texDisplay.sliceFace;
@@ -294,13 +295,13 @@ rdctype::pair<PixelValue, PixelValue> ReplayOutput::GetMinMax()
 
   if(m_RenderData.texDisplay.CustomShader != ResourceId() && m_CustomShaderResourceId != ResourceId())
   {
-    tex = m_CustomShaderResourceId;
+    id = tex = m_CustomShaderResourceId;
     typeHint = CompType::Typeless;
     slice = 0;
     sample = 0;
   }
 
-  m_pDevice->GetMinMax(tex, slice, mip, sample, typeHint, &minval.value_f[0], &maxval.value_f[0]);
+  m_pRenderer->GetMinMax(id, tex, slice, mip, sample, typeHint, minval, maxval);
 
   return rdctype::make_pair(minval, maxval);
 }
@@ -309,7 +310,8 @@ rdctype::array<uint32_t> ReplayOutput::GetHistogram(float minval, float maxval,
 {
   vector<uint32_t> hist;
 
-  ResourceId tex = m_pDevice->GetLiveID(m_RenderData.texDisplay.texid);
+  ResourceId id = m_RenderData.texDisplay.texid;
+  ResourceId tex = m_pDevice->GetLiveID(id);
 
   CompType typeHint = m_RenderData.texDisplay.typeHint;
   uint32_t slice = m_RenderData.texDisplay.sliceFace;
@@ -318,13 +320,13 @@ rdctype::array<uint32_t> ReplayOutput::GetHistogram(float minval, float maxval,
 
   if(m_RenderData.texDisplay.CustomShader != ResourceId() && m_CustomShaderResourceId != ResourceId())
   {
-    tex = m_CustomShaderResourceId;
+    id = tex = m_CustomShaderResourceId;
     typeHint = CompType::Typeless;
     slice = 0;
     sample = 0;
   }
 
-  m_pDevice->GetHistogram(tex, slice, mip, sample, typeHint, minval, maxval, channels, hist);
+  m_pRenderer->GetHistogram(id, tex, slice, mip, sample, typeHint, minval, maxval, channels, hist);
 
   return hist;
 }
@@ -237,6 +237,82 @@ struct CompressedFileIO
   size_t m_CompressSize;
 };
 
+// process-wide store of deduplicated buffers, shared by every serialiser with deduplication
+// enabled so that identical data from any thread's chunks is only held once. Blobs are removed as
+// soon as the last chunk referencing them is deleted.
+struct BufferBlobStore
+{
+  Threading::CriticalSection lock;
+  std::map<uint64_t, SerialisedBlob *> blobs;
+};
+
+static BufferBlobStore &GetBlobStore()
+{
+  // never freed, as chunks can be deleted during shutdown in any order
+  static BufferBlobStore *store = new BufferBlobStore();
+  return *store;
+}
+
+// returns a blob holding a reference, or NULL if the data couldn't be deduplicated
+static SerialisedBlob *AcquireBufferBlob(const byte *data, uint32_t length)
+{
+  uint64_t hash = Hash64(data, length);
+
+  BufferBlobStore &store = GetBlobStore();
+
+  SCOPED_LOCK(store.lock);
+
+  auto it = store.blobs.find(hash);
+
+  if(it != store.blobs.end())
+  {
+    SerialisedBlob *blob = it->second;
+
+    // on the off chance of a hash collision, just write this buffer normally
+    if(blob->length != length || memcmp(blob->data, data, length) != 0)
+      return NULL;
+
+    blob->refcount++;
+    return blob;
+  }
+
+  SerialisedBlob *blob = new SerialisedBlob;
+  blob->hash = hash;
+  blob->length = length;
+  blob->data = new byte[length];
+  blob->refcount = 1;
+  memcpy(blob->data, data, length);
+
+  store.blobs[hash] = blob;
+
+  return blob;
+}
+
+static void AddBufferBlobRef(SerialisedBlob *blob)
+{
+  BufferBlobStore &store = GetBlobStore();
+
+  SCOPED_LOCK(store.lock);
+
+  blob->refcount++;
+}
+
+static void ReleaseBufferBlob(SerialisedBlob *blob)
+{
+  BufferBlobStore &store = GetBlobStore();
+
+  SCOPED_LOCK(store.lock);
+
+  blob->refcount--;
+
+  if(blob->refcount == 0)
+  {
+    store.blobs.erase(blob->hash);
+    SAFE_DELETE_ARRAY(blob->data);
+    SAFE_DELETE(blob);
+  }
+}
+
 Chunk::Chunk(Serialiser *ser, uint32_t chunkType, bool temporary)
 {
   m_Length = (uint32_t)ser->GetOffset();
@@ -263,6 +339,8 @@ Chunk::Chunk(Serialiser *ser, uint32_t chunkType, bool temporary)
   if(ser->GetDebugText())
     m_DebugStr = ser->GetDebugStr();
 
+  m_Blobs.swap(ser->m_PendingBlobs);
+
   ser->Rewind();
 
 #if ENABLED(RDOC_DEVEL)
@@ -295,6 +373,10 @@ Chunk *Chunk::Duplicate()
 
   memcpy(ret->m_Data, m_Data, m_Length);
 
+  ret->m_Blobs = m_Blobs;
+  for(size_t i = 0; i < m_Blobs.size(); i++)
+    AddBufferBlobRef(m_Blobs[i]);
+
 #if ENABLED(RDOC_DEVEL)
   int64_t newval = Atomic::Inc64(&m_LiveChunks);
   Atomic::ExchAdd64(&m_TotalMem, m_Length);
@@ -318,6 +400,9 @@ Chunk::~Chunk()
   Atomic::ExchAdd64(&m_TotalMem, -int64_t(m_Length));
 #endif
 
+  for(size_t i = 0; i < m_Blobs.size(); i++)
+    ReleaseBufferBlob(m_Blobs[i]);
+
   if(m_AlignedData)
   {
     if(m_Data)
@@ -399,6 +484,28 @@ Chunk::~Chunk()
  // binary form
  Section sections[];
 
+ -----------------------------
+ File format for version 0x33:
+
+ Identical to 0x32, except that buffers in the frame capture data may be
+ deduplicated. Instead of the usual uint32_t length, padding and data, a
+ deduplicated buffer is stored as:
+
+ uint32_t marker = 0xffffffff;
+ uint32_t length;
+ uint64_t hash;
+
+ and its data is found in the renderdoc/internal/blobs section, which is
+ usually LZ4 compressed and contains:
+
+ uint32_t numBlobs;
+ Blob
+ {
+   uint64_t hash;
+   uint32_t length;
+   byte data[length];
+ } blobs[numBlobs];
+
 */
 
 struct FileHeader
@@ -492,6 +599,9 @@ Serialiser::Serialiser(size_t length, const byte *memoryBuf, bool fileheader)
 
   const byte *memoryBufEnd = memoryBuf + length;
 
+  // end of the frame capture data, which may be followed by other sections
+  const byte *frameCapEnd = memoryBufEnd;
+
   m_SerVer = header->version;
 
   if(header->version == 0x00000031)    // backwards compatibility
@@ -535,11 +645,11 @@ Serialiser::Serialiser(size_t length, const byte *memoryBuf, bool fileheader)
     m_Sections.push_back(frameCap);
     m_KnownSections[eSectionType_FrameCapture] = frameCap;
   }
-  else if(header->version == SERIALISE_VERSION)
+  else if(header->version == SERIALISE_VERSION || header->version == 0x00000032)
   {
     memoryBuf += sizeof(FileHeader);
 
-    // when loading in-memory we only care about the first section, which should be binary
+    // the first section should be the binary frame capture
     const BinarySectionHeader *sectionHeader = (const BinarySectionHeader *)memoryBuf;
 
     // verify validity
@@ -583,9 +693,20 @@ Serialiser::Serialiser(size_t length, const byte *memoryBuf, bool fileheader)
       return;
     }
 
+    const byte *nextSection = memoryBufEnd;
+
+    {
+      uint64_t dataLength = sectionHeader->sectionLength;
+      if(sectionHeader->sectionFlags & eSectionFlag_LZ4Compressed)
+        dataLength += sizeof(uint64_t);
+
+      if(dataLength < uint64_t(memoryBufEnd - memoryBuf))
+        nextSection = memoryBuf + (size_t)dataLength;
+    }
+
     Section *frameCap = new Section();
     frameCap->fileoffset = 0;    // irrelevant
-    frameCap->data.assign(memoryBuf, memoryBufEnd);
+    frameCap->data.assign(memoryBuf, nextSection);
     frameCap->name = sectionHeader->name;
     frameCap->type = sectionHeader->sectionType;
     frameCap->flags = sectionHeader->sectionFlags;
@@ -609,6 +730,57 @@ Serialiser::Serialiser(size_t length, const byte *memoryBuf, bool fileheader)
 
     m_KnownSections[eSectionType_FrameCapture] = frameCap;
     m_Sections.push_back(frameCap);
+
+    frameCapEnd = nextSection;
+
+    // chunks can reference deduplicated buffers, which are written in their own section after the
+    // frame capture. Stop quietly if the buffer doesn't contain it, e.g. when only the start of the
+    // file was read. Any reference that can't be resolved is reported in SerialiseBuffer
+    while(nextSection + offsetof(BinarySectionHeader, name) < memoryBufEnd)
+    {
+      sectionHeader = (const BinarySectionHeader *)nextSection;
+
+      if(sectionHeader->isASCII != 0)
+        break;
+
+      const byte *sectionData = nextSection + offsetof(BinarySectionHeader, name);
+
+      if(sectionHeader->sectionNameLength > uint64_t(memoryBufEnd - sectionData))
+        break;
+
+      sectionData += sectionHeader->sectionNameLength;
+
+      uint64_t dataLength = sectionHeader->sectionLength;
+      if(sectionHeader->sectionFlags & eSectionFlag_LZ4Compressed)
+        dataLength += sizeof(uint64_t);
+
+      if(dataLength > uint64_t(memoryBufEnd - sectionData))
+        break;
+
+      if(sectionHeader->sectionType == eSectionType_BufferBlobs)
+      {
+        Section *sect = new Section();
+        sect->name = "renderdoc/internal/blobs";
+        sect->type = sectionHeader->sectionType;
+        sect->flags = sectionHeader->sectionFlags;
+        sect->size = sectionHeader->sectionLength;
+        sect->storedLength = sectionHeader->sectionLength;
+
+        if(sect->flags & eSectionFlag_LZ4Compressed)
+        {
+          memcpy(&sect->size, sectionData, sizeof(uint64_t));
+          sectionData += sizeof(uint64_t);
+        }
+
+        sect->data.assign(sectionData, sectionData + sectionHeader->sectionLength);
+
+        m_KnownSections[eSectionType_BufferBlobs] = sect;
+        m_Sections.push_back(sect);
+        break;
+      }
+
+      nextSection = sectionData + (size_t)dataLength;
+    }
   }
   else
   {
@@ -628,7 +800,7 @@ Serialiser::Serialiser(size_t length, const byte *memoryBuf, bool fileheader)
 
   if(m_KnownSections[eSectionType_FrameCapture]->flags & eSectionFlag_LZ4Compressed)
   {
-    CompressedFileIO::Decompress(m_Buffer, memoryBuf, memoryBufEnd - memoryBuf);
+    CompressedFileIO::Decompress(m_Buffer, memoryBuf, frameCapEnd - memoryBuf);
   }
   else
   {
@@ -744,7 +916,7 @@ Serialiser::Serialiser(const char *path, Mode mode, bool debugMode, uint64_t siz
       m_Sections.push_back(frameCap);
       m_KnownSections[eSectionType_FrameCapture] = frameCap;
     }
-    else if(header.version == SERIALISE_VERSION)
+    else if(header.version == SERIALISE_VERSION || header.version == 0x00000032)
     {
       while(!FileIO::feof(m_ReadFileHandle))
       {
@@ -859,6 +1031,7 @@ Serialiser::Serialiser(const char *path, Mode mode, bool debugMode, uint64_t siz
           FileIO::fread(&nullterm, 1, 1, m_ReadFileHandle);
 
           sect->fileoffset = FileIO::ftell64(m_ReadFileHandle);
+          sect->storedLength = sectionHeader.sectionLength;
 
           if(sect->flags & eSectionFlag_LZ4Compressed)
           {
@@ -873,8 +1046,12 @@ Serialiser::Serialiser(const char *path, Mode mode, bool debugMode, uint64_t siz
           m_Sections.push_back(sect);
 
           // if section isn't frame capture data and is small enough, read it all into memory now,
-          // otherwise skip
-          if(sect->type != eSectionType_FrameCapture && sectionHeader.sectionLength < 4 * 1024 * 1024)
+          // otherwise skip. Deduplicated buffers are loaded on demand in LoadBufferBlobs, so that
+          // opens which only want the first few chunks (e.g. the thumbnail) don't pay for them
+          bool loadSection = sect->type != eSectionType_FrameCapture &&
+                             sect->type != eSectionType_BufferBlobs &&
+                             sectionHeader.sectionLength < 4 * 1024 * 1024;
+          if(loadSection)
           {
             sect->data.resize(sectionHeader.sectionLength);
             FileIO::fread(&sect->data[0], 1, sectionHeader.sectionLength, m_ReadFileHandle);
@@ -980,6 +1157,11 @@ void Serialiser::Reset()
 
   m_AlignedData = false;
 
+  m_DedupBuffers = false;
+  m_LastBufferBlob = NULL;
+  m_LastBufferOffset = 0;
+  m_BlobsLoaded = false;
+
   m_ReadFileHandle = NULL;
 
   m_ReadOffset = 0;
@@ -1019,6 +1201,8 @@ Serialiser::~Serialiser()
 
   m_Chunks.clear();
 
+  ReleasePendingBlobs();
+
   SAFE_DELETE(m_pResolver);
   SAFE_DELETE(m_pCallstack);
   if(m_Buffer)
@@ -1234,6 +1418,10 @@ void Serialiser::SetPersistentBlock(uint64_t offs)
 
   RDCASSERT(m_ReadFileHandle);
 
+  // buffer blobs are read on demand from the file, so they must be in memory before the handle goes
+  if(!m_BlobsLoaded)
+    LoadBufferBlobs();
+
   // close the file handle
   FileIO::fclose(m_ReadFileHandle);
   m_ReadFileHandle = 0;
@@ -1392,6 +1580,28 @@ void Serialiser::FlushToDisk()
       FileIO::fwrite(&len, 1, sizeof(uint64_t), binFile);
     }
 
+    // gather the deduplicated buffers referenced by any chunk, to write out after the frame
+    // capture. Hold a reference on each since temporary chunks are deleted as they're written
+    vector<SerialisedBlob *> blobs;
+
+    {
+      set<uint64_t> blobHashes;
+
+      for(size_t i = 0; i < m_Chunks.size(); i++)
+      {
+        const vector<SerialisedBlob *> &chunkBlobs = m_Chunks[i]->GetBlobs();
+
+        for(size_t b = 0; b < chunkBlobs.size(); b++)
+        {
+          if(blobHashes.insert(chunkBlobs[b]->hash).second)
+          {
+            AddBufferBlobRef(chunkBlobs[b]);
+            blobs.push_back(chunkBlobs[b]);
+          }
+        }
+      }
+    }
+
     CompressedFileIO fwriter(binFile);
 
     // track offset so we can add padding. The padding is relative
@@ -1471,6 +1681,59 @@ void Serialiser::FlushToDisk()
              fwriter.GetCompressedSize());
     }
 
+    // write deduplicated buffers section
+    if(!blobs.empty())
+    {
+      const char sectionName[] = "renderdoc/internal/blobs";
+
+      BinarySectionHeader section = {0};
+      section.isASCII = 0;                                // redundant but explicit
+      section.sectionNameLength = sizeof(sectionName);    // includes null terminator
+      section.sectionType = eSectionType_BufferBlobs;
+      section.sectionFlags = eSectionFlag_LZ4Compressed;
+      section.sectionLength = 0;    // fixed up below, as with the frame capture
+
+      compressedSizeOffset = FileIO::ftell64(binFile) + offsetof(BinarySectionHeader, sectionLength);
+
+      FileIO::fwrite(&section, 1, offsetof(BinarySectionHeader, name), binFile);
+      FileIO::fwrite(sectionName, 1, sizeof(sectionName), binFile);
+
+      uint64_t len = 0;
+      uncompressedSizeOffset = FileIO::ftell64(binFile);
+      FileIO::fwrite(&len, 1, sizeof(uint64_t), binFile);
+
+      CompressedFileIO blobwriter(binFile);
+
+      uint32_t numBlobs = (uint32_t)blobs.size();
+      blobwriter.Write(&numBlobs, sizeof(numBlobs));
+
+      for(size_t i = 0; i < blobs.size(); i++)
+      {
+        blobwriter.Write(&blobs[i]->hash, sizeof(uint64_t));
+        blobwriter.Write(&blobs[i]->length, sizeof(uint32_t));
+        blobwriter.Write(blobs[i]->data, blobs[i]->length);
+
+        ReleaseBufferBlob(blobs[i]);
+      }
+
+      blobwriter.Flush();
+
+      uint64_t curoffs = FileIO::ftell64(binFile);
+
+      uint32_t compsize = blobwriter.GetCompressedSize();
+      FileIO::fseek64(binFile, compressedSizeOffset, SEEK_SET);
+      FileIO::fwrite(&compsize, 1, sizeof(compsize), binFile);
+
+      uint64_t uncompsize = blobwriter.GetUncompressedSize();
+      FileIO::fseek64(binFile, uncompressedSizeOffset, SEEK_SET);
+      FileIO::fwrite(&uncompsize, 1, sizeof(uncompsize), binFile);
+
+      FileIO::fseek64(binFile, curoffs, SEEK_SET);
+
+      RDCLOG("Wrote %u deduplicated buffers, compressed from %u to %u", numBlobs,
+             blobwriter.GetUncompressedSize(), blobwriter.GetCompressedSize());
+    }
+
     char *symbolDB = NULL;
     size_t symbolDBSize = 0;
 
@@ -1867,11 +2130,119 @@ void Serialiser::AlignNextBuffer(const size_t alignment)
   }
 }
 
+void Serialiser::ReleasePendingBlobs()
+{
+  for(size_t i = 0; i < m_PendingBlobs.size(); i++)
+    ReleaseBufferBlob(m_PendingBlobs[i]);
+
+  m_PendingBlobs.clear();
+  m_LastBufferBlob = NULL;
+}
+
+void Serialiser::LoadBufferBlobs()
+{
+  m_BlobsLoaded = true;
+
+  Section *s = m_KnownSections[eSectionType_BufferBlobs];
+
+  if(s == NULL)
+    return;
+
+  if(s->data.empty() && s->storedLength > 0 && m_ReadFileHandle)
+  {
+    // the frame capture section is read sequentially from the same handle, so put the file
+    // position back where it was once the blobs are in memory
+    uint64_t prevOffset = FileIO::ftell64(m_ReadFileHandle);
+
+    s->data.resize((size_t)s->storedLength);
+    FileIO::fseek64(m_ReadFileHandle, s->fileoffset, SEEK_SET);
+    FileIO::fread(&s->data[0], 1, (size_t)s->storedLength, m_ReadFileHandle);
+
+    FileIO::fseek64(m_ReadFileHandle, prevOffset, SEEK_SET);
+  }
+
+  if(s->flags & eSectionFlag_LZ4Compressed)
+  {
+    vector<byte> uncompressed((size_t)s->size);
+    CompressedFileIO::Decompress(&uncompressed[0], &s->data[0], s->data.size());
+    s->data.swap(uncompressed);
+  }
+
+  const byte *start = s->data.empty() ? NULL : &s->data[0];
+  const byte *end = start + s->data.size();
+  const byte *cur = start;
+
+  uint32_t numBlobs = 0;
+
+  if(cur + sizeof(numBlobs) > end)
+  {
+    RDCERR("Truncated deduplicated buffers section");
+    return;
+  }
+
+  memcpy(&numBlobs, cur, sizeof(numBlobs));
+  cur += sizeof(numBlobs);
+
+  for(uint32_t i = 0; i < numBlobs; i++)
+  {
+    uint64_t hash = 0;
+    uint32_t length = 0;
+
+    if(cur + sizeof(hash) + sizeof(length) > end)
+    {
+      RDCERR("Truncated deduplicated buffers section at blob %u of %u", i, numBlobs);
+      return;
+    }
+
+    memcpy(&hash, cur, sizeof(hash));
+    cur += sizeof(hash);
+    memcpy(&length, cur, sizeof(length));
+    cur += sizeof(length);
+
+    if(cur + length > end)
+    {
+      RDCERR("Truncated deduplicated buffers section at blob %u of %u", i, numBlobs);
+      return;
+    }
+
+    m_BlobIndex[hash] = std::make_pair(uint64_t(cur - start), length);
+    cur += length;
+  }
+}
+
+const byte *Serialiser::FindBufferBlob(uint64_t hash, uint32_t length)
+{
+  if(!m_BlobsLoaded)
+    LoadBufferBlobs();
+
+  auto it = m_BlobIndex.find(hash);
+
+  if(it == m_BlobIndex.end() || it->second.second != length)
+    return NULL;
+
+  return &m_KnownSections[eSectionType_BufferBlobs]->data[(size_t)it->second.first];
+}
+
 void Serialiser::SerialiseBuffer(const char *name, byte *&buf, size_t &len)
 {
   uint32_t bufLen = (uint32_t)len;
 
-  if(m_Mode >= WRITING)
+  SerialisedBlob *blob = NULL;
+
+  if(m_Mode >= WRITING && m_DedupBuffers && bufLen >= BufferDedupThreshold)
+    blob = AcquireBufferBlob(buf, bufLen);
+
+  if(blob)
+  {
+    uint32_t marker = BufferBlobReference;
+    WriteFrom(marker);
+    WriteFrom(bufLen);
+    WriteFrom(blob->hash);
+
+    m_PendingBlobs.push_back(blob);
+    m_LastBufferBlob = blob;
+  }
+  else if(m_Mode >= WRITING)
   {
     WriteFrom(bufLen);
 
@@ -1887,6 +2258,9 @@ void Serialiser::SerialiseBuffer(const char *name, byte *&buf, size_t &len)
 
     RDCASSERT((GetOffset() % BufferAlignment) == 0);
 
+    m_LastBufferBlob = NULL;
+    m_LastBufferOffset = GetOffset();
+
     WriteBytes(buf, bufLen);
 
     m_AlignedData = true;
@@ -1895,20 +2269,47 @@ void Serialiser::SerialiseBuffer(const char *name, byte *&buf, size_t &len)
   {
     ReadInto(bufLen);
 
-    // ensure byte alignment
-    uint64_t offs = GetOffset();
+    if(bufLen == BufferBlobReference && m_SerVer >= 0x00000033)
+    {
+      uint64_t hash = 0;
+      ReadInto(bufLen);
+      ReadInto(hash);
 
-    // serialise version 0x00000031 had only 16-byte alignment
-    uint64_t alignedoffs = AlignUp(offs, m_SerVer == 0x00000031 ? 16 : BufferAlignment);
+      if(buf == NULL)
+        buf = new byte[bufLen];
 
-    if(offs != alignedoffs)
-    {
-      ReadBytes((size_t)(alignedoffs - offs));
+      const byte *blobData = FindBufferBlob(hash, bufLen);
+
+      if(blobData)
+      {
+        memcpy(buf, blobData, bufLen);
+      }
+      else
+      {
+        RDCERR("Missing deduplicated buffer %llx of %u bytes", hash, bufLen);
+        memset(buf, 0, bufLen);
+
+        m_ErrorCode = eSerError_Corrupt;
+        m_HasError = true;
+      }
     }
+    else
+    {
+      // ensure byte alignment
+      uint64_t offs = GetOffset();
+
+      // serialise version 0x00000031 had only 16-byte alignment
+      uint64_t alignedoffs = AlignUp(offs, m_SerVer == 0x00000031 ? 16 : BufferAlignment);
+
+      if(offs != alignedoffs)
+      {
+        ReadBytes((size_t)(alignedoffs - offs));
+      }
 
-    if(buf == NULL)
-      buf = new byte[bufLen];
-    memcpy(buf, ReadBytes(bufLen), bufLen);
+      if(buf == NULL)
+        buf = new byte[bufLen];
+      memcpy(buf, ReadBytes(bufLen), bufLen);
+    }
   }
 
   len = (size_t)bufLen;
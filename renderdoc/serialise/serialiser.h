@@ -28,6 +28,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <list>
+#include <map>
 #include <set>
 #include <string>
 #include <utility>
@@ -89,6 +90,16 @@ class Serialiser;
 class ScopedContext;
 struct CompressedFileIO;
 
+// a buffer that's been deduplicated by contents, shared between all the chunks that serialised
+// identical data. See Serialiser::SetDeduplicateBuffers
+struct SerialisedBlob
+{
+  uint64_t hash;
+  uint32_t length;
+  byte *data;
+  int32_t refcount;
+};
+
 // holds the memory, length and type for a given chunk, so that it can be
 // passed around and moved between owners before being serialised out
 class Chunk
@@ -102,6 +113,7 @@ public:
   uint32_t GetChunkType() { return m_ChunkType; }
   bool IsAligned() { return m_AlignedData; }
   bool IsTemporary() { return m_Temporary; }
+  const std::vector<SerialisedBlob *> &GetBlobs() { return m_Blobs; }
 #if ENABLED(RDOC_DEVEL)
   static uint64_t NumLiveChunks() { return m_LiveChunks; }
   static uint64_t TotalMem() { return m_TotalMem; }
@@ -132,6 +144,9 @@ private:
   byte *m_Data;
   string m_DebugStr;
 
+  // deduplicated buffers referenced from m_Data, which we hold a reference on
+  std::vector<SerialisedBlob *> m_Blobs;
+
 #if ENABLED(RDOC_DEVEL)
   static int64_t m_LiveChunks, m_MaxChunks, m_TotalMem;
 #endif
@@ -186,13 +201,14 @@ public:
     eSectionType_MachineID,          // renderdoc/internal/machineid
     eSectionType_FrameBookmarks,     // renderdoc/ui/bookmarks
     eSectionType_Notes,              // renderdoc/ui/notes
+    eSectionType_BufferBlobs,        // renderdoc/internal/blobs
     eSectionType_Num,
   };
 
   // version number of overall file format or chunk organisation. If the contents/meaning/order of
   // chunks have changed this does not need to be bumped, there are version numbers within each
   // API that interprets the stream that can be bumped.
-  static const uint64_t SERIALISE_VERSION = 0x00000032;
+  static const uint64_t SERIALISE_VERSION = 0x00000033;
   static const uint32_t MAGIC_HEADER;
 
   //////////////////////////////////////////
@@ -251,6 +267,7 @@ public:
 
   void Rewind()
   {
+    ReleasePendingBlobs();
     m_DebugText = "";
     m_Indent = 0;
     m_AlignedData = false;
@@ -558,6 +575,18 @@ public:
   void SerialiseBuffer(const char *name, byte *&buf, size_t &len);
   void AlignNextBuffer(const size_t alignment);
 
+  // when writing, store large buffers passed to SerialiseBuffer only once per unique contents.
+  // The chunk references the data by hash and the data itself is written to its own section
+  // when the capture is flushed to disk. Chunks written with this enabled must not have their
+  // buffer data modified in-place after the fact.
+  void SetDeduplicateBuffers(bool dedup) { m_DedupBuffers = dedup; }
+  // returns the data written by the last SerialiseBuffer call, which might not be in the stream
+  // itself if it was deduplicated. Only valid until the next write.
+  const byte *GetLastBufferData() const
+  {
+    return m_LastBufferBlob ? m_LastBufferBlob->data : m_Buffer + m_LastBufferOffset;
+  }
+
   // NOT recommended interface. Useful for specific situations if e.g. you have
   // a buffer of data that is not arbitrary in size and can be determined by a 'type' or
   // similar elsewhere in the stream, so you want to skip the type-safety of the above
@@ -614,6 +643,13 @@ private:
   // no copies
   Serialiser(const Serialiser &other);
 
+  // Chunk takes ownership of the blobs referenced by its contents
+  friend class Chunk;
+
+  void ReleasePendingBlobs();
+  void LoadBufferBlobs();
+  const byte *FindBufferBlob(uint64_t hash, uint32_t length);
+
   static void CreateResolver(void *ths);
 
   // clean out for before constructor and after destructor (and other times probably)
@@ -631,6 +667,13 @@ private:
 
   static const uint64_t BufferAlignment;
 
+  // written in place of a buffer's length when the buffer has been deduplicated, followed by the
+  // real length and the content hash to look up in the blob section
+  static const uint32_t BufferBlobReference = 0xffffffff;
+
+  // buffers smaller than this aren't worth hashing and looking up
+  static const size_t BufferDedupThreshold = 1024;
+
   //////////////////////////////////////////
 
   uint64_t m_SerVer;
@@ -660,12 +703,22 @@ private:
   bool m_AlignedData;
   vector<uint64_t> m_ChunkFixups;
 
+  // writing deduplicated buffers:
+  bool m_DedupBuffers;
+  vector<SerialisedBlob *> m_PendingBlobs;
+  SerialisedBlob *m_LastBufferBlob;
+  uint64_t m_LastBufferOffset;
+
   // reading from file:
 
   struct Section
   {
     Section()
-        : type(eSectionType_Unknown), flags(eSectionFlag_None), fileoffset(0), compressedReader(NULL)
+        : type(eSectionType_Unknown),
+          flags(eSectionFlag_None),
+          fileoffset(0),
+          storedLength(0),
+          compressedReader(NULL)
     {
     }
     string name;
@@ -674,6 +727,7 @@ private:
 
     uint64_t fileoffset;
     uint64_t size;
+    uint64_t storedLength;    // bytes on disk, may differ from size if compressed
     vector<byte> data;    // some sections can be loaded entirely into memory
     CompressedFileIO *compressedReader;
   };
@@ -696,6 +750,11 @@ private:
   // the file pointer to read from
   FILE *m_ReadFileHandle;
 
+  // hash -> offset and length of each deduplicated buffer in the blob section's data
+  std::map<uint64_t, std::pair<uint64_t, uint32_t> > m_BlobIndex;
+  // the blob section is only read from disk the first time a deduplicated buffer is looked up
+  bool m_BlobsLoaded;
+
   // writing to file
   vector<Chunk *> m_Chunks;
 
@@ -26,7 +26,11 @@
 #include "renderdoccmd.h"
 #include <app/renderdoc_app.h>
 #include <replay/version.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <string>
+#include <thread>
 
 using std::string;
 using std::wstring;
@@ -280,7 +284,7 @@ struct ThumbCommand : public Command
     ICaptureFile *file = RENDERDOC_OpenCaptureFile(filename.c_str());
     if(file->OpenStatus() == ReplayStatus::Succeeded)
     {
-      buf = file->GetThumbnail(FileType::JPG, 0);
+      buf = file->GetThumbnail(type, parser.get<uint32_t>("max-size"));
     }
     else
     {
@@ -313,6 +317,156 @@ struct ThumbCommand : public Command
   }
 };
 
+// expands any directories in args to the .rdc files directly inside them, sorted so that the
+// order doesn't depend on the filesystem. Other arguments are passed through as captures.
+static std::vector<std::string> ExpandCaptureArguments(const std::vector<std::string> &args)
+{
+  std::vector<std::string> captures;
+
+  for(const std::string &path : args)
+  {
+    std::vector<std::string> files;
+    if(ListDirectory(path, files))
+    {
+      std::sort(files.begin(), files.end());
+
+      for(const std::string &f : files)
+        if(f.size() > 4 && f.compare(f.size() - 4, 4, ".rdc") == 0)
+          captures.push_back(f);
+    }
+    else
+    {
+      captures.push_back(path);
+    }
+  }
+
+  return captures;
+}
+
+struct ThumbsCommand : public Command
+{
+  ThumbsCommand(const GlobalEnvironment &env) : Command(env) {}
+  virtual void AddOptions(cmdline::parser &parser)
+  {
+    parser.set_footer("<capture.rdc | directory> ...");
+    parser.add<string>("out-dir", 'o',
+                       "If set, copy each thumbnail into this directory named after its capture. "
+                       "Otherwise the cached thumbnail paths are printed.",
+                       false, "");
+    parser.add<string>("format", 'f', "The format of the thumbnails.", false, "jpg",
+                       cmdline::oneof<string>("jpg", "png", "bmp", "tga"));
+    parser.add<uint32_t>(
+        "max-size", 's',
+        "The maximum dimension of the thumbnails. Default is 0, which is unlimited.", false, 0);
+    parser.add<uint32_t>("jobs", 'j',
+                         "The number of captures to process concurrently. Default is 0, which "
+                         "uses one per CPU core.",
+                         false, 0);
+  }
+  virtual const char *Description()
+  {
+    return "Generates cached thumbnails for many captures in parallel.";
+  }
+  virtual bool IsInternalOnly() { return false; }
+  virtual bool IsCaptureCommand() { return false; }
+  virtual int Execute(cmdline::parser &parser, const CaptureOptions &)
+  {
+    std::vector<std::string> captures = ExpandCaptureArguments(parser.rest());
+
+    if(captures.empty())
+    {
+      std::cerr << "Error: thumbs command requires at least one capture or directory." << std::endl
+                << std::endl
+                << parser.usage();
+      return 1;
+    }
+
+    std::string format = parser.get<string>("format");
+
+    FileType type = FileType::JPG;
+
+    if(format == "png")
+      type = FileType::PNG;
+    else if(format == "tga")
+      type = FileType::TGA;
+    else if(format == "bmp")
+      type = FileType::BMP;
+
+    rdctype::array<rdctype::str> thumbnails;
+
+    RENDERDOC_GetCachedThumbnails(convertArgs(captures), type, parser.get<uint32_t>("max-size"),
+                                  parser.get<uint32_t>("jobs"), &thumbnails);
+
+    std::string outDir = parser.get<string>("out-dir");
+
+    size_t succeeded = 0;
+
+    for(size_t i = 0; i < captures.size(); i++)
+    {
+      std::string thumb = thumbnails.elems[i].c_str();
+
+      if(thumb.empty())
+      {
+        std::cerr << "Couldn't fetch the thumbnail in '" << captures[i] << "'" << std::endl;
+        continue;
+      }
+
+      if(outDir.empty())
+      {
+        std::cout << captures[i] << ": " << thumb << std::endl;
+        succeeded++;
+        continue;
+      }
+
+      std::string name = captures[i];
+      size_t sep = name.find_last_of("/\\");
+      if(sep != std::string::npos)
+        name.erase(0, sep + 1);
+      size_t dot = name.find_last_of('.');
+      if(dot != std::string::npos)
+        name.erase(dot);
+      name = outDir + "/" + name + "." + format;
+
+      FILE *src = fopen(thumb.c_str(), "rb");
+      FILE *dst = fopen(name.c_str(), "wb");
+
+      bool copied = false;
+
+      if(src && dst)
+      {
+        copied = true;
+
+        char buf[4096];
+        size_t read = 0;
+        while(copied && (read = fread(buf, 1, sizeof(buf), src)) > 0)
+          copied = fwrite(buf, 1, read, dst) == read;
+
+        copied = copied && !ferror(src);
+      }
+
+      if(src)
+        fclose(src);
+      if(dst && fclose(dst) != 0)
+        copied = false;
+
+      if(copied)
+      {
+        succeeded++;
+      }
+      else
+      {
+        std::cerr << "Couldn't copy thumbnail for '" << captures[i] << "' to '" << name << "'"
+                  << std::endl;
+      }
+    }
+
+    std::cout << "Fetched " << succeeded << " of " << captures.size() << " thumbnails."
+              << std::endl;
+
+    return succeeded == captures.size() ? 0 : 1;
+  }
+};
+
 struct CaptureCommand : public Command
 {
   CaptureCommand(const GlobalEnvironment &env) : Command(env) {}
@@ -707,6 +861,568 @@ struct CapAltBitCommand : public Command
   }
 };
 
+static std::string JSONEscape(const std::string &str)
+{
+  std::string ret = "\"";
+
+  for(size_t i = 0; i < str.size(); i++)
+  {
+    char c = str[i];
+    switch(c)
+    {
+      case '"': ret += "\\\""; break;
+      case '\\': ret += "\\\\"; break;
+      case '\n': ret += "\\n"; break;
+      case '\r': ret += "\\r"; break;
+      case '\t': ret += "\\t"; break;
+      default:
+        if((unsigned char)c < 0x20)
+        {
+          char buf[8];
+          snprintf(buf, sizeof(buf), "\\u%04x", c);
+          ret += buf;
+        }
+        else
+        {
+          ret += c;
+        }
+        break;
+    }
+  }
+
+  return ret + "\"";
+}
+
+static std::string JSONNumber(uint64_t val)
+{
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%llu", (unsigned long long)val);
+  return buf;
+}
+
+static std::string JSONNumber(double val)
+{
+  // JSON has no representation for NaN or infinity
+  if(!std::isfinite(val))
+    return "null";
+
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.9g", val);
+  return buf;
+}
+
+struct BatchStats
+{
+  uint64_t events = 0;
+  uint64_t drawcalls = 0;
+  uint64_t dispatches = 0;
+  uint64_t clears = 0;
+  uint64_t copies = 0;
+  uint64_t passes = 0;
+  uint64_t markers = 0;
+};
+
+static void AccumulateBatchStats(const rdctype::array<DrawcallDescription> &draws, BatchStats &stats)
+{
+  for(int32_t i = 0; i < draws.count; i++)
+  {
+    const DrawcallDescription &d = draws[i];
+
+    stats.events += d.events.count;
+
+    if(d.flags & DrawFlags::Drawcall)
+      stats.drawcalls++;
+    if(d.flags & DrawFlags::Dispatch)
+      stats.dispatches++;
+    if(d.flags & DrawFlags::Clear)
+      stats.clears++;
+    if(d.flags & (DrawFlags::Copy | DrawFlags::Resolve))
+      stats.copies++;
+    if(d.flags & DrawFlags::BeginPass)
+      stats.passes++;
+    if(d.flags & (DrawFlags::PushMarker | DrawFlags::SetMarker))
+      stats.markers++;
+
+    AccumulateBatchStats(d.children, stats);
+  }
+}
+
+static std::string CounterValueToJSON(const CounterDescription &desc, const CounterValue &val)
+{
+  if(desc.resultType == CompType::Float)
+    return desc.resultByteWidth == 8 ? JSONNumber(val.d) : JSONNumber((double)val.f);
+  if(desc.resultType == CompType::Double)
+    return JSONNumber(val.d);
+
+  return desc.resultByteWidth == 8 ? JSONNumber(val.u64) : JSONNumber((uint64_t)val.u32);
+}
+
+// runs the fixed per-capture pipeline and returns a JSON object describing the results. This is
+// only ever run in a child process so that a crash in one capture can't take down the batch.
+// succeeded is set if the capture was opened and replayed.
+static std::string AnalyseBatchCapture(const std::string &filename, const std::string &exportPath,
+                                       bool counters, bool &succeeded)
+{
+  succeeded = false;
+
+  std::string json = "{\"file\": " + JSONEscape(filename);
+
+  ICaptureFile *file = RENDERDOC_OpenCaptureFile(filename.c_str());
+
+  if(file->OpenStatus() != ReplayStatus::Succeeded)
+  {
+    file->Shutdown();
+    return json + ", \"status\": \"open-failed\"}";
+  }
+
+  json += ", \"driver\": " + JSONEscape(file->DriverName());
+
+  IReplayController *renderer = NULL;
+  ReplayStatus status = ReplayStatus::InternalError;
+  std::tie(status, renderer) = file->OpenCapture(NULL);
+
+  file->Shutdown();
+
+  if(status != ReplayStatus::Succeeded)
+    return json + ", \"status\": \"replay-failed\"}";
+
+  json += ", \"status\": \"ok\"";
+  succeeded = true;
+
+  // stats
+  {
+    BatchStats stats;
+    AccumulateBatchStats(renderer->GetDrawcalls(), stats);
+
+    rdctype::array<TextureDescription> texs = renderer->GetTextures();
+    rdctype::array<BufferDescription> bufs = renderer->GetBuffers();
+
+    uint64_t texBytes = 0, bufBytes = 0;
+    for(int32_t i = 0; i < texs.count; i++)
+      texBytes += texs[i].byteSize;
+    for(int32_t i = 0; i < bufs.count; i++)
+      bufBytes += bufs[i].length;
+
+    json += ", \"stats\": {";
+    json += "\"events\": " + JSONNumber(stats.events);
+    json += ", \"drawcalls\": " + JSONNumber(stats.drawcalls);
+    json += ", \"dispatches\": " + JSONNumber(stats.dispatches);
+    json += ", \"clears\": " + JSONNumber(stats.clears);
+    json += ", \"copies\": " + JSONNumber(stats.copies);
+    json += ", \"passes\": " + JSONNumber(stats.passes);
+    json += ", \"markers\": " + JSONNumber(stats.markers);
+    json += ", \"textures\": " + JSONNumber((uint64_t)texs.count);
+    json += ", \"textureBytes\": " + JSONNumber(texBytes);
+    json += ", \"buffers\": " + JSONNumber((uint64_t)bufs.count);
+    json += ", \"bufferBytes\": " + JSONNumber(bufBytes);
+    json += "}";
+  }
+
+  if(counters)
+  {
+    rdctype::array<GPUCounter> available = renderer->EnumerateCounters();
+
+    // sort so the output order doesn't depend on how the driver enumerates
+    std::vector<GPUCounter> sorted(available.elems, available.elems + available.count);
+    std::sort(sorted.begin(), sorted.end());
+
+    available = sorted;
+
+    rdctype::array<CounterResult> results = renderer->FetchCounters(available);
+
+    std::vector<CounterResult> sortedResults(results.elems, results.elems + results.count);
+    std::sort(sortedResults.begin(), sortedResults.end());
+
+    json += ", \"counters\": [";
+
+    for(size_t c = 0; c < sorted.size(); c++)
+    {
+      CounterDescription desc = renderer->DescribeCounter(sorted[c]);
+
+      if(c > 0)
+        json += ", ";
+
+      json += "{\"name\": " + JSONEscape(desc.name.c_str());
+      json += ", \"values\": [";
+
+      bool first = true;
+      for(size_t r = 0; r < sortedResults.size(); r++)
+      {
+        if(sortedResults[r].counterID != sorted[c])
+          continue;
+
+        if(!first)
+          json += ", ";
+        first = false;
+
+        json += "[" + JSONNumber((uint64_t)sortedResults[r].eventID) + ", " +
+                CounterValueToJSON(desc, sortedResults[r].value) + "]";
+      }
+
+      json += "]}";
+    }
+
+    json += "]";
+  }
+
+  if(!exportPath.empty())
+  {
+    // export the final presented image, the same one the replay command previews
+    ResourceId id;
+
+    rdctype::array<TextureDescription> texs = renderer->GetTextures();
+    for(int32_t i = 0; i < texs.count; i++)
+    {
+      if(texs[i].creationFlags & TextureCategory::SwapBuffer)
+      {
+        id = texs[i].ID;
+        break;
+      }
+    }
+
+    rdctype::array<DrawcallDescription> draws = renderer->GetDrawcalls();
+
+    if(draws.count > 0 && draws[draws.count - 1].flags & DrawFlags::Present &&
+       draws[draws.count - 1].copyDestination != ResourceId())
+      id = draws[draws.count - 1].copyDestination;
+
+    if(id != ResourceId())
+    {
+      renderer->SetFrameEvent(~0U, true);
+
+      TextureSave save;
+      memset(&save, 0, sizeof(save));
+
+      save.id = id;
+      save.destType = FileType::PNG;
+      save.mip = 0;
+      save.slice.sliceIndex = 0;
+      save.sample.sampleIndex = TextureSampleMapping::ResolveSamples;
+      save.channelExtract = -1;
+      save.comp.blackPoint = 0.0f;
+      save.comp.whitePoint = 1.0f;
+      save.alpha = AlphaMapping::Preserve;
+
+      if(renderer->SaveTexture(save, exportPath.c_str()))
+        json += ", \"export\": " + JSONEscape(exportPath);
+    }
+  }
+
+  renderer->Shutdown();
+
+  return json + "}";
+}
+
+struct BatchWorkerCommand : public Command
+{
+  BatchWorkerCommand(const GlobalEnvironment &env) : Command(env) {}
+  virtual void AddOptions(cmdline::parser &parser)
+  {
+    parser.add<string>("capture", 0, "");
+    parser.add<string>("out", 0, "");
+    parser.add<string>("export", 0, "", false, "");
+    parser.add("no-counters", 0, "");
+  }
+  virtual const char *Description() { return "Internal use only!"; }
+  virtual bool IsInternalOnly() { return true; }
+  virtual bool IsCaptureCommand() { return false; }
+  virtual int Execute(cmdline::parser &parser, const CaptureOptions &)
+  {
+    RENDERDOC_InitGlobalEnv(m_Env, convertArgs(parser.rest()));
+
+    bool succeeded = false;
+    std::string json =
+        AnalyseBatchCapture(parser.get<string>("capture"), parser.get<string>("export"),
+                            !parser.exist("no-counters"), succeeded);
+
+    FILE *f = fopen(parser.get<string>("out").c_str(), "wb");
+
+    if(!f)
+      return 1;
+
+    bool written = fwrite(json.c_str(), 1, json.size(), f) == json.size();
+    written &= fclose(f) == 0;
+
+    if(!written)
+      return 1;
+
+    // the part file describes the failure, the exit code tells the parent whether it was one
+    return succeeded ? 0 : 2;
+  }
+};
+
+struct BatchCommand : public Command
+{
+  BatchCommand(const GlobalEnvironment &env) : Command(env) {}
+  virtual void AddOptions(cmdline::parser &parser)
+  {
+    parser.set_footer("<capture.rdc | directory> ...");
+    parser.add<string>("out", 'o', "The filename to write the JSON report to.", true);
+    parser.add<uint32_t>("jobs", 'j',
+                         "The number of captures to process concurrently. Default is 0, which "
+                         "uses one per CPU core.",
+                         false, 0);
+    parser.add<string>("export-dir", 'e',
+                       "If set, save each capture's final output image as a PNG in this directory.",
+                       false, "");
+    parser.add("no-counters", 0, "Don't fetch per-event GPU counters.");
+  }
+  virtual const char *Description()
+  {
+    return "Analyses many captures in parallel and writes a combined report.";
+  }
+  virtual bool IsInternalOnly() { return false; }
+  virtual bool IsCaptureCommand() { return false; }
+  virtual int Execute(cmdline::parser &parser, const CaptureOptions &)
+  {
+    std::vector<std::string> captures = ExpandCaptureArguments(parser.rest());
+
+    if(captures.empty())
+    {
+      std::cerr << "Error: batch command requires at least one capture or directory." << std::endl
+                << std::endl
+                << parser.usage();
+      return 1;
+    }
+
+    std::string outfile = parser.get<string>("out");
+    std::string exportDir = parser.get<string>("export-dir");
+
+    uint32_t jobs = parser.get<uint32_t>("jobs");
+    if(jobs == 0)
+      jobs = std::max(1U, std::thread::hardware_concurrency());
+    jobs = std::min(jobs, (uint32_t)captures.size());
+
+    std::cout << "Analysing " << captures.size() << " captures with " << jobs << " workers."
+              << std::endl;
+
+    // each capture is processed by a separate child process which writes its results to a part
+    // file named by the capture's index. Scheduling only affects which worker picks up which
+    // capture, the report is assembled afterwards in input order.
+    std::vector<int> exitCodes(captures.size(), -1);
+    std::atomic<size_t> next(0);
+
+    auto partName = [&outfile](size_t idx) { return outfile + "." + std::to_string(idx) + ".part"; };
+
+    auto worker = [&]() {
+      for(size_t idx = next++; idx < captures.size(); idx = next++)
+      {
+        // a part file left behind by an earlier run that crashed must not be mistaken for output
+        // from this worker
+        remove(partName(idx).c_str());
+
+        std::vector<std::string> args = {"batchworker", "--capture", captures[idx], "--out",
+                                         partName(idx)};
+
+        if(!exportDir.empty())
+        {
+          args.push_back("--export");
+          args.push_back(exportDir + "/" + std::to_string(idx) + ".png");
+        }
+
+        if(parser.exist("no-counters"))
+          args.push_back("--no-counters");
+
+        uint64_t child = LaunchChildCommand(args);
+
+        exitCodes[idx] = child ? WaitForChildCommand(child) : -1;
+      }
+    };
+
+    std::vector<std::thread> threads;
+    for(uint32_t i = 0; i < jobs; i++)
+      threads.push_back(std::thread(worker));
+    for(std::thread &t : threads)
+      t.join();
+
+    std::string report = "{\"version\": " + JSONEscape(MAJOR_MINOR_VERSION_STRING) +
+                         ", \"captures\": [\n";
+
+    uint64_t succeeded = 0;
+
+    for(size_t idx = 0; idx < captures.size(); idx++)
+    {
+      std::string part;
+
+      FILE *f = fopen(partName(idx).c_str(), "rb");
+      if(f)
+      {
+        char buf[4096];
+        size_t read = 0;
+        while((read = fread(buf, 1, sizeof(buf), f)) > 0)
+          part.append(buf, read);
+        fclose(f);
+
+        remove(partName(idx).c_str());
+      }
+
+      // workers exit with 0 on success and 2 if the capture failed to analyse. Anything else means
+      // the part file wasn't completely written, if at all.
+      if(part.empty() || (exitCodes[idx] != 0 && exitCodes[idx] != 2))
+        part = "{\"file\": " + JSONEscape(captures[idx]) + ", \"status\": \"crashed\", " +
+               "\"exitCode\": " + std::to_string(exitCodes[idx]) + "}";
+      else if(exitCodes[idx] == 0)
+        succeeded++;
+
+      report += "  " + part + (idx + 1 < captures.size() ? ",\n" : "\n");
+    }
+
+    report += "], \"summary\": {\"total\": " + JSONNumber((uint64_t)captures.size()) +
+              ", \"succeeded\": " + JSONNumber(succeeded) + ", \"failed\": " +
+              JSONNumber((uint64_t)captures.size() - succeeded) + "}}\n";
+
+    FILE *f = fopen(outfile.c_str(), "wb");
+
+    if(!f)
+    {
+      std::cerr << "Couldn't open destination file '" << outfile << "'" << std::endl;
+      return 1;
+    }
+
+    fwrite(report.c_str(), 1, report.size(), f);
+    fclose(f);
+
+    std::cout << "Wrote report for " << captures.size() << " captures (" << succeeded
+              << " succeeded) to '" << outfile << "'." << std::endl;
+
+    return succeeded == captures.size() ? 0 : 1;
+  }
+};
+
+struct StatsCommand : public Command
+{
+  StatsCommand(const GlobalEnvironment &env) : Command(env) {}
+  virtual void AddOptions(cmdline::parser &parser)
+  {
+    parser.set_footer("<capture.rdc>");
+    parser.add("json", 0, "Print the statistics as JSON.");
+    parser.add<uint32_t>("max-drawcalls", 0,
+                         "Fail if the frame has more than this many drawcalls. 0 means no limit.",
+                         false, 0);
+    parser.add<uint32_t>("max-frame-mb", 0,
+                         "Fail if the frame data is larger than this many megabytes. 0 means no "
+                         "limit.",
+                         false, 0);
+  }
+  virtual const char *Description()
+  {
+    return "Prints statistics about a capture without replaying it.";
+  }
+  virtual bool IsInternalOnly() { return false; }
+  virtual bool IsCaptureCommand() { return false; }
+  virtual int Execute(cmdline::parser &parser, const CaptureOptions &)
+  {
+    std::vector<std::string> rest = parser.rest();
+    if(rest.empty())
+    {
+      std::cerr << "Error: stats command requires a capture filename." << std::endl
+                << std::endl
+                << parser.usage();
+      return 1;
+    }
+
+    string filename = rest[0];
+
+    rest.erase(rest.begin());
+
+    RENDERDOC_InitGlobalEnv(m_Env, convertArgs(rest));
+
+    ICaptureFile *file = RENDERDOC_OpenCaptureFile(filename.c_str());
+
+    ReplayStatus status = ReplayStatus::InternalError;
+    CaptureStatistics stats;
+    std::tie(status, stats) = file->GetStatistics();
+
+    file->Shutdown();
+
+    if(status != ReplayStatus::Succeeded)
+    {
+      std::cerr << "Couldn't read statistics from '" << filename << "'." << std::endl;
+      return 1;
+    }
+
+    if(parser.exist("json"))
+    {
+      std::string json = "{\"file\": " + JSONEscape(filename);
+      json += ", \"compressedFileSize\": " + JSONNumber(stats.compressedFileSize);
+      json += ", \"uncompressedFileSize\": " + JSONNumber(stats.uncompressedFileSize);
+      json += ", \"frameBytes\": " + JSONNumber(stats.frameBytes);
+      json += ", \"initialContentsBytes\": " + JSONNumber(stats.initialContentsBytes);
+      json += ", \"drawcalls\": " + JSONNumber((uint64_t)stats.drawcalls);
+      json += ", \"dispatches\": " + JSONNumber((uint64_t)stats.dispatches);
+      json += ", \"clears\": " + JSONNumber((uint64_t)stats.clears);
+      json += ", \"copies\": " + JSONNumber((uint64_t)stats.copies);
+      json += ", \"uploads\": " + JSONNumber((uint64_t)stats.uploads);
+      json += ", \"uploadBytes\": " + JSONNumber(stats.uploadBytes);
+
+      json += ", \"chunks\": [";
+      for(int32_t i = 0; i < stats.chunks.count; i++)
+      {
+        const ChunkStatistics &c = stats.chunks[i];
+        json += std::string(i > 0 ? ", " : "") + "{\"name\": " + JSONEscape(c.name.c_str()) +
+                ", \"count\": " + JSONNumber((uint64_t)c.count) + ", \"frameCount\": " +
+                JSONNumber((uint64_t)c.frameCount) + ", \"bytes\": " + JSONNumber(c.totalBytes) +
+                "}";
+      }
+      json += "]";
+
+      json += ", \"resources\": [";
+      for(int32_t i = 0; i < stats.resources.count; i++)
+      {
+        const ResourceTypeStatistics &r = stats.resources[i];
+        json += std::string(i > 0 ? ", " : "") + "{\"type\": " + JSONEscape(r.type.c_str()) +
+                ", \"count\": " + JSONNumber((uint64_t)r.count) + ", \"bytes\": " +
+                JSONNumber(r.bytes) + "}";
+      }
+      json += "]}";
+
+      std::cout << json << std::endl;
+    }
+    else
+    {
+      std::cout << "Capture '" << filename << "'" << std::endl;
+      std::cout << "  File size: " << stats.compressedFileSize << " bytes ("
+                << stats.uncompressedFileSize << " uncompressed)" << std::endl;
+      std::cout << "  Frame data: " << stats.frameBytes << " bytes" << std::endl;
+      std::cout << "  Initial contents: " << stats.initialContentsBytes << " bytes" << std::endl;
+      std::cout << "  Drawcalls: " << stats.drawcalls << ", dispatches: " << stats.dispatches
+                << ", clears: " << stats.clears << ", copies: " << stats.copies << std::endl;
+      std::cout << "  Uploads: " << stats.uploads << " (" << stats.uploadBytes << " bytes)"
+                << std::endl;
+
+      std::cout << std::endl << "Resources:" << std::endl;
+      for(int32_t i = 0; i < stats.resources.count; i++)
+        std::cout << "  " << stats.resources[i].type.c_str() << ": " << stats.resources[i].count
+                  << " (" << stats.resources[i].bytes << " bytes)" << std::endl;
+
+      std::cout << std::endl << "Chunks:" << std::endl;
+      for(int32_t i = 0; i < stats.chunks.count; i++)
+        std::cout << "  " << stats.chunks[i].name.c_str() << ": " << stats.chunks[i].count << " ("
+                  << stats.chunks[i].frameCount << " in frame, " << stats.chunks[i].totalBytes
+                  << " bytes)" << std::endl;
+    }
+
+    uint32_t maxDraws = parser.get<uint32_t>("max-drawcalls");
+    uint64_t maxBytes = uint64_t(parser.get<uint32_t>("max-frame-mb")) * 1024 * 1024;
+
+    if(maxDraws > 0 && stats.drawcalls > maxDraws)
+    {
+      std::cerr << "Frame has " << stats.drawcalls << " drawcalls, more than the limit of "
+                << maxDraws << "." << std::endl;
+      return 2;
+    }
+
+    if(maxBytes > 0 && stats.frameBytes > maxBytes)
+    {
+      std::cerr << "Frame data is " << stats.frameBytes << " bytes, more than the limit of "
+                << maxBytes << "." << std::endl;
+      return 2;
+    }
+
+    return 0;
+  }
+};
+
 int renderdoccmd(const GlobalEnvironment &env, std::vector<std::string> &argv)
 {
   try
@@ -733,11 +1449,15 @@ int renderdoccmd(const GlobalEnvironment &env, std::vector<std::string> &argv)
 
     // add platform agnostic commands
     add_command("thumb", new ThumbCommand(env));
+    add_command("thumbs", new ThumbsCommand(env));
     add_command("capture", new CaptureCommand(env));
     add_command("inject", new InjectCommand(env));
     add_command("remoteserver", new RemoteServerCommand(env));
     add_command("replay", new ReplayCommand(env));
     add_command("capaltbit", new CapAltBitCommand(env));
+    add_command("batch", new BatchCommand(env));
+    add_command("batchworker", new BatchWorkerCommand(env));
+    add_command("stats", new StatsCommand(env));
 
     if(argv.size() <= 1)
     {
@@ -58,3 +58,11 @@ void readCapOpts(const std::string &str, CaptureOptions *opts);
 void DisplayRendererPreview(IReplayController *renderer, TextureDisplay &displayCfg, uint32_t width,
                             uint32_t height);
 void Daemonise();
+
+// used by the batch and thumbs commands. ListDirectory returns false if path isn't a directory,
+// otherwise fills files with the full paths of the regular files inside it. LaunchChildCommand
+// re-launches this executable with the given arguments and returns an opaque handle (or 0 on
+// failure), which is passed to WaitForChildCommand to block until it exits and fetch its exit code.
+bool ListDirectory(const std::string &path, std::vector<std::string> &files);
+uint64_t LaunchChildCommand(const std::vector<std::string> &args);
+int WaitForChildCommand(uint64_t handle);
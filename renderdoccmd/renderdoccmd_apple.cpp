@@ -29,11 +29,28 @@
 #include <string>
 
 using std::string;
+using std::vector;
 
 void Daemonise()
 {
 }
 
+bool ListDirectory(const string &path, vector<string> &files)
+{
+  return false;
+}
+
+uint64_t LaunchChildCommand(const vector<string> &args)
+{
+  // child processes aren't supported here, so batch analysis isn't available
+  return 0;
+}
+
+int WaitForChildCommand(uint64_t handle)
+{
+  return -1;
+}
+
 void DisplayRendererPreview(IReplayController *renderer, TextureDisplay &displayCfg, uint32_t width,
                             uint32_t height)
 {
@@ -24,15 +24,19 @@
  ******************************************************************************/
 
 #include "renderdoccmd.h"
+#include <dirent.h>
 #include <dlfcn.h>
+#include <errno.h>
 #include <iconv.h>
 #include <limits.h>
 #include <locale.h>
 #include <signal.h>
+#include <spawn.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/wait.h>
 #include <unistd.h>
 #include <string>
 
@@ -51,6 +55,63 @@ void Daemonise()
   daemon(1, 0);
 }
 
+bool ListDirectory(const string &path, vector<string> &files)
+{
+  DIR *d = opendir(path.c_str());
+
+  if(d == NULL)
+    return false;
+
+  for(dirent *ent = readdir(d); ent; ent = readdir(d))
+  {
+    string fullpath = path + "/" + ent->d_name;
+
+    struct stat st;
+    if(stat(fullpath.c_str(), &st) == 0 && S_ISREG(st.st_mode))
+      files.push_back(fullpath);
+  }
+
+  closedir(d);
+
+  return true;
+}
+
+uint64_t LaunchChildCommand(const vector<string> &args)
+{
+  char exe[PATH_MAX + 1] = {0};
+  if(readlink("/proc/self/exe", exe, PATH_MAX) <= 0)
+    return 0;
+
+  vector<char *> argv;
+  argv.push_back(exe);
+  for(size_t i = 0; i < args.size(); i++)
+    argv.push_back((char *)args[i].c_str());
+  argv.push_back(NULL);
+
+  pid_t pid = 0;
+  if(posix_spawn(&pid, exe, NULL, NULL, argv.data(), environ) != 0)
+    return 0;
+
+  return (uint64_t)pid;
+}
+
+int WaitForChildCommand(uint64_t handle)
+{
+  int status = 0;
+
+  while(waitpid((pid_t)handle, &status, 0) < 0)
+  {
+    if(errno != EINTR)
+      return -1;
+  }
+
+  if(WIFEXITED(status))
+    return WEXITSTATUS(status);
+
+  // killed by a signal, most likely a crash
+  return -1;
+}
+
 struct VulkanRegisterCommand : public Command
 {
   VulkanRegisterCommand(const GlobalEnvironment &env) : Command(env) {}
@@ -379,7 +440,9 @@ int main(int argc, char *argv[])
   display = env.xlibDisplay = XOpenDisplay(NULL);
 
 #if defined(RENDERDOC_SUPPORT_VULKAN)
-  VerifyVulkanLayer(env, argc, argv);
+  // batch workers are launched by the batch command, which has already warned if needed
+  if(argc < 2 || strcmp(argv[1], "batchworker") != 0)
+    VerifyVulkanLayer(env, argc, argv);
 #endif
 
   // add compiled-in support to version line
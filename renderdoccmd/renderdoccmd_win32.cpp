@@ -232,6 +232,119 @@ void Daemonise()
   // nothing really to do, windows version of renderdoccmd is already 'detached'
 }
 
+static wstring ToWide(const string &str)
+{
+  wstring ret;
+  ret.resize(str.size() + 1);
+  int len = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, &ret[0], int(ret.size()));
+  ret.resize(len > 0 ? len - 1 : 0);
+  return ret;
+}
+
+static string ToUTF8(const wstring &str)
+{
+  string ret;
+  ret.resize(str.size() * 4 + 1);
+  int len = WideCharToMultiByte(CP_UTF8, 0, str.c_str(), -1, &ret[0], int(ret.size()), NULL, NULL);
+  ret.resize(len > 0 ? len - 1 : 0);
+  return ret;
+}
+
+bool ListDirectory(const string &path, vector<string> &files)
+{
+  wstring wpath = ToWide(path);
+
+  DWORD attribs = GetFileAttributesW(wpath.c_str());
+  if(attribs == INVALID_FILE_ATTRIBUTES || (attribs & FILE_ATTRIBUTE_DIRECTORY) == 0)
+    return false;
+
+  WIN32_FIND_DATAW findData = {};
+  HANDLE find = FindFirstFileW((wpath + L"\\*").c_str(), &findData);
+
+  if(find == INVALID_HANDLE_VALUE)
+    return true;
+
+  do
+  {
+    if(findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+      continue;
+
+    files.push_back(path + "\\" + ToUTF8(findData.cFileName));
+  } while(FindNextFileW(find, &findData));
+
+  FindClose(find);
+
+  return true;
+}
+
+uint64_t LaunchChildCommand(const vector<string> &args)
+{
+  wchar_t exe[MAX_PATH + 1] = {0};
+  GetModuleFileNameW(NULL, exe, MAX_PATH);
+
+  wstring cmdline = L"\"";
+  cmdline += exe;
+  cmdline += L"\"";
+
+  // quote each argument so that CommandLineToArgvW on the other side gives it back verbatim
+  for(size_t i = 0; i < args.size(); i++)
+  {
+    wstring arg = ToWide(args[i]);
+
+    cmdline += L" \"";
+
+    size_t backslashes = 0;
+    for(size_t c = 0; c < arg.size(); c++)
+    {
+      if(arg[c] == L'\\')
+      {
+        backslashes++;
+        continue;
+      }
+
+      // backslashes are only special when they precede a quote
+      if(arg[c] == L'"')
+        cmdline.append(backslashes * 2 + 1, L'\\');
+      else
+        cmdline.append(backslashes, L'\\');
+
+      backslashes = 0;
+      cmdline += arg[c];
+    }
+
+    cmdline.append(backslashes * 2, L'\\');
+    cmdline += L"\"";
+  }
+
+  PROCESS_INFORMATION pi = {};
+  STARTUPINFOW si = {};
+  si.cb = sizeof(si);
+
+  BOOL success = CreateProcessW(exe, &cmdline[0], NULL, NULL, FALSE, CREATE_NO_WINDOW, NULL, NULL,
+                                &si, &pi);
+
+  if(!success)
+    return 0;
+
+  CloseHandle(pi.hThread);
+
+  return (uint64_t)pi.hProcess;
+}
+
+int WaitForChildCommand(uint64_t handle)
+{
+  HANDLE process = (HANDLE)handle;
+
+  WaitForSingleObject(process, INFINITE);
+
+  DWORD exitCode = ~0U;
+  GetExitCodeProcess(process, &exitCode);
+
+  CloseHandle(process);
+
+  return (int)exitCode;
+}
+
 void DisplayRendererPreview(IReplayController *renderer, TextureDisplay &displayCfg, uint32_t width,
                             uint32_t height)
 {
@@ -285,6 +285,8 @@ public class ReplayRenderer
 
         [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
         private static extern void ReplayRenderer_FileChanged(IntPtr real);
+        [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
+        private static extern bool ReplayRenderer_HasFileChanged(IntPtr real);
 
         [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
         private static extern bool ReplayRenderer_HasCallstacks(IntPtr real);
@@ -404,6 +406,9 @@ public ReplayOutput CreateOutput(IntPtr WindowHandle, OutputType type)
         public void FileChanged()
         { ReplayRenderer_FileChanged(m_Real); }
 
+        public bool HasFileChanged()
+        { return ReplayRenderer_HasFileChanged(m_Real); }
+
         public bool HasCallstacks()
         { return ReplayRenderer_HasCallstacks(m_Real); }
 